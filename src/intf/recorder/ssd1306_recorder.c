@@ -0,0 +1,186 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_recorder.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/ssd1306_intf_wrapper.h"
+#include "lcd/lcd_common.h"
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_PLATFORM_RECORDER_AVAILABLE)
+
+#include <stdio.h>
+#include <string.h>
+
+#define RECORDER_SEND_BUFFER_SIZE  256
+
+static FILE *s_file = NULL;
+static ssd1306_intf_wrapper_t s_wrapper;
+static uint32_t s_lastTime;
+static uint32_t s_sendTime;
+static uint16_t s_sendLen;
+static uint8_t s_sendBuffer[RECORDER_SEND_BUFFER_SIZE];
+
+static void recorder_writeVarint(uint32_t value)
+{
+    uint8_t buf[5];
+    uint8_t len = 0;
+    while ( value >= 0x80 )
+    {
+        buf[len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buf[len++] = value;
+    fwrite(buf, len, 1, s_file);
+}
+
+static void recorder_writeRecord(uint8_t type, uint32_t ts)
+{
+    fputc(type, s_file);
+    recorder_writeVarint(ts - s_lastTime);
+    s_lastTime = ts;
+}
+
+static void recorder_flushSend(void)
+{
+    if ( s_sendLen )
+    {
+        recorder_writeRecord(SSD1306_TRACE_SEND, s_sendTime);
+        recorder_writeVarint(s_sendLen);
+        fwrite(s_sendBuffer, s_sendLen, 1, s_file);
+        s_sendLen = 0;
+    }
+}
+
+static void recorder_event(uint8_t type)
+{
+    recorder_flushSend();
+    recorder_writeRecord(type, micros());
+}
+
+static void recorder_start(void)
+{
+    recorder_event(SSD1306_TRACE_START);
+    s_wrapper.orig.start();
+}
+
+static void recorder_stop(void)
+{
+    s_wrapper.orig.stop();
+    recorder_event(SSD1306_TRACE_STOP);
+}
+
+static void recorder_send(uint8_t data)
+{
+    if ( s_sendLen == RECORDER_SEND_BUFFER_SIZE )
+    {
+        recorder_flushSend();
+    }
+    if ( !s_sendLen )
+    {
+        s_sendTime = micros();
+    }
+    s_sendBuffer[s_sendLen++] = data;
+    s_wrapper.orig.send(data);
+}
+
+static void recorder_sendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    recorder_event(SSD1306_TRACE_BUFFER);
+    recorder_writeVarint(size);
+    fwrite(buffer, size, 1, s_file);
+    s_wrapper.orig.send_buffer(buffer, size);
+}
+
+static void recorder_close(void)
+{
+    ssd1306_recorderStop();
+    if ( ssd1306_intf.close )
+    {
+        ssd1306_intf.close();
+    }
+}
+
+int ssd1306_recorderStart(const char *filename)
+{
+    uint8_t header[8] = { 'S', 'S', 'D', 'T', SSD1306_TRACE_VERSION, 0, 0, 0 };
+    if ( s_file && ssd1306_recorderStop() < 0 )
+    {
+        return -1;
+    }
+    s_file = fopen(filename, "wb");
+    if ( !s_file )
+    {
+        return -1;
+    }
+    if ( ssd1306_intf.spi )
+    {
+        header[5] |= SSD1306_TRACE_FLAG_SPI;
+    }
+    fwrite(header, sizeof(header), 1, s_file);
+    s_lastTime = micros();
+    s_sendLen = 0;
+    s_wrapper.intf.start = recorder_start;
+    s_wrapper.intf.stop = recorder_stop;
+    s_wrapper.intf.send = recorder_send;
+    s_wrapper.intf.send_buffer = recorder_sendBuffer;
+    s_wrapper.intf.close = recorder_close;
+    ssd1306_intfWrap(&s_wrapper);
+    return 0;
+}
+
+void ssd1306_recorderFrame(void)
+{
+    if ( s_file )
+    {
+        recorder_event(SSD1306_TRACE_FRAME);
+    }
+}
+
+void ssd1306_recorderDataMode(uint8_t mode)
+{
+    if ( s_file )
+    {
+        recorder_event(SSD1306_TRACE_DC);
+        fputc(mode ? 1 : 0, s_file);
+    }
+}
+
+int ssd1306_recorderStop(void)
+{
+    if ( !s_file )
+    {
+        return 0;
+    }
+    if ( ssd1306_intfUnwrap(&s_wrapper) < 0 )
+    {
+        return -1;
+    }
+    recorder_flushSend();
+    fclose(s_file);
+    s_file = NULL;
+    return 0;
+}
+
+#endif
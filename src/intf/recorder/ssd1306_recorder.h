@@ -0,0 +1,115 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_recorder.h interface traffic recorder
+ */
+
+#ifndef _SSD1306_RECORDER_H_
+#define _SSD1306_RECORDER_H_
+
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ * @{
+ *
+ * Trace file starts with 8-byte header: "SSDT" signature, format version,
+ * flags (SSD1306_TRACE_FLAG_SPI) and 2 reserved bytes. The header is followed
+ * by records. Each record starts with record type byte and time in microseconds,
+ * passed since previous record, encoded as variable length integer (7 bits per
+ * byte, least significant group first, bit 7 set if more bytes follow).
+ * SSD1306_TRACE_DC record has 1 byte payload with D/C line state.
+ * SSD1306_TRACE_SEND and SSD1306_TRACE_BUFFER records have variable length
+ * integer byte count followed by the bytes. SSD1306_TRACE_SEND record joins
+ * consecutive ssd1306_intf.send() calls, SSD1306_TRACE_BUFFER record keeps
+ * single ssd1306_intf.send_buffer() call.
+ */
+
+/** Trace file signature */
+#define SSD1306_TRACE_SIGNATURE   "SSDT"
+/** Trace file format version */
+#define SSD1306_TRACE_VERSION     1
+/** Trace header flag: trace is recorded on spi interface */
+#define SSD1306_TRACE_FLAG_SPI    0x01
+
+/** Trace record types */
+enum
+{
+    SSD1306_TRACE_START  = 0x01, ///< ssd1306_intf.start() call
+    SSD1306_TRACE_STOP   = 0x02, ///< ssd1306_intf.stop() call
+    SSD1306_TRACE_DC     = 0x03, ///< D/C line change via ssd1306_spiDataMode()
+    SSD1306_TRACE_SEND   = 0x04, ///< consecutive ssd1306_intf.send() calls
+    SSD1306_TRACE_BUFFER = 0x05, ///< ssd1306_intf.send_buffer() call
+    SSD1306_TRACE_FRAME  = 0x06, ///< frame marker, see ssd1306_recorderFrame()
+};
+
+#if defined(CONFIG_PLATFORM_RECORDER_AVAILABLE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Starts recording of all traffic, sent via ssd1306_intf, to the trace file.
+ * The recorder wraps interface, initialized at the moment of the call,
+ * so call this function after interface initialization. If display is already
+ * initialized, the recorder also redirects display pixel functions, bound
+ * directly to interface functions.
+ *
+ * @param filename path to trace file to create
+ * @return 0 on success, -1 if file cannot be created
+ */
+int ssd1306_recorderStart(const char *filename);
+
+/**
+ * Puts frame marker to the trace. Replay tool uses markers to split
+ * the trace to frames. If there are no markers, frames are separated by idle time.
+ */
+void ssd1306_recorderFrame(void);
+
+/**
+ * Records D/C line change. The function is called by ssd1306_spiDataMode().
+ * @param mode 0 for command mode, 1 for data mode
+ */
+void ssd1306_recorderDataMode(uint8_t mode);
+
+/**
+ * Stops recording, restores original interface functions and closes trace file.
+ * If another interface wrapper (for example, ssd1306_traceStart()) was started after
+ * the recorder, it must be stopped first.
+ * @return 0 on success, -1 if recorder is not the last started interface wrapper
+ */
+int ssd1306_recorderStop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _SSD1306_RECORDER_H_ */
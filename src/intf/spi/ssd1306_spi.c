@@ -28,11 +28,14 @@
 #include "ssd1306_spi_usi.h"
 #include "intf/ssd1306_interface.h"
 #include "lcd/lcd_common.h"
+#include "intf/recorder/ssd1306_recorder.h"
 #include "ssd1306_hal/io.h"
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 int8_t s_ssd1306_cs = 4;
 int8_t s_ssd1306_dc = 5;
 uint32_t s_ssd1306_spi_clock = 8000000;
+#endif
 
 void ssd1306_spiInit(int8_t cesPin, int8_t dcPin)
 {
@@ -53,4 +56,7 @@ void ssd1306_spiDataMode(uint8_t mode)
     {
         digitalWrite(s_ssd1306_dc, mode ? HIGH : LOW);
     }
+#if defined(CONFIG_PLATFORM_RECORDER_AVAILABLE)
+    ssd1306_recorderDataMode(mode);
+#endif
 }
@@ -35,6 +35,7 @@
 extern "C" {
 #endif
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 /**
  * @ingroup LCD_HW_INTERFACE_API
  *
@@ -54,6 +55,7 @@ extern int8_t s_ssd1306_dc;
  * maximum SPI clock, supported by OLED display
  */
 extern uint32_t s_ssd1306_spi_clock;
+#endif
 
 /**
  * @ingroup LCD_HW_INTERFACE_API
@@ -81,5 +83,7 @@ void         ssd1306_spiDataMode(uint8_t mode);
 }
 #endif
 
+#include "ssd1306_context.h"
+
 // ----------------------------------------------------------------------------
 #endif // _SSD1306_SPI_H_
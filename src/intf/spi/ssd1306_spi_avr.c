@@ -51,7 +51,7 @@
 #define SPI_CLOCK_MASK   0x03
 #define SPI_2XCLOCK_MASK 0x01
 
-extern uint32_t s_ssd1306_spi_clock;
+#include "intf/spi/ssd1306_spi.h"
 
 static void ssd1306_spiConfigure_avr()
 {
@@ -26,12 +26,14 @@
 #include "spi/ssd1306_spi.h"
 #include <stddef.h>
 
-static void ssd1306_send_buffer_generic(const uint8_t* buffer, uint16_t size);
+void ssd1306_send_buffer_generic(const uint8_t* buffer, uint16_t size);
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 ssd1306_interface_t ssd1306_intf =
 {
     .send_buffer = ssd1306_send_buffer_generic
 };
+#endif
 
 void ssd1306_commandStart(void)
 {
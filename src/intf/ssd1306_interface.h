@@ -88,10 +88,12 @@ typedef struct
     void (*close)(void);
 } ssd1306_interface_t;
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 /**
  * Holds pointers to functions of currently initialized interface.
  */
 extern ssd1306_interface_t ssd1306_intf;
+#endif
 
 /**
  * Deprecated
@@ -148,5 +150,7 @@ void ssd1306_dataStart(void);
 }
 #endif
 
+#include "ssd1306_context.h"
+
 // ----------------------------------------------------------------------------
 #endif // _SSD1306_INTERFACE_H_
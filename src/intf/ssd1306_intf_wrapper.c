@@ -0,0 +1,78 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_intf_wrapper.h"
+
+void ssd1306_intfWrap(ssd1306_intf_wrapper_t *wrapper)
+{
+    wrapper->orig = ssd1306_intf;
+    wrapper->lcd = ssd1306_lcd;
+    ssd1306_intf.start = wrapper->intf.start;
+    ssd1306_intf.stop = wrapper->intf.stop;
+    ssd1306_intf.send = wrapper->intf.send;
+    ssd1306_intf.send_buffer = wrapper->intf.send_buffer;
+    ssd1306_intf.close = wrapper->intf.close;
+    /* Display drivers bind pixel functions directly to interface functions */
+    if ( ssd1306_lcd.send_pixels1 == wrapper->orig.send )
+    {
+        ssd1306_lcd.send_pixels1 = wrapper->intf.send;
+    }
+    if ( ssd1306_lcd.send_pixels8 == wrapper->orig.send )
+    {
+        ssd1306_lcd.send_pixels8 = wrapper->intf.send;
+    }
+    if ( ssd1306_lcd.send_pixels_buffer1 == wrapper->orig.send_buffer )
+    {
+        ssd1306_lcd.send_pixels_buffer1 = wrapper->intf.send_buffer;
+    }
+}
+
+int ssd1306_intfUnwrap(ssd1306_intf_wrapper_t *wrapper)
+{
+    /* Wrapper, installed later, forwards calls to this one, so it cannot be removed */
+    if ( ssd1306_intf.start != wrapper->intf.start || ssd1306_intf.stop != wrapper->intf.stop ||
+         ssd1306_intf.send != wrapper->intf.send || ssd1306_intf.send_buffer != wrapper->intf.send_buffer ||
+         ssd1306_intf.close != wrapper->intf.close )
+    {
+        return -1;
+    }
+    ssd1306_intf.start = wrapper->orig.start;
+    ssd1306_intf.stop = wrapper->orig.stop;
+    ssd1306_intf.send = wrapper->orig.send;
+    ssd1306_intf.send_buffer = wrapper->orig.send_buffer;
+    ssd1306_intf.close = wrapper->orig.close;
+    if ( ssd1306_lcd.send_pixels1 == wrapper->intf.send )
+    {
+        ssd1306_lcd.send_pixels1 = wrapper->lcd.send_pixels1;
+    }
+    if ( ssd1306_lcd.send_pixels8 == wrapper->intf.send )
+    {
+        ssd1306_lcd.send_pixels8 = wrapper->lcd.send_pixels8;
+    }
+    if ( ssd1306_lcd.send_pixels_buffer1 == wrapper->intf.send_buffer )
+    {
+        ssd1306_lcd.send_pixels_buffer1 = wrapper->lcd.send_pixels_buffer1;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_intf_wrapper.h interface wrapper, used by recorder and trace
+ */
+
+#ifndef _SSD1306_INTF_WRAPPER_H_
+#define _SSD1306_INTF_WRAPPER_H_
+
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ * @{
+ */
+
+/**
+ * Interface wrapper intercepts calls to ssd1306_intf functions, for example, to
+ * record or trace transactions. Wrapper functions must forward calls to orig.
+ */
+typedef struct
+{
+    ssd1306_interface_t intf;   ///< wrapper functions, installed to ssd1306_intf (spi field is not used)
+    ssd1306_interface_t orig;   ///< wrapped interface, valid while wrapper is installed
+    ssd1306_lcd_t       lcd;    ///< display functions at the moment of wrapping
+} ssd1306_intf_wrapper_t;
+
+/**
+ * Installs wrapper functions to ssd1306_intf. Display pixel functions, bound directly
+ * to interface functions by display driver, are redirected to wrapper functions too.
+ * @param wrapper wrapper with intf functions filled in
+ */
+void ssd1306_intfWrap(ssd1306_intf_wrapper_t *wrapper);
+
+/**
+ * Restores interface and display functions, replaced by ssd1306_intfWrap().
+ * Wrappers must be removed in reverse order: if another wrapper was installed
+ * over this one, nothing is changed.
+ * @param wrapper wrapper, installed by ssd1306_intfWrap()
+ * @return 0 on success, -1 if wrapper is not the last installed one
+ */
+int ssd1306_intfUnwrap(ssd1306_intf_wrapper_t *wrapper);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,8 +30,6 @@
 
 #if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(__AVR_ATmega328P__)
 
-extern uint16_t ssd1306_color;
-
 /* This buffer fits 96x40 pixels
    Each 8 pixels are packed to 3 bytes:
 
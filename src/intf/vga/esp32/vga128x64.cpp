@@ -34,7 +34,6 @@
 //#define VGA_CONTROLLER_DEBUG
 
 static uint8_t *__vga_buffer = nullptr;
-extern uint16_t ssd1306_color;
 
 // Set to ssd1306 compatible mode by default
 static uint8_t s_mode = 0x01;
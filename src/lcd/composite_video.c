@@ -39,10 +39,8 @@ static const uint8_t PROGMEM s_composite128x64_initData[] =
     VGA_DISPLAY_ON,
 };
 
-static uint8_t s_column = 0;
-static uint8_t s_page = 0;
-
-extern uint16_t ssd1306_color;
+static SSD1306_THREAD_LOCAL uint8_t s_column = 0;
+static SSD1306_THREAD_LOCAL uint8_t s_page = 0;
 
 static void vga_set_block1(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -130,6 +128,7 @@ void composite_video_128x64_mono_init(void)
     ssd1306_vgaInit();
     // init display
     ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.set_block = vga_set_block2;
@@ -30,7 +30,9 @@
 #define CMD_ARG 0xFF
 #define CMD_DELAY 0xFF
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 ssd1306_lcd_t ssd1306_lcd = { 0 };
+#endif
 
 void ssd1306_sendData(uint8_t data)
 {
@@ -82,6 +82,43 @@ typedef enum
     LCD_MODE_SSD1306_COMPAT = 1,
 } lcd_mode_t;
 
+/**
+ * Minimal number of pixels in rectangle, filled or cleared with display accelerator.
+ * Smaller rectangles (glyph backgrounds, etc.) are sent pixel by pixel, because
+ * waiting for accelerated operation to complete takes longer than pixels transfer.
+ */
+#ifndef SSD1306_ACCEL_MIN_PIXELS
+#define SSD1306_ACCEL_MIN_PIXELS  256
+#endif
+
+/**
+ * Hardware accelerated operations, provided by display controller.
+ * All coordinates are in pixels, right and bottom edges are included.
+ * Colors are always passed in RGB565 format.
+ */
+typedef struct
+{
+    /**
+     * Fills rectangle with specified color.
+     */
+    void (*fill_rect)(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, uint16_t color);
+
+    /**
+     * Copies rectangle content to new position with top-left corner at (x,y).
+     */
+    void (*copy_rect)(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, lcduint_t x, lcduint_t y);
+
+    /**
+     * Draws line with specified color.
+     */
+    void (*draw_line)(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, uint16_t color);
+
+    /**
+     * Clears rectangle (fills with black color).
+     */
+    void (*clear_rect)(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2);
+} ssd1306_lcd_accel_t;
+
 /**
  * Structure, describing display driver configuration
  */
@@ -162,12 +199,21 @@ typedef struct
      * @see lcd_mode_t
      */
     void (*set_mode)(lcd_mode_t mode);
+
+    /**
+     * Hardware accelerated operations for current display mode or NULL,
+     * if display controller doesn't support them. Direct draw functions
+     * use these operations instead of sending pixels, when available.
+     */
+    const ssd1306_lcd_accel_t *accel;
 } ssd1306_lcd_t;
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 /**
  * Structure containing callback to low level function for currently enabled display
  */
 extern ssd1306_lcd_t ssd1306_lcd;
+#endif
 
 /**
  * Current display height
@@ -328,8 +374,8 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
  *       arguments: start and end of region
  */
 #define SSD1306_COMPAT_SPI_BLOCK_8BIT_CMDS(column_cmd, row_cmd) \
-    static uint8_t __s_column; \
-    static uint8_t __s_page; \
+    static SSD1306_THREAD_LOCAL uint8_t __s_column; \
+    static SSD1306_THREAD_LOCAL uint8_t __s_page; \
     static void set_block_compat(lcduint_t x, lcduint_t y, lcduint_t w) \
     { \
         uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1); \
@@ -388,7 +434,6 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
  * when working in ssd1306 compatible mode.
  */
 #define SSD1306_COMPAT_SEND_PIXELS_RGB8_CMDS() \
-    extern uint16_t ssd1306_color; \
     static void send_pixels_compat(uint8_t data) \
     { \
         for (uint8_t i=8; i>0; i--) \
@@ -420,7 +465,6 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
  * when working in ssd1306 compatible mode.
  */
 #define SSD1306_COMPAT_SEND_PIXELS_RGB16_CMDS() \
-    extern uint16_t ssd1306_color; \
     static void send_pixels_compat16(uint8_t data) \
     { \
         for (uint8_t i=8; i>0; i--) \
@@ -456,4 +500,6 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
 }
 #endif
 
+#include "ssd1306_context.h"
+
 #endif /* _LCD_COMMON_H_ */
@@ -35,13 +35,17 @@
 #define CMD_ARG     0xFF
 #define CMD_DELAY   0xFF
 
-extern uint16_t ssd1306_color;
-extern uint32_t s_ssd1306_spi_clock;
-
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_rotation  (s_ssd1306_context->lcd_rotation)
+#define s_rgb_bit   (s_ssd1306_context->lcd_rgb_bit)
+#define s_offset_x  (s_ssd1306_context->lcd_offset_x)
+#define s_offset_y  (s_ssd1306_context->lcd_offset_y)
+#else
 static uint8_t s_rotation = 0x00;
 static uint8_t s_rgb_bit  = 0b00001000;
 static lcdint_t s_offset_x = 0;
 static lcdint_t s_offset_y = 0;
+#endif
 
 static const PROGMEM uint8_t s_oled128x128_initData[] =
 {
@@ -122,8 +126,8 @@ static const PROGMEM uint8_t s_oled128x160_initData[] =
     0x13, CMD_DELAY,   10, // NORON
 };
 
-static uint8_t s_column;
-static uint8_t s_page;
+static SSD1306_THREAD_LOCAL uint8_t s_column;
+static SSD1306_THREAD_LOCAL uint8_t s_page;
 
 static void il9163_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -253,6 +257,7 @@ static void il9163_sendPixel16(uint16_t color)
 void    il9163_128x128_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 128;
     ssd1306_lcd.width = 128;
     s_rgb_bit = 0b00001000; // set BGR mode mapping
@@ -406,6 +411,7 @@ static void    st7735_setMode(lcd_mode_t mode)
 void    st7735_128x160_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.height = 160;
     s_rgb_bit = 0b00000000; // set RGB mode mapping
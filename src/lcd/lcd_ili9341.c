@@ -34,12 +34,15 @@
 
 #define CMD_ARG     0xFF
 
-extern uint16_t ssd1306_color;
-extern uint32_t s_ssd1306_spi_clock;
-
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_rotation       (s_ssd1306_context->lcd_rotation)
+#define s_rgb_bit        (s_ssd1306_context->lcd_rgb_bit)
+#define s_rotate_output  (s_ssd1306_context->lcd_rotate_output)
+#else
 static uint8_t s_rotation = 0x00;
 static uint8_t s_rgb_bit  = 0b00001000;
 static uint8_t s_rotate_output = 0;
+#endif
 
 
 static const PROGMEM uint8_t s_oled240x320_initData[] =
@@ -73,8 +76,8 @@ static const PROGMEM uint8_t s_oled240x320_initData[] =
     0x29,                                 // display on
 };
 
-static lcduint_t s_column;
-static lcduint_t s_page;
+static SSD1306_THREAD_LOCAL lcduint_t s_column;
+static SSD1306_THREAD_LOCAL lcduint_t s_page;
 
 static void ili9341_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -196,6 +199,7 @@ static void ili9341_sendPixel16(uint16_t color)
 void    ili9341_240x320_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 240;
     ssd1306_lcd.height = (lcduint_t)320;
     s_rgb_bit = 0b00001000; // set BGR mode mapping
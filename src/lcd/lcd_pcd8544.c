@@ -47,9 +47,9 @@ static const uint8_t PROGMEM s_lcd84x48_initData[] =
     PCD8544_DISPLAYCONTROL | PCD8544_DISPLAYNORMAL
 };
 
-static uint8_t s_column;
-static uint8_t s_page;
-static uint8_t s_width;
+static SSD1306_THREAD_LOCAL uint8_t s_column;
+static SSD1306_THREAD_LOCAL uint8_t s_page;
+static SSD1306_THREAD_LOCAL uint8_t s_width;
 
 static void pcd8544_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -80,6 +80,7 @@ static void pcd8544_setMode(lcd_mode_t mode)
 void pcd8544_84x48_init()
 {
     ssd1306_lcd.type = LCD_TYPE_PCD8544;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 84;
     ssd1306_lcd.height = 48;
     ssd1306_intf.start();
@@ -0,0 +1,430 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "linux_fb.h"
+#include "lcd_common.h"
+#include "intf/ssd1306_interface.h"
+#include "ssd1306_transpose.h"
+#include "nano_gfx_types.h"
+
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <linux/fb.h>
+
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_fd            (s_ssd1306_context->fb.fd)
+#define s_map           (s_ssd1306_context->fb.map)
+#define s_mapSize       (s_ssd1306_context->fb.map_size)
+#define s_fb            (s_ssd1306_context->fb.fb)
+#define s_lineLength    (s_ssd1306_context->fb.line_length)
+#define s_bpp           (s_ssd1306_context->fb.bpp)
+#define s_x1            (s_ssd1306_context->fb.x1)
+#define s_x2            (s_ssd1306_context->fb.x2)
+#define s_column        (s_ssd1306_context->fb.column)
+#define s_row           (s_ssd1306_context->fb.row)
+#define s_byte          (s_ssd1306_context->fb.byte)
+#define s_hasByte       (s_ssd1306_context->fb.has_byte)
+#define s_redOffset     (s_ssd1306_context->fb.red_offset)
+#define s_greenOffset   (s_ssd1306_context->fb.green_offset)
+#define s_blueOffset    (s_ssd1306_context->fb.blue_offset)
+#else
+static int s_fd = -1;
+static uint8_t *s_map = NULL;
+static size_t s_mapSize;
+static uint8_t *s_fb = NULL;
+static uint32_t s_lineLength;
+static uint8_t s_bpp;
+static lcduint_t s_x1;
+static lcduint_t s_x2;
+static lcduint_t s_column;
+/* page in ssd1306 compatible mode, line in normal mode */
+static lcduint_t s_row;
+static uint8_t s_byte;
+static uint8_t s_hasByte;
+/* Positions of color components in 32-bit pixel, reported by the driver */
+static uint8_t s_redOffset = 16;
+static uint8_t s_greenOffset = 8;
+static uint8_t s_blueOffset = 0;
+#endif
+
+static inline uint32_t fb_rgb32(uint16_t color)
+{
+    uint32_t r = (color >> 11) & 0x1F;
+    uint32_t g = (color >> 5) & 0x3F;
+    uint32_t b = color & 0x1F;
+    return (((r << 3) | (r >> 2)) << s_redOffset) | (((g << 2) | (g >> 4)) << s_greenOffset) |
+           (((b << 3) | (b >> 2)) << s_blueOffset);
+}
+
+static inline void fb_put16(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    uint8_t *line = s_fb + y * s_lineLength;
+    switch (s_bpp)
+    {
+        case 1:
+            if ( color )
+                line[x >> 3] |= (1 << (x & 7));
+            else
+                line[x >> 3] &= ~(1 << (x & 7));
+            break;
+        case 8:
+            line[x] = RGB16_TO_RGB8(color);
+            break;
+        case 16:
+            ((uint16_t *)line)[x] = color;
+            break;
+        default:
+            ((uint32_t *)line)[x] = fb_rgb32(color);
+            break;
+    }
+}
+
+static inline void fb_put8(lcduint_t x, lcduint_t y, uint8_t color)
+{
+    if ( s_bpp == 8 )
+        s_fb[y * s_lineLength + x] = color;
+    else
+        fb_put16(x, y, RGB8_TO_RGB16(color));
+}
+
+static void fb_set_block(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    lcduint_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_x1 = x;
+    s_x2 = rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1);
+    s_column = x;
+    s_row = y;
+    s_hasByte = 0;
+}
+
+/* In ssd1306 compatible mode the cursor moves to the next page either on next_page() *
+ * call or, like in horizontal addressing mode of ssd1306, when pixels are sent beyond *
+ * the right edge of the block. Wrap is done before the write, so both ways can be mixed */
+static void fb_next_page_compat(void)
+{
+    s_column = s_x1;
+    s_row++;
+}
+
+static void fb_next_page_native(void)
+{
+}
+
+static inline void fb_wrap(void)
+{
+    if ( s_column > s_x2 )
+    {
+        s_column = s_x1;
+        s_row++;
+    }
+}
+
+static void fb_send_pixels1(uint8_t data)
+{
+    fb_wrap();
+    lcduint_t x = s_column++;
+    lcduint_t y = s_row << 3;
+    if ( x >= ssd1306_lcd.width )
+    {
+        return;
+    }
+    uint16_t color = s_bpp == 1 ? 1 : (s_bpp == 8 ? RGB8_TO_RGB16(ssd1306_color) : ssd1306_color);
+    for (uint8_t i = 8; i > 0 && y < ssd1306_lcd.height; i--, y++)
+    {
+        fb_put16(x, y, (data & 0x01) ? color : 0);
+        data >>= 1;
+    }
+}
+
+static void fb_send_pixels_buffer1(const uint8_t *buffer, uint16_t len)
+{
+    while (len)
+    {
+        fb_wrap();
+        /* 8 aligned columns of monochrome framebuffer are transposed as single block */
+        if ( s_bpp == 1 && len >= 8 && !(s_column & 7) && s_column + 7 <= s_x2 &&
+             ((s_row << 3) + 7) < ssd1306_lcd.height )
+        {
+            uint8_t block[8];
+            uint8_t *dst = s_fb + (s_row << 3) * s_lineLength + (s_column >> 3);
+            memcpy(block, buffer, 8);
+            ssd1306_transpose8x8(block);
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                *dst = block[i];
+                dst += s_lineLength;
+            }
+            s_column += 8;
+            buffer += 8;
+            len -= 8;
+            continue;
+        }
+        fb_send_pixels1(*buffer);
+        buffer++;
+        len--;
+    }
+}
+
+static void fb_send_pixels8(uint8_t data)
+{
+    fb_wrap();
+    lcduint_t x = s_column++;
+    if ( x < ssd1306_lcd.width && s_row < ssd1306_lcd.height )
+    {
+        fb_put8(x, s_row, data);
+    }
+}
+
+static void fb_send_pixels16(uint16_t data)
+{
+    fb_wrap();
+    lcduint_t x = s_column++;
+    if ( x < ssd1306_lcd.width && s_row < ssd1306_lcd.height )
+    {
+        fb_put16(x, s_row, data);
+    }
+}
+
+static void fb_set_mode(lcd_mode_t mode)
+{
+    if (mode == LCD_MODE_NORMAL)
+    {
+        ssd1306_lcd.next_page = fb_next_page_native;
+    }
+    else if (mode == LCD_MODE_SSD1306_COMPAT)
+    {
+        ssd1306_lcd.next_page = fb_next_page_compat;
+    }
+}
+
+static void fb_start(void)
+{
+}
+
+static void fb_stop(void)
+{
+    s_hasByte = 0;
+}
+
+/* Interface receives RGB 5-6-5 pixels, most significant byte first, *
+ * as 16-bit color displays expect them.                              */
+static void fb_send(uint8_t data)
+{
+    if ( !s_hasByte )
+    {
+        s_byte = data;
+        s_hasByte = 1;
+        return;
+    }
+    s_hasByte = 0;
+    fb_send_pixels16( (s_byte << 8) | data );
+}
+
+static void fb_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    if ( s_hasByte && size )
+    {
+        fb_send(*buffer);
+        buffer++;
+        size--;
+    }
+    while ( size >= 2 )
+    {
+        fb_wrap();
+        lcduint_t count = s_x2 - s_column + 1;
+        if ( count > (size >> 1) )
+        {
+            count = size >> 1;
+        }
+        if ( s_bpp == 16 && s_column <= s_x2 && s_row < ssd1306_lcd.height )
+        {
+            /* Rows of 16-bit canvas are copied to the mapped memory as is, only byte order changes */
+            uint16_t *dst = (uint16_t *)(s_fb + s_row * s_lineLength) + s_column;
+            for (lcduint_t i = 0; i < count; i++)
+            {
+                dst[i] = (buffer[0] << 8) | buffer[1];
+                buffer += 2;
+            }
+            s_column += count;
+            size -= count << 1;
+            continue;
+        }
+        fb_send_pixels16( (buffer[0] << 8) | buffer[1] );
+        buffer += 2;
+        size -= 2;
+    }
+    if ( size )
+    {
+        fb_send(*buffer);
+    }
+}
+
+/* 16-bit pixels are written as RGB 5-6-5, 32-bit pixels need 8-bit components at any byte */
+static int fb_check_layout(const struct fb_var_screeninfo *var)
+{
+    if ( var->bits_per_pixel == 16 )
+    {
+        return var->red.offset == 11 && var->red.length == 5 &&
+               var->green.offset == 5 && var->green.length == 6 &&
+               var->blue.offset == 0 && var->blue.length == 5;
+    }
+    if ( var->bits_per_pixel == 32 )
+    {
+        return var->red.length == 8 && !(var->red.offset & 7) && var->red.offset <= 24 &&
+               var->green.length == 8 && !(var->green.offset & 7) && var->green.offset <= 24 &&
+               var->blue.length == 8 && !(var->blue.offset & 7) && var->blue.offset <= 24;
+    }
+    /* 1 bpp and 8 bpp (RGB 3-3-2) are written as is, pixels must start at byte boundary */
+    return var->bits_per_pixel != 1 || !(var->xoffset & 7);
+}
+
+int linux_fb_init(const char *device, lcduint_t width, lcduint_t height, uint8_t bpp)
+{
+    struct fb_var_screeninfo var;
+    struct fb_fix_screeninfo fix;
+    struct stat st;
+    size_t offset = 0;
+
+    linux_fb_close();
+    s_fd = open(device, O_RDWR);
+    if ( s_fd < 0 && errno == ENOENT && width && height )
+    {
+        /* Only regular file with explicit size can be created */
+        s_fd = open(device, O_RDWR | O_CREAT, 0644);
+    }
+    if ( s_fd < 0 )
+    {
+        fprintf(stderr, "Failed to open framebuffer %s\n", device);
+        return -1;
+    }
+    if ( ioctl(s_fd, FBIOGET_VSCREENINFO, &var) == 0 &&
+         ioctl(s_fd, FBIOGET_FSCREENINFO, &fix) == 0 )
+    {
+        if ( !fb_check_layout(&var) )
+        {
+            fprintf(stderr, "Unsupported framebuffer %s: pixel layout\n", device);
+            linux_fb_close();
+            return -1;
+        }
+        bpp = var.bits_per_pixel;
+        width = (width && width < var.xres) ? width : var.xres;
+        height = (height && height < var.yres) ? height : var.yres;
+        s_lineLength = fix.line_length;
+        s_mapSize = fix.smem_len;
+        offset = var.yoffset * s_lineLength + ((size_t)var.xoffset * bpp >> 3);
+        s_redOffset = var.red.offset;
+        s_greenOffset = var.green.offset;
+        s_blueOffset = var.blue.offset;
+    }
+    else if ( fstat(s_fd, &st) == 0 && S_ISREG(st.st_mode) && width && height )
+    {
+        s_redOffset = 16;
+        s_greenOffset = 8;
+        s_blueOffset = 0;
+        s_lineLength = ((uint32_t)width * bpp + 7) >> 3;
+        s_mapSize = (size_t)s_lineLength * height;
+        if ( (size_t)st.st_size < s_mapSize && ftruncate(s_fd, s_mapSize) < 0 )
+        {
+            s_mapSize = 0;
+        }
+    }
+    else
+    {
+        s_mapSize = 0;
+    }
+    if ( !s_mapSize || (bpp != 1 && bpp != 8 && bpp != 16 && bpp != 32) ||
+         offset + (size_t)s_lineLength * height > s_mapSize )
+    {
+        fprintf(stderr, "Unsupported framebuffer %s: %d bpp\n", device, bpp);
+        linux_fb_close();
+        return -1;
+    }
+    s_map = mmap(NULL, s_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, s_fd, 0);
+    if ( s_map == MAP_FAILED )
+    {
+        fprintf(stderr, "Failed to map framebuffer %s\n", device);
+        s_map = NULL;
+        linux_fb_close();
+        return -1;
+    }
+    s_fb = s_map + offset;
+    s_bpp = bpp;
+
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = fb_start;
+    ssd1306_intf.stop = fb_stop;
+    ssd1306_intf.send = fb_send;
+    ssd1306_intf.send_buffer = fb_send_buffer;
+    ssd1306_intf.close = linux_fb_close;
+    ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcd.width = width;
+    ssd1306_lcd.height = height;
+    ssd1306_lcd.set_block = fb_set_block;
+    ssd1306_lcd.next_page = bpp == 1 ? fb_next_page_compat : fb_next_page_native;
+    ssd1306_lcd.send_pixels1 = fb_send_pixels1;
+    ssd1306_lcd.send_pixels_buffer1 = fb_send_pixels_buffer1;
+    ssd1306_lcd.send_pixels8 = fb_send_pixels8;
+    ssd1306_lcd.send_pixels16 = fb_send_pixels16;
+    ssd1306_lcd.set_mode = fb_set_mode;
+    ssd1306_lcd.accel = NULL;
+    fb_set_block(0, 0, 0);
+    return 0;
+}
+
+void linux_fb_close(void)
+{
+    if ( s_map )
+    {
+        munmap(s_map, s_mapSize);
+        s_map = NULL;
+        s_fb = NULL;
+    }
+    if ( s_fd >= 0 )
+    {
+        close(s_fd);
+        s_fd = -1;
+    }
+}
+
+uint8_t *linux_fb_getBuffer(void)
+{
+    return s_fb;
+}
+
+uint32_t linux_fb_getLineLength(void)
+{
+    return s_lineLength;
+}
+
+uint8_t linux_fb_getBpp(void)
+{
+    return s_bpp;
+}
+
+#endif
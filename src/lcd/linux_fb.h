@@ -0,0 +1,118 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file linux_fb.h Linux framebuffer display driver
+ */
+
+#ifndef _SSD1306_LINUX_FB_H_
+#define _SSD1306_LINUX_FB_H_
+
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LINUX_FB_API Linux framebuffer: output to mapped video memory
+ * @{
+ *
+ * @brief Outputs library drawing directly to memory mapped framebuffer device or file
+ *
+ * @details Linux framebuffer driver maps /dev/fbN device (for example, exposed by fbtft or
+ *          ssd1307fb kernel drivers) or any regular file to memory, and writes pixels, sent
+ *          by library functions, directly to the mapped memory. No communication interface
+ *          is needed: ssd1306_intf is replaced with functions, writing to the framebuffer.
+ *          The following framebuffer formats are supported:
+ *          - 1 bpp: monochrome, 8 horizontal pixels per byte, least significant bit is the
+ *            left pixel (ssd1307fb layout)
+ *          - 8 bpp: RGB 3-3-2, the same as library 8-bit color format
+ *          - 16 bpp: RGB 5-6-5 in host byte order
+ *          - 32 bpp: XRGB 8-8-8-8 in host byte order
+ *
+ *          The driver accepts monochrome, 8-bit and 16-bit library functions for any of
+ *          the formats and converts pixels on the fly. If formats match (NanoCanvas16::blt()
+ *          to 16 bpp framebuffer, NanoCanvas8::blt() to 8 bpp framebuffer), canvas rows
+ *          are copied to the mapped memory without conversion. Monochrome page-mode data is
+ *          written to 1 bpp framebuffer with 8x8 bit transpose (see ssd1306_transpose8x8()).
+ *          Library color for monochrome data (ssd1306_setColor()) is RGB 3-3-2 for 8 bpp
+ *          framebuffer and RGB 5-6-5 for 16 bpp and 32 bpp framebuffers.
+ */
+
+/**
+ * @brief Inits display, writing to Linux framebuffer device or regular file.
+ *
+ * Maps framebuffer device or file to memory and inits ssd1306_lcd and ssd1306_intf
+ * to write to mapped memory. If device is framebuffer device, its resolution, line length
+ * and color depth are read from the driver, width and height parameters can limit
+ * used area, and bpp parameter is ignored. Framebuffer pixel layout must be RGB 5-6-5
+ * for 16 bpp and have 8-bit byte aligned components for 32 bpp (XRGB, XBGR, RGBX, etc.),
+ * other layouts are rejected. Visible area offsets (xoffset, yoffset) are taken into account.
+ * For regular file width, height and bpp are mandatory: the file is created only if it
+ * doesn't exist and both width and height are specified, and it is resized to hold whole
+ * image, lines are packed without padding, 32-bit pixels are XRGB 8-8-8-8.
+ *
+ * @param device path to framebuffer device or file, for example, /dev/fb1
+ * @param width width of display in pixels, 0 to use framebuffer resolution
+ * @param height height of display in pixels, 0 to use framebuffer resolution
+ * @param bpp bits per pixel for regular file: 1, 8, 16 or 32
+ * @return 0 on success, -1 if device doesn't exist, cannot be mapped or format is not supported
+ *
+ * @see linux_fb_close()
+ */
+int linux_fb_init(const char *device, lcduint_t width, lcduint_t height, uint8_t bpp);
+
+/**
+ * Unmaps framebuffer and closes device. The function is also called by ssd1306_intf.close().
+ */
+void linux_fb_close(void);
+
+/**
+ * Returns pointer to mapped framebuffer memory (pixel 0,0) or NULL if framebuffer is not mapped.
+ */
+uint8_t *linux_fb_getBuffer(void);
+
+/**
+ * Returns length of single framebuffer line in bytes.
+ */
+uint32_t linux_fb_getLineLength(void);
+
+/**
+ * Returns number of bits per pixel of mapped framebuffer.
+ */
+uint8_t linux_fb_getBpp(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
@@ -57,8 +57,8 @@ static const uint8_t PROGMEM s_oled128x64_initData[] =
     SSD1306_DISPLAYON
 };
 
-static uint8_t s_column;
-static uint8_t s_page;
+static SSD1306_THREAD_LOCAL uint8_t s_column;
+static SSD1306_THREAD_LOCAL uint8_t s_page;
 
 static void sh1106_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -97,6 +97,7 @@ static void sh1106_setMode(lcd_mode_t mode)
 void    sh1106_128x64_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SH1106;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = sh1106_setBlock;
@@ -33,7 +33,11 @@
 #include "sdl_core.h"
 #endif
 
-uint8_t s_ssd1306_startLine = 0;
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_ssd1306_startLine  (s_ssd1306_context->lcd_start_line)
+#else
+static uint8_t s_ssd1306_startLine = 0;
+#endif
 
 static const uint8_t PROGMEM s_oled128x64_initData[] =
 {
@@ -179,6 +183,7 @@ void    ssd1306_init()
 void    ssd1306_128x64_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1306_setBlock;
@@ -225,6 +230,7 @@ void   ssd1306_128x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 void    ssd1306_128x32_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 32;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1306_setBlock;
@@ -31,8 +31,6 @@
 #include "sdl_core.h"
 #endif
 
-extern uint16_t ssd1306_color;
-
 static const PROGMEM uint8_t s_oled_128x64_initData[] =
 {
 #ifdef SDL_EMULATION
@@ -60,12 +58,12 @@ static const PROGMEM uint8_t s_oled_128x64_initData[] =
 
 //////////////////////// SSD1306 COMPATIBLE MODE ///////////////////////////////
 
-static uint8_t __s_column;
-static uint8_t __s_w;
-static uint8_t __s_w2;
-static uint8_t __s_page;
-static uint8_t __s_leftPixel;
-static uint8_t __s_pos;
+static SSD1306_THREAD_LOCAL uint8_t __s_column;
+static SSD1306_THREAD_LOCAL uint8_t __s_w;
+static SSD1306_THREAD_LOCAL uint8_t __s_w2;
+static SSD1306_THREAD_LOCAL uint8_t __s_page;
+static SSD1306_THREAD_LOCAL uint8_t __s_leftPixel;
+static SSD1306_THREAD_LOCAL uint8_t __s_pos;
 
 static void set_block_compat(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -154,6 +152,7 @@ void    ssd1325_setMode(lcd_mode_t mode)
 void    ssd1325_128x64_init()
 {
     ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 128;  // specify width
     ssd1306_lcd.height = 64; // specify height
     // Set functions for compatible mode
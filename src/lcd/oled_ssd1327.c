@@ -31,8 +31,6 @@
 #include "sdl_core.h"
 #endif
 
-extern uint16_t ssd1306_color;
-
 static const PROGMEM uint8_t s_oled_128x128_initData[] =
 {
 #ifdef SDL_EMULATION
@@ -63,12 +61,12 @@ static const PROGMEM uint8_t s_oled_128x128_initData[] =
 
 //////////////////////// SSD1306 COMPATIBLE MODE ///////////////////////////////
 
-static uint8_t __s_column;
-static uint8_t __s_w;
-static uint8_t __s_w2;
-static uint8_t __s_page;
-static uint8_t __s_leftPixel;
-static uint8_t __s_pos;
+static SSD1306_THREAD_LOCAL uint8_t __s_column;
+static SSD1306_THREAD_LOCAL uint8_t __s_w;
+static SSD1306_THREAD_LOCAL uint8_t __s_w2;
+static SSD1306_THREAD_LOCAL uint8_t __s_page;
+static SSD1306_THREAD_LOCAL uint8_t __s_leftPixel;
+static SSD1306_THREAD_LOCAL uint8_t __s_pos;
 
 static void set_block_compat(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -166,6 +164,7 @@ static void    ssd1327_setMode(lcd_mode_t mode)
 void    ssd1327_128x128_init()
 {
     ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 128;  // specify width
     ssd1306_lcd.height = 128; // specify height
     // Set functions for compatible mode
@@ -33,8 +33,6 @@
 #endif
 #include "nano_gfx_types.h"
 
-extern uint16_t ssd1306_color;
-
 static const PROGMEM uint8_t s_oled96x64_initData[] =
 {
 #ifdef SDL_EMULATION
@@ -89,7 +87,11 @@ static const PROGMEM uint8_t s_oled96x64_initData16[] =
     SSD1331_DISPLAYON,
 };
 
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_rotation  (s_ssd1306_context->lcd_rotation)
+#else
 static uint8_t s_rotation = 0x04;
+#endif
 
 //////////////////////// SSD1306 COMPATIBLE MODE ///////////////////////////////
 
@@ -107,6 +109,81 @@ CONTROLLER_NATIVE_SPI_BLOCK_8BIT_CMDS(
      (s_rotation & 1) ? SSD1331_ROWADDR: SSD1331_COLUMNADDR,
      (s_rotation & 1) ? SSD1331_COLUMNADDR: SSD1331_ROWADDR );
 
+//////////////////////// SSD1331 GRAPHIC ACCELERATION ////////////////////////
+
+/* Controller doesn't report, when accelerated operation is complete. *
+ * Wait time is estimated from number of pixels, being processed.    */
+static void ssd1331_accelWait(uint16_t pixels)
+{
+    delayMicroseconds( (pixels >> 1) + 20 );
+}
+
+/* Colors are sent to accelerator as 6-bit C, B, A components */
+static void ssd1331_sendAccelColor(uint16_t color)
+{
+    ssd1306_intf.send( (color & 0x1F) << 1 );
+    ssd1306_intf.send( (color >> 5) & 0x3F );
+    ssd1306_intf.send( (color >> 10) & 0x3E );
+}
+
+static void ssd1331_accelFillRect(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, uint16_t color)
+{
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(SSD1331_FILL);
+    ssd1306_intf.send(0x01);
+    ssd1306_intf.send(SSD1331_DRAWRECT);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(y2);
+    ssd1331_sendAccelColor(color); // outline
+    ssd1331_sendAccelColor(color); // fill
+    ssd1306_intf.stop();
+    ssd1331_accelWait( (x2 - x1 + 1) * (y2 - y1 + 1) );
+}
+
+static void ssd1331_accelCopyRect(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, lcduint_t x, lcduint_t y)
+{
+    ssd1331_copyBlock(x1, y1, x2, y2, x, y);
+    ssd1331_accelWait( (x2 - x1 + 1) * (y2 - y1 + 1) );
+}
+
+static void ssd1331_accelDrawLine(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2, uint16_t color)
+{
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(SSD1331_DRAWLINE);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(y2);
+    ssd1331_sendAccelColor(color);
+    ssd1306_intf.stop();
+    ssd1331_accelWait( (x2 > x1 ? x2 - x1 : x1 - x2) + (y2 > y1 ? y2 - y1 : y1 - y2) );
+}
+
+static void ssd1331_accelClearRect(lcduint_t x1, lcduint_t y1, lcduint_t x2, lcduint_t y2)
+{
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(SSD1331_CLEAR);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(y2);
+    ssd1306_intf.stop();
+    ssd1331_accelWait( (x2 - x1 + 1) * (y2 - y1 + 1) );
+}
+
+static const ssd1306_lcd_accel_t s_ssd1331_accel =
+{
+    .fill_rect = ssd1331_accelFillRect,
+    .copy_rect = ssd1331_accelCopyRect,
+    .draw_line = ssd1331_accelDrawLine,
+    .clear_rect = ssd1331_accelClearRect,
+};
+
 //////////////////////////// GENERIC FUNCTIONS ////////////////////////////
 
 void    ssd1331_setMode(lcd_mode_t mode)
@@ -174,6 +251,9 @@ void ssd1331_setRotation(uint8_t rotation)
     }
     ssd1306_intf.send( ram_mode );
     ssd1306_intf.stop();
+    /* Accelerator works with RAM coordinates, which match screen *
+     * coordinates only in normal mode without rotation.          */
+    ssd1306_lcd.accel = (s_rotation == 0) ? &s_ssd1331_accel : NULL;
 }
 
 // 16-bit color in 8-bit display mode
@@ -201,6 +281,7 @@ static void    ssd1331_sendPixel16(uint16_t color)
 void    ssd1331_96x64_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 96;
     ssd1306_lcd.set_block = set_block_compat;
@@ -211,6 +292,7 @@ void    ssd1331_96x64_init()
     ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
     ssd1306_lcd.send_pixels16 = ssd1331_sendPixel16_8;
     ssd1306_lcd.set_mode = ssd1331_setMode;
+    s_rotation = 0x04; // init sequence selects ssd1306 compatible mode without rotation
     for( uint8_t i=0; i<sizeof(s_oled96x64_initData); i++)
     {
         ssd1306_sendCommand(pgm_read_byte(&s_oled96x64_initData[i]));
@@ -220,6 +302,7 @@ void    ssd1331_96x64_init()
 void    ssd1331_96x64_init16()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 96;
     ssd1306_lcd.set_block = set_block_compat;
@@ -230,6 +313,7 @@ void    ssd1331_96x64_init16()
     ssd1306_lcd.send_pixels8 = ssd1331_sendPixel8_16;
     ssd1306_lcd.send_pixels16 = ssd1331_sendPixel16;
     ssd1306_lcd.set_mode = ssd1331_setMode;
+    s_rotation = 0x04; // init sequence selects ssd1306 compatible mode without rotation
     for( uint8_t i=0; i<sizeof(s_oled96x64_initData16); i++)
     {
         ssd1306_sendCommand(pgm_read_byte(&s_oled96x64_initData16[i]));
@@ -266,7 +350,7 @@ void ssd1331_drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint16_t c
     ssd1306_intf.send(x2);
     ssd1306_intf.send(y2);
     ssd1306_intf.send( (color & 0x03) << 4 );
-    ssd1306_intf.send( (color & 0x1C) << 2 );
+    ssd1306_intf.send( (color & 0x1C) << 1 );
     ssd1306_intf.send( (color & 0xE0) >> 2 );
     ssd1306_intf.stop();
 }
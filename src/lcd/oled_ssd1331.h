@@ -84,6 +84,16 @@ void        ssd1331_setMode(lcd_mode_t mode);
  */
 void         ssd1331_96x64_init(void);
 
+/**
+ * @brief Inits 96x64 RGB OLED display in 16-bit mode (based on SSD1331 controller).
+ *
+ * Inits 96x64 RGB OLED display in 16-bit mode (based on SSD1331 controller).
+ * User must init communication interface (i2c, spi) prior to calling this function.
+ * @see ssd1306_i2cInit()
+ * @see ssd1306_spiInit()
+ */
+void         ssd1331_96x64_init16(void);
+
 /**
  * @brief Inits 96x64 RGB OLED display over spi in 8-bit mode (based on SSD1331 controller).
  *
@@ -35,9 +35,6 @@
 
 #define CMD_ARG     0xFF
 
-extern uint16_t ssd1306_color;
-extern uint32_t s_ssd1306_spi_clock;
-
 static const PROGMEM uint8_t s_oled128x128_initData[] =
 {
 #ifdef SDL_EMULATION
@@ -68,8 +65,8 @@ static const PROGMEM uint8_t s_oled128x128_initData[] =
     SSD1351_NORMALDISPLAY,
 };
 
-static uint8_t s_column;
-static uint8_t s_page;
+static SSD1306_THREAD_LOCAL uint8_t s_column;
+static SSD1306_THREAD_LOCAL uint8_t s_page;
 
 static void ssd1351_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -184,6 +181,7 @@ static void ssd1351_sendPixel16(uint16_t color)
 void    ssd1351_128x128_init()
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.height = 128;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1351_setBlock;
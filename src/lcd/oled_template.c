@@ -31,8 +31,6 @@
 #include "sdl_core.h"
 #endif
 
-extern uint16_t ssd1306_color;
-
 static const PROGMEM uint8_t s_oled_WxH_initData[] =
 {
 #ifdef SDL_EMULATION
@@ -49,8 +47,8 @@ static const PROGMEM uint8_t s_oled_WxH_initData[] =
 /////////////   template functions below are for SPI display  ////////////
 /////////////   in ssd1306 compatible mode                    ////////////
 
-static uint8_t s_column;
-static uint8_t s_page;
+static SSD1306_THREAD_LOCAL uint8_t s_column;
+static SSD1306_THREAD_LOCAL uint8_t s_page;
 
 // The function must set block to draw data
 static void template_setBlock_compat(lcduint_t x, lcduint_t y, lcduint_t w)
@@ -144,6 +142,7 @@ void    template_setMode(lcd_mode_t mode)
 void    template_WxH_init()
 {
     ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 96;  // specify width
     ssd1306_lcd.height = 64; // specify height
     // Set functions for compatible mode
@@ -0,0 +1,457 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "remote_display.h"
+#include "lcd_common.h"
+#include "intf/ssd1306_interface.h"
+#include "ssd1306_hal/io.h"
+
+#define REMOTE_FRAME_END    0x7E
+#define REMOTE_ESCAPE       0x7D
+
+/////////////////////////////// CRC ////////////////////////////////////////
+
+static uint16_t remote_crc(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 8; i > 0; i--)
+    {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+/////////////////////////////// SENDER /////////////////////////////////////
+
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_transport     (s_ssd1306_context->remote.transport)
+#define s_current       (s_ssd1306_context->remote.current)
+#define s_sent          (s_ssd1306_context->remote.sent)
+#define s_column        (s_ssd1306_context->remote.column)
+#define s_page          (s_ssd1306_context->remote.page)
+#define s_x1            (s_ssd1306_context->remote.x1)
+#define s_x2            (s_ssd1306_context->remote.x2)
+#define s_seq           (s_ssd1306_context->remote.seq)
+#define s_keyInterval   (s_ssd1306_context->remote.key_interval)
+#define s_framesToKey   (s_ssd1306_context->remote.frames_to_key)
+#define s_txCrc         (s_ssd1306_context->remote.crc)
+#define s_txBytes       (s_ssd1306_context->remote.bytes)
+#else
+static ssd1306_interface_t s_transport;
+static uint8_t *s_current;
+static uint8_t *s_sent;
+static lcduint_t s_column;
+static lcduint_t s_page;
+static lcduint_t s_x1;
+static lcduint_t s_x2;
+static uint8_t s_seq = 0;
+static uint8_t s_keyInterval = 64;
+static uint8_t s_framesToKey = 0;
+static uint16_t s_txCrc;
+static uint32_t s_txBytes;
+#endif
+
+static void remote_set_block(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    s_x1 = x;
+    s_x2 = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_column = x;
+    s_page = y;
+}
+
+static void remote_next_page(void)
+{
+}
+
+static void remote_send_pixels1(uint8_t data)
+{
+    if ( s_column < ssd1306_lcd.width && s_page < (ssd1306_lcd.height >> 3) )
+    {
+        s_current[s_page * ssd1306_lcd.width + s_column] = data;
+    }
+    /* Horizontal addressing mode: wrap to the start of next page */
+    if ( ++s_column > s_x2 )
+    {
+        s_column = s_x1;
+        s_page++;
+    }
+}
+
+static void remote_send_pixels_buffer1(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        remote_send_pixels1(*buffer);
+        buffer++;
+    }
+}
+
+static void remote_send_pixels8(uint8_t data)
+{
+}
+
+static void remote_set_mode(lcd_mode_t mode)
+{
+}
+
+static void remote_empty(void)
+{
+}
+
+static void remote_empty_send(uint8_t data)
+{
+}
+
+static void remote_empty_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+}
+
+static void remote_close(void)
+{
+    if ( s_transport.close )
+    {
+        s_transport.close();
+    }
+}
+
+static void remote_tx(uint8_t data)
+{
+    s_txCrc = remote_crc(s_txCrc, data);
+    s_txBytes++;
+    s_transport.send(data);
+}
+
+static inline uint8_t remote_byte(const uint8_t *cur, const uint8_t *sent, lcduint_t i)
+{
+    return sent ? cur[i] ^ sent[i] : cur[i];
+}
+
+/* Packs block with RLE. If sent is NULL, raw content is packed */
+static void remote_tx_rle(const uint8_t *cur, const uint8_t *sent, lcduint_t w)
+{
+    lcduint_t i = 0;
+    while ( i < w )
+    {
+        uint8_t b = remote_byte(cur, sent, i);
+        lcduint_t run = 1;
+        while ( i + run < w && run < 128 && remote_byte(cur, sent, i + run) == b )
+        {
+            run++;
+        }
+        if ( run >= 3 )
+        {
+            remote_tx(0x80 | (run - 1));
+            remote_tx(b);
+            i += run;
+            continue;
+        }
+        lcduint_t j = i;
+        while ( j < w && j - i < 128 )
+        {
+            if ( j + 2 < w && remote_byte(cur, sent, j) == remote_byte(cur, sent, j + 1) &&
+                 remote_byte(cur, sent, j) == remote_byte(cur, sent, j + 2) )
+            {
+                break;
+            }
+            j++;
+        }
+        remote_tx(j - i - 1);
+        for (; i < j; i++)
+        {
+            remote_tx(remote_byte(cur, sent, i));
+        }
+    }
+}
+
+static void remote_tx_block(uint8_t key, lcduint_t x, lcduint_t page, lcduint_t w)
+{
+    uint16_t offset = page * ssd1306_lcd.width + x;
+    s_txCrc = 0xFFFF;
+    s_transport.start();
+    remote_tx(key ? REMOTE_DISPLAY_KEY : REMOTE_DISPLAY_DELTA);
+    remote_tx(s_seq++);
+    remote_tx(x);
+    remote_tx(page);
+    remote_tx(w);
+    remote_tx_rle(&s_current[offset], key ? NULL : &s_sent[offset], w);
+    uint16_t crc = s_txCrc;
+    remote_tx(crc & 0xFF);
+    remote_tx(crc >> 8);
+    s_transport.stop();
+    for (lcduint_t i = 0; i < w; i++)
+    {
+        s_sent[offset + i] = s_current[offset + i];
+    }
+}
+
+/* Block x and width are sent as single bytes, and receiver tracks up to 32 pages */
+static uint8_t remote_size_valid(lcduint_t width, lcduint_t height)
+{
+    return (width > 0) && (width <= 255) && (height >= 8) && (height <= 256) && !(height & 7);
+}
+
+int remote_display_init(lcduint_t width, lcduint_t height, uint8_t *buffer)
+{
+    if ( !remote_size_valid(width, height) )
+    {
+        return -1;
+    }
+    s_transport = ssd1306_intf;
+    ssd1306_intf.start = remote_empty;
+    ssd1306_intf.stop = remote_empty;
+    ssd1306_intf.send = remote_empty_send;
+    ssd1306_intf.send_buffer = remote_empty_send_buffer;
+    ssd1306_intf.close = remote_close;
+    ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcd.width = width;
+    ssd1306_lcd.height = height;
+    ssd1306_lcd.set_block = remote_set_block;
+    ssd1306_lcd.next_page = remote_next_page;
+    ssd1306_lcd.send_pixels1 = remote_send_pixels1;
+    ssd1306_lcd.send_pixels_buffer1 = remote_send_pixels_buffer1;
+    ssd1306_lcd.send_pixels8 = remote_send_pixels8;
+    ssd1306_lcd.set_mode = remote_set_mode;
+    ssd1306_lcd.accel = NULL;
+    s_current = buffer;
+    s_sent = buffer + width * (height >> 3);
+    for (uint16_t i = 0; i < width * (height >> 3); i++)
+    {
+        s_current[i] = 0;
+        s_sent[i] = 0;
+    }
+    s_framesToKey = 0;
+    return 0;
+}
+
+void remote_display_setKeyInterval(uint8_t frames)
+{
+    s_keyInterval = frames;
+    s_framesToKey = 0;
+}
+
+uint32_t remote_display_flush(void)
+{
+    uint8_t key = s_framesToKey == 0;
+    s_txBytes = 0;
+    for (lcduint_t page = 0; page < (ssd1306_lcd.height >> 3); page++)
+    {
+        const uint8_t *cur = &s_current[page * ssd1306_lcd.width];
+        const uint8_t *sent = &s_sent[page * ssd1306_lcd.width];
+        lcduint_t x1 = 0;
+        lcduint_t x2 = ssd1306_lcd.width - 1;
+        if ( !key )
+        {
+            while ( x1 < ssd1306_lcd.width && cur[x1] == sent[x1] ) x1++;
+            if ( x1 == ssd1306_lcd.width )
+            {
+                continue;
+            }
+            while ( cur[x2] == sent[x2] ) x2--;
+        }
+        remote_tx_block(key, x1, page, x2 - x1 + 1);
+    }
+    if ( key )
+    {
+        /* Interval 0 means single key frame after init */
+        s_framesToKey = s_keyInterval ? s_keyInterval : 0xFF;
+    }
+    if ( s_keyInterval )
+    {
+        s_framesToKey--;
+    }
+    return s_txBytes;
+}
+
+/////////////////////////////// RECEIVER ///////////////////////////////////
+
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_rxBuffer      (s_ssd1306_context->remote_rx.buffer)
+#define s_rxWidth       (s_ssd1306_context->remote_rx.width)
+#define s_rxHeight      (s_ssd1306_context->remote_rx.height)
+#define s_rx            (s_ssd1306_context->remote_rx.packet)
+#define s_rxLen         (s_ssd1306_context->remote_rx.len)
+#define s_rxEscape      (s_ssd1306_context->remote_rx.escape)
+#define s_rxOverflow    (s_ssd1306_context->remote_rx.overflow)
+#define s_rxSeq         (s_ssd1306_context->remote_rx.seq)
+#define s_rxSynced      (s_ssd1306_context->remote_rx.synced)
+#define s_rxValidPages  (s_ssd1306_context->remote_rx.valid_pages)
+#define s_rxStats       (s_ssd1306_context->remote_rx.stats)
+#else
+static uint8_t *s_rxBuffer;
+static lcduint_t s_rxWidth;
+static lcduint_t s_rxHeight;
+static uint8_t s_rx[REMOTE_DISPLAY_MAX_PACKET];
+static uint16_t s_rxLen;
+static uint8_t s_rxEscape;
+static uint8_t s_rxOverflow;
+static uint8_t s_rxSeq;
+static uint8_t s_rxSynced;
+static uint32_t s_rxValidPages;
+static remote_receiver_stats_t s_rxStats;
+#endif
+
+int remote_receiver_init(lcduint_t width, lcduint_t height, uint8_t *buffer)
+{
+    if ( !remote_size_valid(width, height) )
+    {
+        return -1;
+    }
+    s_rxBuffer = buffer;
+    s_rxWidth = width;
+    s_rxHeight = height;
+    s_rxLen = 0;
+    s_rxEscape = 0;
+    s_rxOverflow = 0;
+    s_rxSynced = 0;
+    s_rxValidPages = 0;
+    for (uint16_t i = 0; i < width * (height >> 3); i++)
+    {
+        buffer[i] = 0;
+    }
+    s_rxStats.packets = 0;
+    s_rxStats.crcErrors = 0;
+    s_rxStats.lostPackets = 0;
+    s_rxStats.skipped = 0;
+    return 0;
+}
+
+/* Unpacks RLE data to the block, returns 0 if data doesn't match block width */
+static uint8_t remote_rx_rle(uint8_t *dst, lcduint_t w, uint8_t key, const uint8_t *p, const uint8_t *end)
+{
+    lcduint_t i = 0;
+    while ( p < end )
+    {
+        uint8_t ctl = *p++;
+        uint8_t count = (ctl & 0x7F) + 1;
+        if ( i + count > w || p + ((ctl & 0x80) ? 1 : count) > end )
+        {
+            return 0;
+        }
+        for (; count > 0; count--, i++)
+        {
+            uint8_t b = *p;
+            dst[i] = key ? b : dst[i] ^ b;
+            if ( !(ctl & 0x80) ) p++;
+        }
+        if ( ctl & 0x80 ) p++;
+    }
+    return i == w;
+}
+
+static uint8_t remote_rx_packet(void)
+{
+    uint16_t crc = 0xFFFF;
+    if ( s_rxLen < 8 )
+    {
+        return 0;
+    }
+    for (uint16_t i = 0; i < s_rxLen - 2; i++)
+    {
+        crc = remote_crc(crc, s_rx[i]);
+    }
+    if ( (crc & 0xFF) != s_rx[s_rxLen - 2] || (crc >> 8) != s_rx[s_rxLen - 1] )
+    {
+        s_rxStats.crcErrors++;
+        return 0;
+    }
+    uint8_t key = s_rx[0] == REMOTE_DISPLAY_KEY;
+    lcduint_t x = s_rx[2];
+    lcduint_t page = s_rx[3];
+    lcduint_t w = s_rx[4];
+    if ( (!key && s_rx[0] != REMOTE_DISPLAY_DELTA) || page >= (s_rxHeight >> 3) || x + w > s_rxWidth || !w )
+    {
+        s_rxStats.crcErrors++;
+        return 0;
+    }
+    if ( s_rxSynced && s_rx[1] != s_rxSeq )
+    {
+        s_rxStats.lostPackets += (uint8_t)(s_rx[1] - s_rxSeq);
+        /* Any page can be damaged by lost packet */
+        s_rxValidPages = 0;
+    }
+    s_rxSeq = s_rx[1] + 1;
+    s_rxSynced = 1;
+    if ( !key && !(s_rxValidPages & ((uint32_t)1 << page)) )
+    {
+        s_rxStats.skipped++;
+        return 0;
+    }
+    uint8_t *dst = &s_rxBuffer[page * s_rxWidth + x];
+    if ( !remote_rx_rle(dst, w, key, &s_rx[5], &s_rx[s_rxLen - 2]) )
+    {
+        /* Block is partially updated, wait for next key packet */
+        s_rxValidPages &= ~((uint32_t)1 << page);
+        s_rxStats.crcErrors++;
+        return 0;
+    }
+    if ( key && x == 0 && w == s_rxWidth )
+    {
+        s_rxValidPages |= (uint32_t)1 << page;
+    }
+    s_rxStats.packets++;
+    ssd1306_lcd.set_block(x, page, w);
+    ssd1306_lcd.send_pixels_buffer1(dst, w);
+    ssd1306_intf.stop();
+    return 1;
+}
+
+uint8_t remote_receiver_process(uint8_t data)
+{
+    uint8_t result = 0;
+    if ( data == REMOTE_FRAME_END )
+    {
+        if ( !s_rxOverflow )
+        {
+            result = remote_rx_packet();
+        }
+        s_rxLen = 0;
+        s_rxEscape = 0;
+        s_rxOverflow = 0;
+        return result;
+    }
+    if ( data == REMOTE_ESCAPE )
+    {
+        s_rxEscape = 1;
+        return 0;
+    }
+    if ( s_rxEscape )
+    {
+        data ^= 0x20;
+        s_rxEscape = 0;
+    }
+    if ( s_rxLen < sizeof(s_rx) )
+    {
+        s_rx[s_rxLen++] = data;
+    }
+    else
+    {
+        s_rxOverflow = 1;
+    }
+    return 0;
+}
+
+const remote_receiver_stats_t *remote_receiver_getStats(void)
+{
+    return &s_rxStats;
+}
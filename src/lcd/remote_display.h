@@ -0,0 +1,143 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file remote_display.h delta-compressed remote display protocol
+ */
+
+#ifndef _SSD1306_REMOTE_DISPLAY_H_
+#define _SSD1306_REMOTE_DISPLAY_H_
+
+#include "ssd1306_hal/io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup REMOTE_DISPLAY_API Remote display: mirroring display over serial link
+ * @{
+ *
+ * @brief Sends display content to remote receiver as compressed deltas
+ *
+ * @details Remote display is monochrome display driver, which keeps display content
+ *          in local buffer. remote_display_flush() compares the buffer with the content,
+ *          sent last time, and sends changed columns of each page as separate packet.
+ *          Each packet is terminated with 0x7E byte, and 0x7E, 0x7D bytes inside the packet
+ *          are escaped with 0x7D followed by byte ^ 0x20, exactly as ssd1306_uartInit_Builtin()
+ *          and ssd1306_platform_uartInit() do. The packet has the following format:
+ *          - type: REMOTE_DISPLAY_KEY (raw pixels) or REMOTE_DISPLAY_DELTA (pixels XOR
+ *            previous content)
+ *          - sequence number, incremented for each packet
+ *          - x, page, width of updated block, single byte each, so display width
+ *            is limited to 255 pixels
+ *          - RLE encoded data: control byte N < 0x80 is followed by N+1 bytes as is,
+ *            control byte N >= 0x80 is followed by single byte, repeated (N & 0x7F) + 1 times
+ *          - CRC16-CCITT of all previous bytes, least significant byte first
+ *
+ *          Receiver drops damaged packets. If sequence number shows lost packet, receiver
+ *          ignores delta packets until next key packet for each page. Sender repeats full
+ *          content in key packets with interval, set by remote_display_setKeyInterval().
+ */
+
+/** Packet type: block content */
+#define REMOTE_DISPLAY_KEY           0x4B
+/** Packet type: block content XOR previously sent content */
+#define REMOTE_DISPLAY_DELTA         0x44
+/** Maximum packet size before escaping, including type, sequence number, block and CRC */
+#define REMOTE_DISPLAY_MAX_PACKET    (5 + 255 + 2 + 2)
+
+/** Remote display receiver statistics */
+typedef struct
+{
+    uint32_t packets;       ///< number of applied packets
+    uint32_t crcErrors;     ///< number of damaged packets
+    uint32_t lostPackets;   ///< number of packets, lost according to sequence numbers
+    uint32_t skipped;       ///< number of delta packets, skipped due to lost packets
+} remote_receiver_stats_t;
+
+/**
+ * @brief Inits remote monochrome display of specified size.
+ *
+ * Inits remote monochrome display. User must init communication interface (uart)
+ * prior to calling this function. The interface is used by remote_display_flush() only,
+ * so library drawing functions do not send anything until remote_display_flush() is called.
+ *
+ * @param width width of display in pixels [1-255]
+ * @param height height of display in pixels, must be multiple of 8 [8-256]
+ * @param buffer buffer of width * height / 4 bytes to hold current and sent content
+ * @return 0 on success, -1 if display size is not supported by the protocol
+ *
+ * @see ssd1306_uartInit_Builtin()
+ * @see ssd1306_platform_uartInit()
+ */
+int remote_display_init(lcduint_t width, lcduint_t height, uint8_t *buffer);
+
+/**
+ * Sets how often remote display sends full content in key packets.
+ * Next remote_display_flush() after this call always sends key packets.
+ * @param frames number of remote_display_flush() calls between key packets,
+ *        0 to send key packets only on first flush. Default is 64.
+ */
+void remote_display_setKeyInterval(uint8_t frames);
+
+/**
+ * Sends changes, made since last call, to the receiver.
+ * @return number of bytes sent before escaping
+ */
+uint32_t remote_display_flush(void);
+
+/**
+ * @brief Inits remote display receiver.
+ *
+ * Inits remote display receiver. Received content is output to the display,
+ * initialized via ssd1306_lcd, in ssd1306 compatible mode.
+ *
+ * @param width width of display in pixels, must match sender [1-255]
+ * @param height height of display in pixels, must match sender [8-256]
+ * @param buffer buffer of width * height / 8 bytes to hold display content
+ * @return 0 on success, -1 if display size is not supported by the protocol
+ */
+int remote_receiver_init(lcduint_t width, lcduint_t height, uint8_t *buffer);
+
+/**
+ * Processes byte, received from sender.
+ * @param data received byte
+ * @return 1 if packet is completed and applied to display, 0 otherwise
+ */
+uint8_t remote_receiver_process(uint8_t data);
+
+/**
+ * Returns receiver statistics.
+ */
+const remote_receiver_stats_t *remote_receiver_getStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,10 +28,8 @@
 #include "intf/ssd1306_interface.h"
 #include "ssd1306_hal/io.h"
 
-static uint8_t s_column = 0;
-static uint8_t s_page = 0;
-
-extern uint16_t ssd1306_color;
+static SSD1306_THREAD_LOCAL uint8_t s_column = 0;
+static SSD1306_THREAD_LOCAL uint8_t s_page = 0;
 
 static void vga_set_block1(lcduint_t x, lcduint_t y, lcduint_t w)
 {
@@ -121,6 +119,7 @@ static void vga_set_mode(lcd_mode_t mode)
 void vga_96x40_8colors_init(void)
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 96;
     ssd1306_lcd.height = 40;
     ssd1306_lcd.set_block = vga_set_block1;
@@ -134,6 +133,7 @@ void vga_96x40_8colors_init(void)
 void vga_128x64_mono_init(void)
 {
     ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcd.accel = NULL;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.set_block = vga_set_block2;
@@ -30,7 +30,9 @@
 #define _NANO_ENGINE_H_
 
 #include "nano_engine/sprite.h"
+#include "nano_engine/grid.h"
 #include "nano_engine/canvas.h"
+#include "nano_engine/text.h"
 #include "nano_engine/adafruit.h"
 #include "nano_engine/tiler.h"
 #include "nano_engine/core.h"
@@ -116,6 +116,43 @@ public:
     {
         fillRect(offset.x, offset.y, _width, _height, color);
     }
+
+    // Native implementations of Adafruit GFX primitives. Clipping and rotation
+    // are performed once per primitive instead of per pixel.
+    void writePixel(int16_t x, int16_t y, uint16_t color) override
+    {
+        AdafruitCanvasOps<BPP>::drawPixel(x, y, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+    {
+        AdafruitCanvasOps<BPP>::fillRect(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+    {
+        AdafruitCanvasOps<BPP>::fillRect(x, y, 1, h, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+    {
+        if (mapRect(x, y, w, h))
+        {
+            fillRawRect(x, y, w, h, color);
+        }
+    }
+
+    using Adafruit_GFX::drawBitmap;
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+        drawRawBitmap(x, y, bitmap, w, h, color, color, false);
+    }
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+        drawRawBitmap(x, y, bitmap, w, h, color, bg, true);
+    }
 #endif
 
 protected:
@@ -124,6 +161,99 @@ protected:
     uint8_t *m_buffer;
 
 private:
+    /** Sets pixel in buffer coordinates without clipping */
+    inline void putRawPixel(int16_t x, int16_t y, uint16_t color);
+
+    /** Fills rectangle in buffer coordinates without clipping */
+    void fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    /**
+     * Clips rectangle in canvas coordinates and converts it to buffer coordinates.
+     * Returns false if rectangle is outside the canvas.
+     */
+    bool mapRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+    {
+        if (w < 0) { x += w + 1; w = -w; }
+        if (h < 0) { y += h + 1; h = -h; }
+        x -= offset.x;
+        y -= offset.y;
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > width()) w = width() - x;
+        if (y + h > height()) h = height() - y;
+        if ((w <= 0) || (h <= 0))
+        {
+            return false;
+        }
+        switch (getRotation())
+        {
+        case 1:
+            ssd1306_swap_data(x, y, int16_t);
+            ssd1306_swap_data(w, h, int16_t);
+            x = WIDTH - x - w;
+            break;
+        case 2:
+            x = WIDTH - x - w;
+            y = HEIGHT - y - h;
+            break;
+        case 3:
+            ssd1306_swap_data(x, y, int16_t);
+            ssd1306_swap_data(w, h, int16_t);
+            y = HEIGHT - y - h;
+            break;
+        }
+        return true;
+    }
+
+    void drawRawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                       uint16_t color, uint16_t bg, bool useBg)
+    {
+        static const int8_t steps[4][4] =
+        {
+            /* column: dx, dy;  row: dx, dy */
+            {  1,  0,  0,  1 },
+            {  0,  1, -1,  0 },
+            { -1,  0,  0, -1 },
+            {  0, -1,  1,  0 },
+        };
+        int16_t byteWidth = (w + 7) / 8;
+        x -= offset.x;
+        y -= offset.y;
+        int16_t i0 = x < 0 ? -x : 0;
+        int16_t j0 = y < 0 ? -y : 0;
+        int16_t i1 = w < width() - x ? w : width() - x;
+        int16_t j1 = h < height() - y ? h : height() - y;
+        if ((i0 >= i1) || (j0 >= j1))
+        {
+            return;
+        }
+        const int8_t *step = steps[getRotation() & 3];
+        int16_t px = x + i0;
+        int16_t py = y + j0;
+        rotatePosition(px, py);
+        for (int16_t j = j0; j < j1; j++)
+        {
+            int16_t qx = px;
+            int16_t qy = py;
+            const uint8_t *row = bitmap + j * byteWidth;
+            for (int16_t i = i0; i < i1; i++)
+            {
+                if (pgm_read_byte(&row[i >> 3]) & (0x80 >> (i & 7)))
+                {
+                    putRawPixel(qx, qy, color);
+                }
+                else if (useBg)
+                {
+                    putRawPixel(qx, qy, bg);
+                }
+                qx += step[0];
+                qy += step[1];
+            }
+            px += step[2];
+            py += step[3];
+        }
+    }
+
     inline void rotatePosition(int16_t &x, int16_t &y)
     {
         switch (getRotation()) {
@@ -202,6 +332,17 @@ public:
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <>
+inline void AdafruitCanvasOps<1>::putRawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    switch (color)
+    {
+        case 1:   m_buffer[x+ (y/8)*WIDTH] |=  (1 << (y&7)); break;
+        case 0:   m_buffer[x+ (y/8)*WIDTH] &= ~(1 << (y&7)); break;
+        case 2:   m_buffer[x+ (y/8)*WIDTH] ^=  (1 << (y&7)); break;
+    }
+}
+
 template <>
 void AdafruitCanvasOps<1>::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
@@ -212,12 +353,35 @@ void AdafruitCanvasOps<1>::drawPixel(int16_t x, int16_t y, uint16_t color)
         return;
     }
     rotatePosition(x, y);
+    putRawPixel(x, y, color);
+}
 
-    switch (color)
+template <>
+void AdafruitCanvasOps<1>::fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (color > 2)
     {
-        case 1:   m_buffer[x+ (y/8)*WIDTH] |=  (1 << (y&7)); break;
-        case 0:   m_buffer[x+ (y/8)*WIDTH] &= ~(1 << (y&7)); break;
-        case 2:   m_buffer[x+ (y/8)*WIDTH] ^=  (1 << (y&7)); break;
+        return;
+    }
+    /* Process the rectangle page by page: each byte holds 8 vertical pixels */
+    while (h > 0)
+    {
+        uint8_t bit = y & 7;
+        uint8_t count = (8 - bit) < h ? (8 - bit) : h;
+        uint8_t mask = (uint8_t)(0xFF << bit) & (uint8_t)(0xFF >> (8 - bit - count));
+        uint8_t *p = &m_buffer[x + (y/8)*WIDTH];
+        for (int16_t i = w; i > 0; i--)
+        {
+            switch (color)
+            {
+                case 1:   *p |=  mask; break;
+                case 0:   *p &= ~mask; break;
+                default:  *p ^=  mask; break;
+            }
+            p++;
+        }
+        y += count;
+        h -= count;
     }
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -258,6 +422,12 @@ public:
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <>
+inline void AdafruitCanvasOps<8>::putRawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    m_buffer[x+y*WIDTH] = color;
+}
+
 template <>
 void AdafruitCanvasOps<8>::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
@@ -268,8 +438,18 @@ void AdafruitCanvasOps<8>::drawPixel(int16_t x, int16_t y, uint16_t color)
         return;
     }
     rotatePosition(x, y);
+    putRawPixel(x, y, color);
+}
 
-    m_buffer[x+y*WIDTH] = color;
+template <>
+void AdafruitCanvasOps<8>::fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint8_t *p = &m_buffer[x + y*WIDTH];
+    while (h--)
+    {
+        memset(p, color, w);
+        p += WIDTH;
+    }
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -310,6 +490,13 @@ public:
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <>
+inline void AdafruitCanvasOps<16>::putRawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    m_buffer[(x+y*WIDTH) * 2 + 0] = color;
+    m_buffer[(x+y*WIDTH) * 2 + 1] = color >> 8;
+}
+
 template <>
 void AdafruitCanvasOps<16>::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
@@ -320,9 +507,24 @@ void AdafruitCanvasOps<16>::drawPixel(int16_t x, int16_t y, uint16_t color)
         return;
     }
     rotatePosition(x, y);
+    putRawPixel(x, y, color);
+}
 
-    m_buffer[(x+y*WIDTH) * 2 + 0] = color;
-    m_buffer[(x+y*WIDTH) * 2 + 1] = color >> 8;
+template <>
+void AdafruitCanvasOps<16>::fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint8_t *p = &m_buffer[(x + y*WIDTH) * 2];
+    while (h--)
+    {
+        uint8_t *q = p;
+        for (int16_t i = w; i > 0; i--)
+        {
+            q[0] = color;
+            q[1] = color >> 8;
+            q += 2;
+        }
+        p += WIDTH * 2;
+    }
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
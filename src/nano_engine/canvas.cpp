@@ -25,9 +25,9 @@
 #include "canvas.h"
 #include "lcd/lcd_common.h"
 #include "ssd1306.h"
+#include "ssd1306_trace.h"
 
 extern const uint8_t *s_font6x8;
-extern "C" SFixedFontInfo s_fixedFont;
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
 extern "C" uint8_t g_ssd1306_unicode;
 #endif
@@ -38,6 +38,91 @@ extern "C" uint8_t g_ssd1306_unicode;
 //
 /////////////////////////////////////////////////////////////////////////////////
 
+NanoGlyphCache::NanoGlyphCache(uint8_t *buffer, uint16_t size)
+    : m_buffer(buffer)
+    , m_size(size)
+    , m_tags(nullptr)
+    , m_data(nullptr)
+    , m_count(0)
+    , m_slotSize(0)
+    , m_color(0)
+{
+}
+
+void NanoGlyphCache::reset()
+{
+    m_slotSize = 0;
+}
+
+uint8_t *NanoGlyphCache::find(uint16_t unicode, const uint8_t *glyph, uint16_t slotSize,
+                              uint16_t color, bool &cached)
+{
+    if ( (slotSize != m_slotSize) || (color != m_color) )
+    {
+        /* Tags array must be aligned to pointer size */
+        uintptr_t start = ((uintptr_t)m_buffer + sizeof(const uint8_t *) - 1) &
+                          ~(uintptr_t)(sizeof(const uint8_t *) - 1);
+        uint16_t size = (start - (uintptr_t)m_buffer) < m_size ? m_size - (start - (uintptr_t)m_buffer) : 0;
+        m_tags = reinterpret_cast<const uint8_t **>(start);
+        uint16_t count = slotSize ? size / (slotSize + sizeof(const uint8_t *)) : 0;
+        /* Number of slots is power of 2 to avoid division, when looking for the slot */
+        m_count = 1;
+        while ( m_count <= (count >> 1) ) m_count <<= 1;
+        if ( !count ) m_count = 0;
+        m_data = reinterpret_cast<uint8_t *>(m_tags + m_count);
+        for (uint16_t i = 0; i < m_count; i++)
+        {
+            m_tags[i] = nullptr;
+        }
+        m_slotSize = slotSize;
+        m_color = color;
+    }
+    if ( !m_count )
+    {
+        return nullptr;
+    }
+    uint16_t index = unicode & (m_count - 1);
+    cached = m_tags[index] == glyph;
+    m_tags[index] = glyph;
+    return m_data + (uint32_t)index * m_slotSize;
+}
+
+/* Returns rectangle, covering both points */
+static inline NanoRect boundingRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if ( x1 > x2 ) ssd1306_swap_data(x1, x2, lcdint_t);
+    if ( y1 > y2 ) ssd1306_swap_data(y1, y2, lcdint_t);
+    return { { x1, y1 }, { x2, y2 } };
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::pushClipRect(const NanoRect &rect)
+{
+    if ( m_clipDepth >= NANO_CANVAS_CLIP_DEPTH )
+    {
+        return false;
+    }
+    m_clipStack[m_clipDepth++] = m_clip;
+    /* Intersection of rectangles is always inside the previous clip area and canvas */
+    m_clip.crop( boundingRect( rect.p1.x - offset.x, rect.p1.y - offset.y,
+                               rect.p2.x - offset.x, rect.p2.y - offset.y ) );
+    if ( m_clip.p1.y > m_clip.p2.y )
+    {
+        /* Empty clip area is marked by left border only, see clipEmpty() */
+        m_clip.p2.x = m_clip.p1.x - 1;
+    }
+    return true;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::popClipRect()
+{
+    if ( m_clipDepth )
+    {
+        m_clip = m_clipStack[--m_clipDepth];
+    }
+}
+
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::putPixel(const NanoPoint &p)
 {
@@ -47,6 +132,8 @@ void NanoCanvasOps<BPP>::putPixel(const NanoPoint &p)
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawRect");
+    if ( !isVisible( boundingRect(x1, y1, x2, y2) ) ) return;
     drawHLine(x1, y1, x2);
     drawHLine(x1, y2, x2);
     drawVLine(x1, y1, y2);
@@ -62,9 +149,13 @@ void NanoCanvasOps<BPP>::drawRect(const NanoRect &rect)
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawLine");
+    /* Skip lines, having no common points with clip area, before per-pixel work */
+    if ( !isVisible( boundingRect(x1, y1, x2, y2) ) ) return;
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
-    lcduint_t  err = 0;
+    /* Pixel is plotted before the step, and error starts at the middle, *
+     * so the line covers exactly the pixels from (x1,y1) to (x2,y2)     */
     if (dy > dx)
     {
         if (y1 > y2)
@@ -72,15 +163,18 @@ void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_
             ssd1306_swap_data(x1, x2, lcdint_t);
             ssd1306_swap_data(y1, y2, lcdint_t);
         }
-        for(; y1<=y2; y1++)
+        lcduint_t  err = dy >> 1;
+        for(;;)
         {
+            putPixel( x1, y1 );
+            if (y1 == y2) break;
+            y1++;
             err += dx;
             if (err >= dy)
             {
                  err -= dy;
                  x1 < x2 ? x1++: x1--;
             }
-            putPixel( x1, y1 );
         }
     }
     else
@@ -90,15 +184,18 @@ void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_
             ssd1306_swap_data(x1, x2, lcdint_t);
             ssd1306_swap_data(y1, y2, lcdint_t);
         }
-        for(; x1<=x2; x1++)
+        lcduint_t  err = dx >> 1;
+        for(;;)
         {
+            putPixel( x1, y1 );
+            if (x1 == x2) break;
+            x1++;
             err += dy;
             if (err >= dx)
             {
                  err -= dx;
                  if (y1 < y2) y1++; else y1--;
             }
-            putPixel( x1, y1 );
         }
     }
 }
@@ -115,6 +212,54 @@ void NanoCanvasOps<BPP>::fillRect(const NanoRect &rect)
     fillRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y);
 }
 
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillRectAlpha(const NanoRect &rect, uint8_t alpha)
+{
+    fillRectAlpha(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y, alpha);
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::clipBlock(lcdint_t &x, lcdint_t &y, lcduint_t &w, lcduint_t &h,
+                                   lcduint_t &sx, lcduint_t &sy) const
+{
+    if ( clipEmpty() || !w || !h ) return false;
+    x -= offset.x;
+    y -= offset.y;
+    lcdint_t x2 = x + (lcdint_t)w - 1;
+    lcdint_t y2 = y + (lcdint_t)h - 1;
+    if ((x2 < m_clip.p1.x) || (x > m_clip.p2.x)) return false;
+    if ((y2 < m_clip.p1.y) || (y > m_clip.p2.y)) return false;
+    sx = x < m_clip.p1.x ? (lcduint_t)(m_clip.p1.x - x) : 0;
+    sy = y < m_clip.p1.y ? (lcduint_t)(m_clip.p1.y - y) : 0;
+    x += sx;
+    y += sy;
+    if (x2 > m_clip.p2.x) x2 = m_clip.p2.x;
+    if (y2 > m_clip.p2.y) y2 = m_clip.p2.y;
+    w = (lcduint_t)(x2 - x + 1);
+    h = (lcduint_t)(y2 - y + 1);
+    return true;
+}
+
+/* Converts 8-bit opacity to 0-32 range, used by blending kernels */
+static inline uint8_t alpha5(uint8_t alpha)
+{
+    return (uint8_t)(((uint16_t)alpha + 4) >> 3);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawGlyph(lcdint_t x, lcdint_t y, uint16_t unicode, const SCharInfo &info)
+{
+    /* Invisible glyphs are skipped before glyph cache lookup and font decoding */
+    if ( !isVisible( { { x, y }, { (lcdint_t)(x + info.width - 1), (lcdint_t)(y + info.height - 1) } } ) )
+    {
+        return;
+    }
+    if ( !drawCachedGlyph(unicode, info, x, y, m_textMode & CANVAS_MODE_TRANSPARENT) )
+    {
+        drawBitmap1(x, y, info.width, info.height, info.glyph);
+    }
+}
+
 template <uint8_t BPP>
 uint8_t NanoCanvasOps<BPP>::printChar(uint8_t c)
 {
@@ -122,29 +267,117 @@ uint8_t NanoCanvasOps<BPP>::printChar(uint8_t c)
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
+    /* Move to new line, if the char doesn't fit, using real width of the glyph */
+    lcdint_t right = m_cursorX + (lcdint_t)char_info.width;
+    if ( (m_cursorX > 0) &&
+         ( ( (m_textMode & CANVAS_TEXT_WRAP_LOCAL) && (right > (lcdint_t)m_w) )
+        || ( (m_textMode & CANVAS_TEXT_WRAP) && (right > (lcdint_t)ssd1306_lcd.width) ) ) )
+    {
+        m_cursorY += (lcdint_t)s_fixedFont.h.height;
+        m_cursorX = 0;
+        if ( (m_textMode & CANVAS_TEXT_WRAP_LOCAL) && (m_cursorY > ((lcdint_t)m_h - (lcdint_t)s_fixedFont.h.height)) )
+        {
+            m_cursorY = 0;
+        }
+    }
     uint8_t mode = m_textMode;
     for (uint8_t i = 0; i<(m_fontStyle == STYLE_BOLD ? 2: 1); i++)
     {
-        drawBitmap1(m_cursorX + i,
-                    m_cursorY,
-                    char_info.width,
-                    char_info.height,
-                    char_info.glyph );
+        drawGlyph(m_cursorX + i, m_cursorY, unicode, char_info);
         m_textMode |= CANVAS_MODE_TRANSPARENT;
     }
     m_textMode = mode;
     m_cursorX += (lcdint_t)(char_info.width + char_info.spacing);
-    if ( ( (m_textMode & CANVAS_TEXT_WRAP_LOCAL) && (m_cursorX > ((lcdint_t)m_w - (lcdint_t)s_fixedFont.h.width) ) )
-       || ( (m_textMode & CANVAS_TEXT_WRAP) && (m_cursorX > ((lcdint_t)ssd1306_lcd.width - (lcdint_t)s_fixedFont.h.width)) ) )
+    return 1;
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::drawCachedGlyph(uint16_t unicode, const SCharInfo &info, lcdint_t xpos, lcdint_t ypos, bool transparent)
+{
+    const uint8_t bytes = BPP / 8;
+    /* Only 8-bit and 16-bit canvases store pixels in whole bytes */
+    if ( (bytes == 0) || (!m_glyphCache) )
     {
-        m_cursorY += (lcdint_t)s_fixedFont.h.height;
-        m_cursorX = 0;
-        if ( (m_textMode & CANVAS_TEXT_WRAP_LOCAL) && (m_cursorY > ((lcdint_t)m_h - (lcdint_t)s_fixedFont.h.height)) )
+        return false;
+    }
+    /* Color key copy cannot draw black glyphs over the background */
+    if ( transparent && !m_color )
+    {
+        return false;
+    }
+    uint16_t slotSize = (uint16_t)s_fixedFont.h.width * s_fixedFont.h.height * bytes;
+    if ( (uint16_t)info.width * info.height * bytes > slotSize )
+    {
+        return false;
+    }
+    uint8_t pixel[2] = { (uint8_t)(bytes == 2 ? m_color >> 8 : m_color), (uint8_t)(m_color & 0xFF) };
+    bool cached = false;
+    uint8_t *glyph = m_glyphCache->find(unicode, info.glyph, slotSize, m_color, cached);
+    if ( !glyph )
+    {
+        return false;
+    }
+    lcduint_t pitch = (lcduint_t)info.width * bytes;
+    if ( !cached )
+    {
+        /* Expand page-ordered font bits to row-ordered canvas pixels */
+        for (lcduint_t y = 0; y < info.height; y++)
         {
-            m_cursorY = 0;
+            const uint8_t *src = info.glyph + (y >> 3) * info.width;
+            uint8_t *dst = glyph + y * pitch;
+            for (lcduint_t x = 0; x < info.width; x++)
+            {
+                bool set = pgm_read_byte( &src[x] ) & (1 << (y & 0x07));
+                for (uint8_t b = 0; b < bytes; b++)
+                {
+                    *dst++ = set ? pixel[b] : 0x00;
+                }
+            }
         }
     }
-    return 1;
+    /* calculate char rectangle */
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)info.width - 1;
+    lcdint_t y2 = y1 + (lcdint_t)info.height - 1;
+    /* clip glyph */
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return true;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return true;
+    const uint8_t *src = glyph;
+    if (x1 < m_clip.p1.x)
+    {
+        src += (lcduint_t)(m_clip.p1.x - x1) * bytes;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        src += (lcduint_t)(m_clip.p1.y - y1) * pitch;
+        y1 = m_clip.p1.y;
+    }
+    if (x2 > m_clip.p2.x) x2 = m_clip.p2.x;
+    if (y2 > m_clip.p2.y) y2 = m_clip.p2.y;
+    lcduint_t len = (lcduint_t)(x2 - x1 + 1) * bytes;
+    uint8_t *dst = m_buf + ((uint32_t)y1 * m_w + x1) * bytes;
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        if ( !transparent )
+        {
+            memcpy(dst, src, len);
+        }
+        else
+        {
+            /* Branchless color key copy: zero pixels keep canvas content */
+            for (lcduint_t i = 0; i < len; i += bytes)
+            {
+                uint8_t mask = (src[i] | src[i + bytes - 1]) ? 0x00 : 0xFF;
+                dst[i] = src[i] | (dst[i] & mask);
+                if ( bytes == 2 ) dst[i + 1] = src[i + 1] | (dst[i + 1] & mask);
+            }
+        }
+        src += pitch;
+        dst += (lcduint_t)m_w * bytes;
+    }
+    return true;
 }
 
 template <uint8_t BPP>
@@ -169,6 +402,7 @@ size_t NanoCanvasOps<BPP>::write(uint8_t c)
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::printFixed(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style)
 {
+    SSD1306_TRACE_SCOPE("canvas", "printFixed");
     m_fontStyle = style;
     m_cursorX = xpos;
     m_cursorY = y;
@@ -182,6 +416,7 @@ void NanoCanvasOps<BPP>::printFixed(lcdint_t xpos, lcdint_t y, const char *ch, E
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style)
 {
+    SSD1306_TRACE_SCOPE("canvas", "printFixedPgm");
     m_fontStyle = style;
     m_cursorX = xpos;
     m_cursorY = y;
@@ -213,8 +448,8 @@ void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x<0) || (y<0)) return;
-    if (( x >= (lcdint_t)m_w ) || ( y >= (lcdint_t)m_h)) return;
+    if ((x < m_clip.p1.x) || (y < m_clip.p1.y)) return;
+    if ((x > m_clip.p2.x) || (y > m_clip.p2.y)) return;
     if (m_color)
     {
         m_buf[YADDR1(y) + x] |= (1 << (y & 0x7));
@@ -228,14 +463,15 @@ void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 template <>
 void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (clipEmpty()) return;
     if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
     x1 -= offset.x;
     x2 -= offset.x;
     y1 -= offset.y;
-    if ((y1 >= (lcdint_t)m_h) || (y1 < 0)) return;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w -1));
+    if ((y1 > m_clip.p2.y) || (y1 < m_clip.p1.y)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    x1 = max(m_clip.p1.x, x1);
+    x2 = min(x2, m_clip.p2.x);
     uint16_t addr = YADDR1(y1) + x1;
     uint8_t mask = (1 << (y1 & 0x7));
     if (m_color)
@@ -251,14 +487,15 @@ void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 template <>
 void NanoCanvasOps<1>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (clipEmpty()) return;
     if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x1 >= (lcdint_t)m_w) || (x1 < 0)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h -1));
+    if ((x1 > m_clip.p2.x) || (x1 < m_clip.p1.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(m_clip.p1.y, y1);
+    y2 = min(y2, m_clip.p2.y);
 
     uint16_t addr = YADDR1(y1) + x1;
     if ((y1 & 0xFFF8) == (y2 & 0xFFF8))
@@ -297,18 +534,20 @@ void NanoCanvasOps<1>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 template <>
 void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "fillRect");
+    if (clipEmpty()) return;
     if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
     if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
     x1 -= offset.x;
     x2 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w - 1));
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h - 1));
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(m_clip.p1.x, x1);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(m_clip.p1.y, y1);
+    y2 = min(y2, m_clip.p2.y);
     uint8_t bank1 = (y1 >> 3);
     uint8_t bank2 = (y2 >> 3);
     for (uint8_t bank = bank1; bank<=bank2; bank++)
@@ -340,9 +579,16 @@ void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     }
 };
 
+template <>
+void NanoCanvasOps<1>::fillRectAlpha(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t alpha)
+{
+    if ( alpha >= 128 ) fillRect(x1, y1, x2, y2);
+}
+
 template <>
 void NanoCanvasOps<1>::clear()
 {
+    SSD1306_TRACE_SCOPE("canvas", "clear");
     memset(m_buf, 0, YADDR1(m_h));
 }
 
@@ -350,16 +596,18 @@ void NanoCanvasOps<1>::clear()
 template <>
 void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap1");
+    if (clipEmpty()) return;
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
     uint8_t offs = y & 0x07;
     uint8_t complexFlag = 0;
     uint8_t mainFlag = 1;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x)  return;
     if (y < 0)
     {
          bitmap += ((lcduint_t)((-y) + 7) >> 3) * w;
@@ -367,20 +615,20 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
          y = 0;
          complexFlag = 1;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-         bitmap += -x;
-         w += x;
-         x = 0;
+         bitmap += m_clip.p1.x - x;
+         w -= m_clip.p1.x - x;
+         x = m_clip.p1.x;
     }
     uint8_t max_pages = (lcduint_t)(h + 15 - offs) >> 3;
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-         h = (lcduint_t)(m_h - (lcduint_t)y);
+         h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-         w = (lcduint_t)(m_w - (lcduint_t)x);
+         w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
     uint8_t pages = ((y + h - 1) >> 3) - (y >> 3) + 1;
     uint8_t j;
@@ -390,16 +638,23 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
     {
         uint16_t addr = YADDR1(y + ((uint16_t)j<<3)) + x;
         if ( j == max_pages - 1 ) mainFlag = !offs;
+        /* Rows of the page outside of clip area are masked out */
+        lcdint_t top = ((y >> 3) + j) << 3;
+        uint8_t clipMask = 0xFF;
+        if ( top < m_clip.p1.y ) clipMask <<= (m_clip.p1.y - top < 8 ? m_clip.p1.y - top : 8);
+        if ( top + 7 > m_clip.p2.y ) clipMask &= 0xFF >> (top + 7 - m_clip.p2.y < 8 ? top + 7 - m_clip.p2.y : 8);
         for( i=w; i > 0; i--)
         {
             uint8_t data = 0;
             uint8_t mask = 0;
             if ( mainFlag )    { data |= (pgm_read_byte(bitmap) << offs); mask |= (0xFF << offs); }
             if ( complexFlag ) { data |= (pgm_read_byte(bitmap - origin_width) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
+            data &= clipMask;
+            mask &= clipMask;
             if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
             {
                 m_buf[addr] &= ~mask;
-                m_buf[addr] |= m_color == BLACK ? ~data: data;
+                m_buf[addr] |= (m_color == BLACK ? ~data: data) & mask;
             }
             else
             {
@@ -416,77 +671,95 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
     }
 }
 
+/* Reads 8 pixels of XBM bitmap row, starting at specified pixel */
+static inline uint8_t readXBitmapByte(const uint8_t *row, lcduint_t bit, lcduint_t pitch)
+{
+    lcduint_t index = bit >> 3;
+    uint8_t shift = bit & 0x07;
+    uint8_t data = pgm_read_byte(&row[index]) >> shift;
+    if ( shift && (index + 1 < pitch) )
+    {
+        data |= pgm_read_byte(&row[index + 1]) << (8 - shift);
+    }
+    return data;
+}
+
 template <>
 void NanoCanvasOps<1>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawXBitmap1");
+    if (clipEmpty()) return;
     x -= offset.x;
     y -= offset.y;
-    lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    lcduint_t pitch = (w + 7) >> 3;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x)  return;
 
-    delay(100);
-
-    uint8_t start_bit = 0;
-    lcduint_t pitch_delta = 0;
-    if (y < 0)
+    lcduint_t start_bit = 0;
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += pitch * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        start_bit = (lcduint_t)(m_clip.p1.x - x);
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    bool transparent = CANVAS_MODE_TRANSPARENT == (m_textMode & CANVAS_MODE_TRANSPARENT);
+    uint8_t offs = y & 0x07;
 
-    for(lcduint_t j = 0; j < h; j++)
+    /* Each 8x8 block of bitmap is transposed to 8 columns of 8 vertical pixels, *
+     * which are shifted to the position inside the page and can touch 2 pages   */
+    for (lcduint_t j = 0; j < h; j += 8)
     {
-        uint8_t bit = start_bit;
-        for(lcduint_t i = 0; i < w; i++)
+        uint8_t rows = h - j < 8 ? h - j : 8;
+        uint16_t rowMask = ((1 << rows) - 1) << offs;
+        uint8_t *dst = &m_buf[YADDR1(y + j) + x];
+        for (lcduint_t i = 0; i < w; i += 8)
         {
-            uint8_t data = 0;
-            data = (pgm_read_byte(bitmap) >> bit) & 0x01;
-            if (data)
-            {
-                if (m_color == BLACK)
-                    m_buf[YADDR1(y + j) + (x + i)] &= ~(1 << ((y + j) & 0x7));
-                else
-                    m_buf[YADDR1(y + j) + (x + i)] |= (1 << ((y + j) & 0x7));
-            }
-            else if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+            uint8_t block[8];
+            uint8_t cols = w - i < 8 ? w - i : 8;
+            for (uint8_t k = 0; k < 8; k++)
             {
-                if (m_color == BLACK)
-                    m_buf[YADDR1(y + j) + (x + i)] |= (1 << ((y + j) & 0x7));
-                else
-                    m_buf[YADDR1(y + j) + (x + i)] &= ~(1 << ((y + j) & 0x7));
+                block[k] = k < rows ? readXBitmapByte(bitmap + (j + k) * pitch, start_bit + i, pitch) : 0;
             }
-            bit++;
-            if (bit >= 8)
+            ssd1306_transpose8x8(block);
+            for (uint8_t k = 0; k < cols; k++)
             {
-                bitmap++;
-                bit=0;
+                uint16_t data = (uint16_t)block[k] << offs;
+                for (uint8_t n = 0; n < 2; n++)
+                {
+                    uint8_t mask = rowMask >> (n << 3);
+                    uint8_t bits = data >> (n << 3);
+                    if ( !mask ) break;
+                    uint8_t *p = dst + i + k + n * m_w;
+                    if ( transparent )
+                    {
+                        if (m_color == BLACK)
+                            *p &= ~bits;
+                        else
+                            *p |= bits;
+                    }
+                    else
+                    {
+                        *p = (*p & ~mask) | ((m_color == BLACK ? ~bits : bits) & mask);
+                    }
+                }
             }
         }
-        if (bit)
-        {
-            bitmap++;
-        }
-        bitmap += pitch_delta;
     }
 }
 
@@ -497,6 +770,8 @@ void NanoCanvasOps<1>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clip.setRect(0, 0, w - 1, h - 1);
+    m_clipDepth = 0;
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = WHITE;
@@ -524,6 +799,66 @@ void NanoCanvas1::blt(const NanoRect &rect)
     // TODO: NOT IMPLEMENTED
 }
 
+void NanoCanvas1::bltRotated(lcdint_t x, lcdint_t y, uint8_t rotation)
+{
+    uint8_t block[8];
+    lcduint_t pages = m_h >> 3;
+    rotation &= 0x03;
+    if ( rotation == 0 )
+    {
+        blt(x, y);
+        return;
+    }
+    if ( rotation == 2 )
+    {
+        /* Last page becomes the first one, columns and bits in each column are reversed */
+        ssd1306_lcd.set_block(x, y >> 3, m_w);
+        for (lcduint_t page = pages; page > 0; page--)
+        {
+            const uint8_t *src = &m_buf[YADDR1(page << 3)];
+            for (lcduint_t i = 0; i < m_w; i += 8)
+            {
+                uint8_t count = m_w - i < 8 ? m_w - i : 8;
+                for (uint8_t k = 0; k < count; k++)
+                {
+                    block[k] = ssd1306_reverseBits(*(--src));
+                }
+                ssd1306_lcd.send_pixels_buffer1(block, count);
+            }
+            ssd1306_lcd.next_page();
+        }
+        ssd1306_intf.stop();
+        return;
+    }
+    /* Each 8 columns of canvas become single page on the display. For clockwise rotation *
+     * pages of canvas go in reversed order, and transposed block is reversed. For counter *
+     * clockwise rotation columns of canvas go in reversed order.                          */
+    ssd1306_lcd.set_block(x, y >> 3, m_h);
+    for (lcduint_t col = 0; col < m_w; col += 8)
+    {
+        for (lcduint_t n = 0; n < pages; n++)
+        {
+            const uint8_t *src = &m_buf[YADDR1((rotation == 1 ? pages - 1 - n : n) << 3)];
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                lcdint_t c = rotation == 1 ? (lcdint_t)(col + i) : (lcdint_t)(m_w - 1 - col - i);
+                block[i] = (c >= 0 && c < (lcdint_t)m_w) ? src[c] : 0;
+            }
+            ssd1306_transpose8x8(block);
+            if ( rotation == 1 )
+            {
+                for (uint8_t i = 0; i < 4; i++)
+                {
+                    ssd1306_swap_data(block[i], block[7 - i], uint8_t);
+                }
+            }
+            ssd1306_lcd.send_pixels_buffer1(block, 8);
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
 //                 NANO CANVAS 1_8
 
 void NanoCanvas1_8::blt(lcdint_t x, lcdint_t y)
@@ -574,7 +909,7 @@ void NanoCanvasOps<4>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    if ((x >= m_clip.p1.x) && (y >= m_clip.p1.y) && (x <= m_clip.p2.x) && (y <= m_clip.p2.y))
     {
         m_buf[YADDR4(y) + x / 2] &= ~(0x0F << BITS_SHIFT4(x));
         m_buf[YADDR4(y) + x / 2] |= (m_color & 0x0F) << BITS_SHIFT4(x);
@@ -584,6 +919,7 @@ void NanoCanvasOps<4>::putPixel(lcdint_t x, lcdint_t y)
 template <>
 void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
@@ -591,10 +927,10 @@ void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    if ((x1 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1,m_clip.p1.y);
+    y2 = min(y2,m_clip.p2.y) - y1;
     uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
     do
     {
@@ -608,6 +944,7 @@ void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 template <>
 void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     x2 -= offset.x;
@@ -615,10 +952,10 @@ void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y1 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
     uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
     for (lcdint_t x = x1; x <= x2; x++)
     {
@@ -634,6 +971,8 @@ void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 template <>
 void NanoCanvasOps<4>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "fillRect");
+    if (clipEmpty()) return;
     if (y1 > y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
@@ -646,15 +985,15 @@ void NanoCanvasOps<4>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
-    uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
+    y1 = max(y1,m_clip.p1.y);
+    y2 = min(y2,m_clip.p2.y);
     for (lcdint_t y = y1; y <= y2; y++)
     {
+        uint8_t *buf = m_buf + YADDR4(y) + x1 / 2;
         for (lcdint_t x = x1; x <= x2; x++)
         {
             *buf &= ~(0x0F << BITS_SHIFT4(x));
@@ -664,13 +1003,20 @@ void NanoCanvasOps<4>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
                 buf++;
             }
         }
-        buf += ((lcdint_t)(m_w) - (x2 - x1 + ((x2 - x1) & 0x1))) / 2;
     }
 }
 
+template <>
+void NanoCanvasOps<4>::fillRectAlpha(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t alpha)
+{
+    if ( alpha >= 128 ) fillRect(x1, y1, x2, y2);
+}
+
 template <>
 void NanoCanvasOps<4>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap1");
+    if (clipEmpty()) return;
     lcdint_t xb1 = 0;
     lcdint_t yb1 = 0;
     lcdint_t xb2 = (lcdint_t)w - 1;
@@ -681,28 +1027,28 @@ void NanoCanvasOps<4>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + xb2;
     lcdint_t y2 = y1 + yb2;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        xb1 -= x1;
-        x1 = 0;
+        xb1 += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        yb1 -= y1;
-        y1 = 0;
+        yb1 += m_clip.p1.y - y1;
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         yb2 -= (y2 - (lcdint_t)m_h + 1);
-         y2 = (lcdint_t)m_h - 1;
+         yb2 -= (y2 - m_clip.p2.y);
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         xb2 -= (x2 - (lcdint_t)m_w + 1);
-         x2 = (lcdint_t)m_w - 1;
+         xb2 -= (x2 - m_clip.p2.x);
+         x2 = m_clip.p2.x;
     }
     for ( lcdint_t y = y1; y <= y2; y++ )
     {
@@ -730,6 +1076,8 @@ void NanoCanvasOps<4>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
 template <>
 void NanoCanvasOps<4>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap8");
+    if (clipEmpty()) return;
     lcdint_t xb1 = 0;
     lcdint_t yb1 = 0;
     lcdint_t xb2 = (lcdint_t)w - 1;
@@ -740,28 +1088,28 @@ void NanoCanvasOps<4>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + xb2;
     lcdint_t y2 = y1 + yb2;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        xb1 -= x1;
-        x1 = 0;
+        xb1 += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        yb1 -= y1;
-        y1 = 0;
+        yb1 += m_clip.p1.y - y1;
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         yb2 -= (y2 - (lcdint_t)m_h + 1);
-         y2 = (lcdint_t)m_h - 1;
+         yb2 -= (y2 - m_clip.p2.y);
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         xb2 -= (x2 - (lcdint_t)m_w + 1);
-         x2 = (lcdint_t)m_w - 1;
+         xb2 -= (x2 - m_clip.p2.x);
+         x2 = m_clip.p2.x;
     }
     for ( lcdint_t y = y1; y <= y2; y++ )
     {
@@ -783,6 +1131,7 @@ void NanoCanvasOps<4>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
 template <>
 void NanoCanvasOps<4>::clear()
 {
+    SSD1306_TRACE_SCOPE("canvas", "clear");
     memset(m_buf, 0, YADDR4(m_h));
 }
 
@@ -794,6 +1143,8 @@ void NanoCanvasOps<4>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clip.setRect(0, 0, w - 1, h - 1);
+    m_clipDepth = 0;
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFF; // white color by default
@@ -834,7 +1185,7 @@ void NanoCanvasOps<8>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    if ((x >= m_clip.p1.x) && (y >= m_clip.p1.y) && (x <= m_clip.p2.x) && (y <= m_clip.p2.y))
     {
         m_buf[YADDR8(y) + x] = m_color;
     }
@@ -843,6 +1194,7 @@ void NanoCanvasOps<8>::putPixel(lcdint_t x, lcdint_t y)
 template <>
 void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
@@ -850,11 +1202,11 @@ void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
+    if ((x1 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1,m_clip.p1.y);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    y2 = min(y2,m_clip.p2.y) - y1;
     do
     {
         *buf = m_color;
@@ -866,6 +1218,7 @@ void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 template <>
 void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     x2 -= offset.x;
@@ -873,10 +1226,10 @@ void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y1 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
     for (lcdint_t x = 0; x <= x2 - x1; x++)
     {
@@ -888,6 +1241,8 @@ void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 template <>
 void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "fillRect");
+    if (clipEmpty()) return;
     if (y1 > y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
@@ -900,12 +1255,12 @@ void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
+    y1 = max(y1,m_clip.p1.y);
+    y2 = min(y2,m_clip.p2.y);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
     for (lcdint_t y = y1; y <= y2; y++)
     {
@@ -921,6 +1276,8 @@ void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
 template <>
 void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap1");
+    if (clipEmpty()) return;
     uint8_t offs = 0;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
@@ -928,27 +1285,27 @@ void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) >> 3) * w;
+        offs = ((m_clip.p1.y - y1) & 0x07);
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
     uint8_t offs2 = 8 - offs;
     lcdint_t y = y1;
@@ -978,38 +1335,40 @@ void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
 template <>
 void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawXBitmap1");
+    if (clipEmpty()) return;
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x)  return;
 
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
-    if (y < 0)
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
 
     for(lcduint_t j = 0; j < h; j++)
     {
@@ -1044,32 +1403,34 @@ void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint
 template <>
 void NanoCanvasOps<8>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap8");
+    if (clipEmpty()) return;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
     lcdint_t y1 = ypos - offset.y;
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
+        bitmap += (lcduint_t)(m_clip.p1.y - y1) * w;
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
     lcdint_t y = y1;
     while ( y <= y2 )
@@ -1088,9 +1449,137 @@ void NanoCanvasOps<8>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     }
 }
 
+/* Blends 4 RGB332 pixels, packed to 32-bit word, with 0-32 alpha. Each byte lane keeps *
+ * single color component of the pixel, so products never overflow to the next lane. */
+static inline uint32_t blend332x4(uint32_t dst, uint32_t src, uint8_t alpha)
+{
+    uint8_t beta = 32 - alpha;
+    uint32_t r = ((src >> 5) & 0x07070707UL) * alpha + ((dst >> 5) & 0x07070707UL) * beta + 0x10101010UL;
+    uint32_t g = ((src >> 2) & 0x07070707UL) * alpha + ((dst >> 2) & 0x07070707UL) * beta + 0x10101010UL;
+    uint32_t b = (src & 0x03030303UL) * alpha + (dst & 0x03030303UL) * beta + 0x10101010UL;
+    return (((r >> 5) & 0x07070707UL) << 5) | (((g >> 5) & 0x07070707UL) << 2) | ((b >> 5) & 0x03030303UL);
+}
+
+/* Blends single RGB332 pixel with 0-32 alpha. Components are spread to byte lanes of 32-bit *
+ * word, so all of them are blended with two multiplications.                               */
+static inline uint8_t blend332(uint8_t dst, uint8_t src, uint8_t alpha)
+{
+    uint32_t d = (dst & 0x03) | ((uint32_t)(dst & 0x1C) << 6) | ((uint32_t)(dst & 0xE0) << 11);
+    uint32_t s = (src & 0x03) | ((uint32_t)(src & 0x1C) << 6) | ((uint32_t)(src & 0xE0) << 11);
+    uint32_t x = (s * alpha + d * (32 - alpha) + 0x00101010UL) >> 5;
+    return (x & 0x03) | ((x >> 6) & 0x1C) | ((x >> 11) & 0xE0);
+}
+
+/* Blends row of pixels with the image row or with the color, if src is nullptr */
+static void blendRow8(uint8_t *dst, const uint8_t *src, uint8_t color, lcduint_t len, uint8_t alpha)
+{
+    uint32_t s = color * 0x01010101UL;
+    for (; len >= 4; len -= 4, dst += 4)
+    {
+        uint32_t d;
+        memcpy(&d, dst, 4);
+        if ( src )
+        {
+            memcpy(&s, src, 4);
+            src += 4;
+        }
+        d = blend332x4(d, s, alpha);
+        memcpy(dst, &d, 4);
+    }
+    for (; len; len--, dst++)
+    {
+        *dst = blend332(*dst, src ? *src++ : color, alpha);
+    }
+}
+
+/* Blends row of pixels using alpha map. Groups of 4 fully transparent or opaque *
+ * pixels, typical for masks, are processed as single word.                      */
+static void blendMapRow8(uint8_t *dst, const uint8_t *src, uint8_t color, const uint8_t *alpha, lcduint_t len)
+{
+    for (; len >= 4; len -= 4, dst += 4, alpha += 4)
+    {
+        uint32_t a;
+        memcpy(&a, alpha, 4);
+        if ( a == 0xFFFFFFFFUL )
+        {
+            if ( src ) memcpy(dst, src, 4); else memset(dst, color, 4);
+        }
+        else if ( a )
+        {
+            for (uint8_t i = 0; i < 4; i++)
+            {
+                dst[i] = blend332(dst[i], src ? src[i] : color, alpha5(alpha[i]));
+            }
+        }
+        if ( src ) src += 4;
+    }
+    for (; len; len--, dst++, alpha++)
+    {
+        uint8_t s = src ? *src++ : color;
+        *dst = blend332(*dst, s, alpha5(*alpha));
+    }
+}
+
+template <>
+void NanoCanvasOps<8>::fillRectAlpha(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "fillRectAlpha");
+    uint8_t a = alpha5(alpha);
+    if ( a == 32 )
+    {
+        fillRect(x1, y1, x2, y2);
+        return;
+    }
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    lcduint_t w = x2 - x1 + 1;
+    lcduint_t h = y2 - y1 + 1;
+    lcduint_t sx, sy;
+    if ( !a || !clipBlock(x1, y1, w, h, sx, sy) ) return;
+    uint8_t *dst = m_buf + YADDR8(y1) + x1;
+    for (lcduint_t j = 0; j < h; j++, dst += m_w)
+    {
+        blendRow8(dst, nullptr, m_color, w, a);
+    }
+}
+
+template <>
+void NanoCanvasOps<8>::drawBufferAlpha(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, uint8_t alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "drawBufferAlpha");
+    uint8_t a = alpha5(alpha);
+    lcduint_t pitch = w;
+    lcduint_t sx, sy;
+    if ( !a || !clipBlock(x, y, w, h, sx, sy) ) return;
+    const uint8_t *src = buffer + sy * pitch + sx;
+    uint8_t *dst = m_buf + YADDR8(y) + x;
+    for (lcduint_t j = 0; j < h; j++, dst += m_w, src += pitch)
+    {
+        if ( a == 32 ) memcpy(dst, src, w); else blendRow8(dst, src, 0, w, a);
+    }
+}
+
+template <>
+void NanoCanvasOps<8>::drawBufferAlphaMap(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, const uint8_t *alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "drawBufferAlphaMap");
+    lcduint_t pitch = w;
+    lcduint_t sx, sy;
+    if ( !clipBlock(x, y, w, h, sx, sy) ) return;
+    const uint8_t *src = buffer ? buffer + sy * pitch + sx : nullptr;
+    alpha += sy * pitch + sx;
+    uint8_t *dst = m_buf + YADDR8(y) + x;
+    for (lcduint_t j = 0; j < h; j++, dst += m_w, alpha += pitch)
+    {
+        blendMapRow8(dst, src, m_color, alpha, w);
+        if ( src ) src += pitch;
+    }
+}
+
 template <>
 void NanoCanvasOps<8u>::clear()
 {
+    SSD1306_TRACE_SCOPE("canvas", "clear");
     memset(m_buf, 0, YADDR8(m_h));
 }
 
@@ -1102,6 +1591,8 @@ void NanoCanvasOps<8>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clip.setRect(0, 0, w - 1, h - 1);
+    m_clipDepth = 0;
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFF; // white color by default
@@ -1149,7 +1640,7 @@ void NanoCanvasOps<16>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    if ((x >= m_clip.p1.x) && (y >= m_clip.p1.y) && (x <= m_clip.p2.x) && (y <= m_clip.p2.y))
     {
         m_buf[YADDR16(y) + (x<<1)] = m_color >> 8;
         m_buf[YADDR16(y) + (x<<1) + 1] = m_color & 0xFF;
@@ -1159,6 +1650,7 @@ void NanoCanvasOps<16>::putPixel(lcdint_t x, lcdint_t y)
 template <>
 void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
@@ -1166,11 +1658,11 @@ void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
+    if ((x1 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1,m_clip.p1.y);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1 << 1);
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    y2 = min(y2,m_clip.p2.y) - y1;
     do
     {
         buf[0] = m_color >> 8;
@@ -1183,6 +1675,7 @@ void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 template <>
 void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (clipEmpty()) return;
     x1 -= offset.x;
     y1 -= offset.y;
     x2 -= offset.x;
@@ -1190,10 +1683,10 @@ void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y1 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
     for (lcdint_t x = 0; x <= x2 - x1; x++)
     {
@@ -1206,6 +1699,8 @@ void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 template <>
 void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    SSD1306_TRACE_SCOPE("canvas", "fillRect");
+    if (clipEmpty()) return;
     if (y1 > y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
@@ -1218,12 +1713,12 @@ void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1,m_clip.p1.x);
+    x2 = min(x2,m_clip.p2.x);
+    y1 = max(y1,m_clip.p1.y);
+    y2 = min(y2,m_clip.p2.y);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
     for (lcdint_t y = y1; y <= y2; y++)
     {
@@ -1240,6 +1735,8 @@ void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
 template <>
 void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap1");
+    if (clipEmpty()) return;
     uint8_t offs = 0;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
@@ -1247,27 +1744,27 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) >> 3) * w;
+        offs = ((m_clip.p1.y - y1) & 0x07);
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
     uint8_t offs2 = 8 - offs;
     lcdint_t y = y1;
@@ -1303,38 +1800,40 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
 template <>
 void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawXBitmap1");
+    if (clipEmpty()) return;
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x)  return;
 
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
-    if (y < 0)
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
 
     for(lcduint_t j = 0; j < h; j++)
     {
@@ -1371,32 +1870,34 @@ void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduin
 template <>
 void NanoCanvasOps<16>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    SSD1306_TRACE_SCOPE("canvas", "drawBitmap8");
+    if (clipEmpty()) return;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
     lcdint_t y1 = ypos - offset.y;
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
+        bitmap += (lcduint_t)(m_clip.p1.y - y1) * w;
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
     lcdint_t y = y1;
     while ( y <= y2 )
@@ -1418,9 +1919,120 @@ void NanoCanvasOps<16>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
     }
 }
 
+/* Spreads RGB565 pixel to 32-bit word, leaving 5-6 free bits above each component */
+static inline uint32_t spread565(uint16_t color)
+{
+    return (color | ((uint32_t)color << 16)) & 0x07E0F81FUL;
+}
+
+/* Blends RGB565 pixel with spread source pixel, already multiplied by alpha and rounded. *
+ * All components are blended with single multiplication.                               */
+static inline uint16_t blend565(uint16_t dst, uint32_t src, uint8_t beta)
+{
+    uint32_t x = ((spread565(dst) * beta + src) >> 5) & 0x07E0F81FUL;
+    return (uint16_t)(x | (x >> 16));
+}
+
+/* Rounding constant for each component of spread RGB565 pixel */
+static const uint32_t ROUND565 = 0x02008010UL;
+
+/* Blends row of MSB first pixels with the image row or with the color, if src is nullptr */
+static void blendRow16(uint8_t *dst, const uint8_t *src, uint16_t color, lcduint_t len, uint8_t alpha)
+{
+    uint8_t beta = 32 - alpha;
+    uint32_t s = spread565(color) * alpha + ROUND565;
+    for (; len; len--, dst += 2)
+    {
+        if ( src )
+        {
+            s = spread565(((uint16_t)src[0] << 8) | src[1]) * alpha + ROUND565;
+            src += 2;
+        }
+        uint16_t c = blend565(((uint16_t)dst[0] << 8) | dst[1], s, beta);
+        dst[0] = c >> 8;
+        dst[1] = c & 0xFF;
+    }
+}
+
+/* Blends row of MSB first pixels using alpha map */
+static void blendMapRow16(uint8_t *dst, const uint8_t *src, uint16_t color, const uint8_t *alpha, lcduint_t len)
+{
+    uint32_t c = spread565(color);
+    for (; len; len--, dst += 2, alpha++)
+    {
+        if ( src )
+        {
+            c = spread565(((uint16_t)src[0] << 8) | src[1]);
+            src += 2;
+        }
+        uint8_t a = alpha5(*alpha);
+        if ( !a ) continue;
+        uint16_t p = blend565(((uint16_t)dst[0] << 8) | dst[1], c * a + ROUND565, 32 - a);
+        dst[0] = p >> 8;
+        dst[1] = p & 0xFF;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::fillRectAlpha(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "fillRectAlpha");
+    uint8_t a = alpha5(alpha);
+    if ( a == 32 )
+    {
+        fillRect(x1, y1, x2, y2);
+        return;
+    }
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    lcduint_t w = x2 - x1 + 1;
+    lcduint_t h = y2 - y1 + 1;
+    lcduint_t sx, sy;
+    if ( !a || !clipBlock(x1, y1, w, h, sx, sy) ) return;
+    uint8_t *dst = m_buf + YADDR16(y1) + (x1<<1);
+    for (lcduint_t j = 0; j < h; j++, dst += (m_w<<1))
+    {
+        blendRow16(dst, nullptr, m_color, w, a);
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawBufferAlpha(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, uint8_t alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "drawBufferAlpha");
+    uint8_t a = alpha5(alpha);
+    lcduint_t pitch = w << 1;
+    lcduint_t sx, sy;
+    if ( !a || !clipBlock(x, y, w, h, sx, sy) ) return;
+    const uint8_t *src = buffer + sy * pitch + (sx<<1);
+    uint8_t *dst = m_buf + YADDR16(y) + (x<<1);
+    for (lcduint_t j = 0; j < h; j++, dst += (m_w<<1), src += pitch)
+    {
+        if ( a == 32 ) memcpy(dst, src, w << 1); else blendRow16(dst, src, 0, w, a);
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawBufferAlphaMap(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, const uint8_t *alpha)
+{
+    SSD1306_TRACE_SCOPE("canvas", "drawBufferAlphaMap");
+    lcduint_t pitch = w;
+    lcduint_t sx, sy;
+    if ( !clipBlock(x, y, w, h, sx, sy) ) return;
+    const uint8_t *src = buffer ? buffer + ((sy * pitch + sx) << 1) : nullptr;
+    alpha += sy * pitch + sx;
+    uint8_t *dst = m_buf + YADDR16(y) + (x<<1);
+    for (lcduint_t j = 0; j < h; j++, dst += (m_w<<1), alpha += pitch)
+    {
+        blendMapRow16(dst, src, m_color, alpha, w);
+        if ( src ) src += pitch << 1;
+    }
+}
+
 template <>
 void NanoCanvasOps<16>::clear()
 {
+    SSD1306_TRACE_SCOPE("canvas", "clear");
     memset(m_buf, 0, YADDR16(m_h));
 }
 
@@ -1431,6 +2043,8 @@ void NanoCanvasOps<16>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clip.setRect(0, 0, w - 1, h - 1);
+    m_clipDepth = 0;
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFFFF; // white color by default
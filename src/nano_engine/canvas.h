@@ -40,6 +40,11 @@
  * @{
  */
 
+#ifndef NANO_CANVAS_CLIP_DEPTH
+/** Maximum number of nested clip rectangles, see NanoCanvasOps::pushClipRect() */
+#define NANO_CANVAS_CLIP_DEPTH   4
+#endif
+
 enum
 {
     CANVAS_MODE_BASIC           = 0x00,
@@ -51,6 +56,56 @@ enum
     CANVAS_TEXT_WRAP_LOCAL      = 0x04,
 };
 
+/**
+ * NanoGlyphCache keeps font glyphs, expanded to the pixel format of 8-bit or
+ * 16-bit canvas. Expanded glyphs are copied to canvas row by row instead of
+ * decoding font bits for each pixel. The cache works in the memory buffer,
+ * provided by the application, and never allocates memory itself. If the
+ * buffer is too small for the active font, canvas falls back to drawBitmap1().
+ */
+class NanoGlyphCache
+{
+public:
+    /**
+     * Creates glyph cache object.
+     *
+     * @param buffer - memory buffer to store expanded glyphs in
+     * @param size - size of the buffer in bytes
+     *
+     * @note Each glyph requires (font width * font height * bytes per pixel)
+     *       bytes plus one pointer for the tag.
+     */
+    NanoGlyphCache(uint8_t *buffer, uint16_t size);
+
+    /**
+     * Drops all cached glyphs.
+     */
+    void reset();
+
+    /**
+     * Returns slot for the glyph. If the glyph is not cached yet, the slot is
+     * assigned to the glyph, and the caller must fill it with pixels.
+     *
+     * @param unicode - unicode of the glyph
+     * @param glyph - pointer to font glyph data, used as a tag
+     * @param slotSize - size of single slot in bytes
+     * @param color - color glyph is expanded with
+     * @param cached - set to true, if slot already contains the glyph
+     * @return pointer to slot data or nullptr if the buffer is too small
+     */
+    uint8_t *find(uint16_t unicode, const uint8_t *glyph, uint16_t slotSize,
+                  uint16_t color, bool &cached);
+
+private:
+    uint8_t *m_buffer;
+    uint16_t m_size;
+    const uint8_t **m_tags;
+    uint8_t *m_data;
+    uint16_t m_count;
+    uint16_t m_slotSize;
+    uint16_t m_color;
+};
+
 /**
  * NanoCanvasOps provides operations for drawing in memory buffer.
  * Depending on BPP argument, this class can work with 1,8,16-bit canvas areas.
@@ -126,6 +181,58 @@ public:
         return { offset, offsetEnd() };
     }
 
+    /**
+     * Returns width of canvas in pixels
+     */
+    lcduint_t width() const { return m_w; }
+
+    /**
+     * Returns height of canvas in pixels
+     */
+    lcduint_t height() const { return m_h; }
+
+    /**
+     * Returns pointer to canvas pixels buffer
+     */
+    uint8_t *getData() { return m_buf; }
+
+    /**
+     * Limits output of all drawing operations to intersection of specified rectangle
+     * and current clip area. Previous clip area is restored by popClipRect(), so
+     * nested widgets can be drawn without overdraw. Clip rectangle is calculated
+     * using offset, active at the moment of the call, so offset must not be changed
+     * until popClipRect() is called.
+     *
+     * @param rect - clip rectangle in offset terms
+     * @return false if NANO_CANVAS_CLIP_DEPTH clip areas are already pushed. Clip area
+     *         is not changed in this case, and popClipRect() must not be called.
+     */
+    bool pushClipRect(const NanoRect &rect);
+
+    /**
+     * Restores clip area, active before the last pushClipRect() call.
+     */
+    void popClipRect();
+
+    /**
+     * Returns current clip area in offset terms. Clip area is always inside rect().
+     * If right-bottom point is less than left-top point, nothing is drawn.
+     */
+    const NanoRect clipRect() const
+    {
+        return { m_clip.p1 + offset, m_clip.p2 + offset };
+    }
+
+    /**
+     * Returns true if any part of specified rectangle is inside clip area.
+     * Widgets can use it to skip preparing output, which is not visible.
+     * @param rect - rectangle in offset terms
+     */
+    bool isVisible(const NanoRect &rect) const
+    {
+        return !clipEmpty() && clipRect().collision(rect);
+    }
+
     /**
      * Draws pixel on specified position
      * @param x - position X
@@ -210,6 +317,54 @@ public:
      */
     void fillRect(const NanoRect &rect);
 
+    /**
+     * Blends rectangle area with color, set via setColor(). Canvases with less than
+     * 8 bits per pixel do not support blending: they fill the area if alpha is 128 or more.
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @param alpha - opacity of the color: 0 doesn't change canvas, 255 is the same as fillRect()
+     */
+    void fillRectAlpha(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t alpha);
+
+    /**
+     * Blends rectangle area with color, set via setColor()
+     * @param rect - structure, describing rectangle area
+     * @param alpha - opacity of the color: 0 doesn't change canvas, 255 is the same as fillRect()
+     */
+    void fillRectAlpha(const NanoRect &rect, uint8_t alpha);
+
+    /**
+     * Blends image with canvas content using the same opacity for all pixels.
+     * Image must be in canvas pixel format: RGB332 for 8-bit canvas, RGB565 (MSB first)
+     * for 16-bit canvas, so the buffer of other canvas of the same type can be used.
+     * Supported only by 8-bit and 16-bit canvases.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param buffer - image data, located in RAM
+     * @param alpha - opacity of the image: 0 doesn't change canvas, 255 copies the image
+     */
+    void drawBufferAlpha(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, uint8_t alpha);
+
+    /**
+     * Blends image with canvas content using opacity of each pixel from alpha map.
+     * Image must be in canvas pixel format (see drawBufferAlpha()). If image is nullptr,
+     * color, set via setColor(), is blended, that allows to draw antialiased shapes and shadows.
+     * Supported only by 8-bit and 16-bit canvases.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param buffer - image data, located in RAM, or nullptr
+     * @param alpha - w * h bytes of opacity values (0 - 255), located in RAM
+     */
+    void drawBufferAlphaMap(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, const uint8_t *alpha);
+
     /**
      * @brief Draws monochrome bitmap in color buffer using color, specified via setColor() method
      * Draws monochrome bitmap in color buffer using color, specified via setColor() method
@@ -243,6 +398,8 @@ public:
      *       In non-transparent mode, when black color is selected, the monochrome image just inverted.
      *       In transparent mode, those pixels of source monochrome image, which are black, do not overwrite pixels
      *       in the screen buffer.
+     *       In non-transparent mode pixels of unset bits are cleared to the background, so the
+     *       whole w x h area is overwritten.
      */
     void drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
@@ -259,6 +416,7 @@ public:
 
     /**
      * Clears canvas
+     * @note Clip area is ignored, the whole canvas is cleared.
      */
     void clear();
 
@@ -275,6 +433,16 @@ public:
      */
     uint8_t printChar(uint8_t c);
 
+    /**
+     * Draws glyph of active font at specified position. Glyph cache is used, if it is set.
+     * The function allows to draw text, prepared by NanoTextLayout, without font lookups.
+     * @param x - position X
+     * @param y - position Y
+     * @param unicode - unicode of the glyph
+     * @param info - glyph data, returned by ssd1306_getCharBitmap()
+     */
+    void drawGlyph(lcdint_t x, lcdint_t y, uint16_t unicode, const SCharInfo &info);
+
     /**
      * Print text at specified position to canvas
      *
@@ -312,6 +480,14 @@ public:
      */
     void setColor(uint16_t color) { m_color = color; };
 
+    /**
+     * Attaches glyph cache to the canvas. Text output of 8-bit and 16-bit
+     * canvases uses cached glyphs if the cache is set. Other canvases ignore it.
+     * The same cache object can be shared by several canvases of the same type.
+     * @param cache - pointer to glyph cache or nullptr to disable caching
+     */
+    void setGlyphCache(NanoGlyphCache *cache) { m_glyphCache = cache; };
+
 protected:
     lcduint_t m_w;    ///< width of NanoCanvas area in pixels
     lcduint_t m_h;    ///< height of NanoCanvas area in pixels
@@ -322,6 +498,24 @@ protected:
     EFontStyle   m_fontStyle; ///< currently active font style
     uint8_t * m_buf;      ///< Canvas data
     uint16_t  m_color;    ///< current color for monochrome operations
+    NanoGlyphCache *m_glyphCache = nullptr; ///< optional cache of expanded glyphs
+    NanoRect  m_clip;     ///< current clip area in canvas coordinates
+    NanoRect  m_clipStack[NANO_CANVAS_CLIP_DEPTH]; ///< clip areas, saved by pushClipRect()
+    uint8_t   m_clipDepth = 0; ///< number of saved clip areas
+
+    /** Returns true if clip area has no pixels, and nothing can be drawn */
+    bool clipEmpty() const { return m_clip.p1.x > m_clip.p2.x; }
+
+    /**
+     * Clips block at specified position in offset terms to clip area.
+     * Position is converted to canvas coordinates, and the numbers of block columns
+     * and rows, skipped on the left and top sides, are returned via sx and sy.
+     * @return false if no part of the block is visible
+     */
+    bool clipBlock(lcdint_t &x, lcdint_t &y, lcduint_t &w, lcduint_t &h, lcduint_t &sx, lcduint_t &sy) const;
+
+private:
+    bool drawCachedGlyph(uint16_t unicode, const SCharInfo &info, lcdint_t x, lcdint_t y, bool transparent);
 };
 
 /**
@@ -405,6 +599,16 @@ public:
      * @param rect rectagle describing part of canvas to move to display.
      */
     void blt(const NanoRect &rect) override;
+
+    /**
+     * Draws canvas on the LCD display, rotated clockwise by multiple of 90 degrees.
+     * For 90 and 270 degrees canvas occupies m_h x m_w area on the display, and canvas
+     * width should be multiple of 8.
+     * @param x - horizontal position in pixels
+     * @param y - vertical position in pixels, must be multiple of 8
+     * @param rotation - 0, 1, 2 or 3 for 0, 90, 180 or 270 degrees
+     */
+    void bltRotated(lcdint_t x, lcdint_t y, uint8_t rotation);
 };
 
 /**
@@ -93,6 +93,11 @@ uint8_t NanoEngineInputs::arduboyButtons()
 
 const uint8_t * NanoEngineInputs::s_gpioKeypadPins;
 
+#if defined(CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE)
+/** Time in milliseconds, gpio key level must be stable to be accepted */
+static const uint16_t GPIO_KEYS_DEBOUNCE_MS = 20;
+#endif
+
 void NanoEngineInputs::connectGpioKeypad(const uint8_t * gpioKeys)
 {
     NanoEngineInputs::s_gpioKeypadPins = gpioKeys;
@@ -100,7 +105,21 @@ void NanoEngineInputs::connectGpioKeypad(const uint8_t * gpioKeys)
     sdl_set_gpio_keys(gpioKeys);
 #endif
     m_onButtons = gpioButtons;
+#if defined(CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE)
+    if ( ssd1306_platform_gpioEventsStart(gpioKeys, 6, GPIO_KEYS_DEBOUNCE_MS) == 0 )
+    {
+        m_onButtons = gpioEventButtons;
+    }
+#endif
+}
+
+#if defined(CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE)
+uint8_t NanoEngineInputs::gpioEventButtons()
+{
+    /* Bits of gpio events state follow pins order: Down, Left, Right, Up, A, B */
+    return ssd1306_platform_gpioEventsState();
 }
+#endif
 
 uint8_t NanoEngineInputs::gpioButtons()
 {
@@ -152,37 +171,114 @@ uint8_t NanoEngineInputs::ky40Buttons()
 
 /** Defaut frame rate for all engines */
 static const uint8_t ENGINE_DEFAULT_FPS = 30;
+/** Maximum number of frames, rendered back-to-back in FRAME_POLICY_CATCHUP mode */
+static const uint8_t ENGINE_MAX_CATCHUP_FRAMES = 4;
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+#define NANO_ENGINE_SLEEP_AVAILABLE
+static void engineSleep(uint32_t us)
+{
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+}
+#elif defined(SSD1306_ESP_PLATFORM)
+#define NANO_ENGINE_SLEEP_AVAILABLE
+static void engineSleep(uint32_t us)
+{
+    /* Sleep only whole milliseconds via vTaskDelay(), the rest is polled */
+    if (us >= 1000) delay(us / 1000);
+}
+#endif
 
-/** Duration between frames in milliseconds */
-uint8_t   NanoEngineCore::m_frameDurationMs = 1000/ENGINE_DEFAULT_FPS;
+/** Duration between frames in microseconds */
+uint32_t  NanoEngineCore::m_frameDurationUs = 1000000/ENGINE_DEFAULT_FPS;
 /** Current fps */
 uint8_t   NanoEngineCore::m_fps = ENGINE_DEFAULT_FPS;
 /** Current cpu load in percents */
 uint8_t   NanoEngineCore::m_cpuLoad = 0;
-/** Last timestamp in milliseconds the frame was updated on oled display */
+/** Frame scheduling policy */
+uint8_t   NanoEngineCore::m_framePolicy = FRAME_POLICY_SKIP;
+/** Number of dropped frames */
+uint16_t  NanoEngineCore::m_skippedFrames = 0;
+/** Timestamp in microseconds, the last frame was started at */
 uint32_t  NanoEngineCore::m_lastFrameTs;
+/** Timestamp in microseconds, the next frame must be started at */
+uint32_t  NanoEngineCore::m_nextFrameTs;
+/** Phase timing of the last frame */
+NanoEngineFrameTiming NanoEngineCore::m_timing = { 0, 0, 0 };
 /** Callback to call before starting oled update */
 TLoopCallback NanoEngineCore::m_loop = nullptr;
 
 
 void NanoEngineCore::begin()
 {
-    m_lastFrameTs = millis();
+    m_lastFrameTs = micros();
+    m_nextFrameTs = m_lastFrameTs;
+    m_skippedFrames = 0;
 }
 
 void NanoEngineCore::setFrameRate(uint8_t fps)
 {
     if ( fps > 0 )
     {
-        m_fps = fps;
-        m_frameDurationMs = 1000/fps;
+        setFrameDuration(1000000UL/fps);
+    }
+}
+
+void NanoEngineCore::setFrameDuration(uint32_t us)
+{
+    if ( us > 0 )
+    {
+        m_frameDurationUs = us;
+        m_fps = us > 1000000UL ? 1 : (us < 1000000UL/255 ? 255 : (1000000UL + us/2) / us);
+        m_nextFrameTs = m_lastFrameTs + us;
     }
 }
 
 bool NanoEngineCore::nextFrame()
 {
-    bool needUpdate = (uint32_t)(millis() - m_lastFrameTs) >= m_frameDurationMs;
-    if (needUpdate && m_loop) m_loop();
-    return needUpdate;
+    uint32_t ts = micros();
+    int32_t wait = (int32_t)(m_nextFrameTs - ts);
+    if ( wait > 0 )
+    {
+#ifdef NANO_ENGINE_SLEEP_AVAILABLE
+        engineSleep(wait);
+        ts = micros();
+        if ( (int32_t)(m_nextFrameTs - ts) > 0 )
+        {
+            return false;
+        }
+#else
+        return false;
+#endif
+    }
+    /* Frame is due: schedule the next one */
+    uint32_t late = ts - m_nextFrameTs;
+    m_nextFrameTs += m_frameDurationUs;
+    if ( late >= m_frameDurationUs )
+    {
+        uint32_t missed = late / m_frameDurationUs;
+        if ( m_framePolicy == FRAME_POLICY_CATCHUP && missed <= ENGINE_MAX_CATCHUP_FRAMES )
+        {
+            missed = 0;
+        }
+        m_nextFrameTs += missed * m_frameDurationUs;
+        m_skippedFrames += missed;
+    }
+    m_lastFrameTs = ts;
+    if (m_loop) m_loop();
+    return true;
 }
 
+void NanoEngineCore::endFrame(uint32_t displayTs, uint32_t busTime)
+{
+    uint32_t ts = micros();
+    m_timing.update = displayTs - m_lastFrameTs;
+    m_timing.bus = busTime;
+    m_timing.draw = ts - displayTs - busTime;
+    uint32_t elapsed = ts - m_lastFrameTs;
+    /* Limit elapsed time to 255% of frame to avoid overflow */
+    m_cpuLoad = elapsed >= (m_frameDurationUs / 100) * 255 ? 255 : (elapsed * 100) / m_frameDurationUs;
+}
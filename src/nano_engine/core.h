@@ -31,6 +31,7 @@
 
 #include "tiler.h"
 #include "canvas.h"
+#include "ssd1306_trace.h"
 
 /**
  * @ingroup NANO_ENGINE_API
@@ -137,6 +138,8 @@ public:
      * Down, Left, Right, Up, A, B. If you don't want to use some specific button,
      * then just set not used button to 0.
      * Once you call this function, you can read buttons state via buttonsState().
+     * On Linux the pins are watched for edge interrupts by background thread
+     * and debounced there, so buttonsState() doesn't access gpio at all.
      *
      * @param gpioKeys pointer to 6-button pins array.
      *
@@ -157,6 +160,9 @@ private:
     static uint8_t zkeypadButtons();
     static uint8_t arduboyButtons();
     static uint8_t gpioButtons();
+#if defined(CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE)
+    static uint8_t gpioEventButtons();
+#endif
     static uint8_t ky40Buttons();
 };
 
@@ -165,6 +171,28 @@ private:
 ////// NANO ENGINE CORE CLASS /////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+/** Frame scheduling policy, used when engine can't keep up with frame rate */
+enum
+{
+    /** Missed frames are dropped, next frame is aligned to frame rate grid */
+    FRAME_POLICY_SKIP    = 0,
+    /** Missed frames are rendered back-to-back, until engine catches up */
+    FRAME_POLICY_CATCHUP = 1,
+};
+
+/**
+ * Time in microseconds, spent by last frame in each phase
+ */
+typedef struct
+{
+    /** Time between frame start and display() call: game logic */
+    uint32_t update;
+    /** Time, spent by draw callbacks in display() */
+    uint32_t draw;
+    /** Time, spent to send tiles to display */
+    uint32_t bus;
+} NanoEngineFrameTiming;
+
 /**
  * Nano Engine Core class, contains generic frame-rate control functions
  */
@@ -184,12 +212,30 @@ public:
      * @param fps - frame rate to set between [1-255]
      */
     static void setFrameRate(uint8_t fps);
- 
+
+    /**
+     * Sets frame duration in microseconds. Use it to set fractional frame rates,
+     * for example, 29.97 fps is setFrameDuration(33367).
+     * @param us - duration of single frame in microseconds
+     */
+    static void setFrameDuration(uint32_t us);
+
     /**
      * Returns current frame rate
      */
     static uint8_t getFrameRate() { return m_fps; };
 
+    /**
+     * Returns duration of single frame in microseconds
+     */
+    static uint32_t getFrameDuration() { return m_frameDurationUs; };
+
+    /**
+     * Sets policy for the frames, missed when engine is overloaded.
+     * @param policy - FRAME_POLICY_SKIP (default) or FRAME_POLICY_CATCHUP
+     */
+    static void setFramePolicy(uint8_t policy) { m_framePolicy = policy; };
+
     /**
      * Returns cpu load in percents [0-255].
      * 100 means maximum normal CPU load.
@@ -199,7 +245,20 @@ public:
     static uint8_t getCpuLoad() { return m_cpuLoad; };
 
     /**
-     * Returns true if it is time to render next frame
+     * Returns time, spent by last frame in update, draw and bus phases.
+     */
+    static const NanoEngineFrameTiming &getFrameTiming() { return m_timing; };
+
+    /**
+     * Returns number of frames, dropped since begin() due to overload.
+     */
+    static uint16_t getSkippedFrames() { return m_skippedFrames; };
+
+    /**
+     * Returns true if it is time to render next frame.
+     * On Linux and ESP32 platforms the function sleeps till next frame
+     * deadline instead of returning false, so main loop doesn't consume cpu
+     * between frames.
      */
     static bool nextFrame();
 
@@ -211,16 +270,31 @@ public:
 
 protected:
 
-    /** Duration between frames in milliseconds */
-    static uint8_t   m_frameDurationMs;
+    /** Duration between frames in microseconds */
+    static uint32_t  m_frameDurationUs;
     /** Current fps */
     static uint8_t   m_fps;
     /** Current cpu load in percents */
     static uint8_t   m_cpuLoad;
-    /** Last timestamp in milliseconds the frame was updated on oled display */
+    /** Frame scheduling policy */
+    static uint8_t   m_framePolicy;
+    /** Number of dropped frames */
+    static uint16_t  m_skippedFrames;
+    /** Timestamp in microseconds, the last frame was started at */
     static uint32_t  m_lastFrameTs;
+    /** Timestamp in microseconds, the next frame must be started at */
+    static uint32_t  m_nextFrameTs;
+    /** Phase timing of the last frame */
+    static NanoEngineFrameTiming m_timing;
     /** Callback to call before starting oled update */
     static TLoopCallback m_loop;
+
+    /**
+     * Updates phase timing and cpu load at the end of the frame.
+     * @param displayTs - timestamp in microseconds, display() was called at
+     * @param busTime - time in microseconds, spent to send data to display
+     */
+    static void endFrame(uint32_t displayTs, uint32_t busTime);
 };
 
 /**
@@ -269,9 +343,10 @@ NanoEngine<C,W,H,B>::NanoEngine()
 template<class C, uint8_t W, uint8_t H, uint8_t B>
 void NanoEngine<C,W,H,B>::display()
 {
-    m_lastFrameTs = millis();
+    SSD1306_TRACE_SCOPE("engine", "display");
+    uint32_t ts = micros();
     NanoEngineTiler<C,W,H,B>::displayBuffer();
-    m_cpuLoad = ((millis() - m_lastFrameTs)*100)/m_frameDurationMs;
+    endFrame(ts, NanoEngineTiler<C,W,H,B>::m_bltTime);
 }
 
 template<class C, uint8_t W, uint8_t H, uint8_t B>
@@ -282,6 +357,9 @@ void NanoEngine<C,W,H,B>::begin()
     {
         ssd1306_setMode(LCD_MODE_NORMAL);
     }
+#if defined(CONFIG_NANO_ENGINE_TILE_HASH_ENABLE)
+    NanoEngineTiler<C,W,H,B>::invalidateTiles();
+#endif
 }
 
 template<class C, uint8_t W, uint8_t H, uint8_t B>
@@ -289,7 +367,7 @@ void NanoEngine<C,W,H,B>::notify(const char *str)
 {
     NanoEngineTiler<C,W,H,B>::displayPopup(str);
     delay(1000);
-    m_lastFrameTs = millis();
+    m_nextFrameTs = micros() + m_frameDurationUs;
     NanoEngineTiler<C,W,H,B>::refresh();
 }
 
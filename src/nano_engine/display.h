@@ -0,0 +1,800 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file display.h Compile-time specialized display drivers
+ */
+
+#ifndef _NANO_DISPLAY_H_
+#define _NANO_DISPLAY_H_
+
+#include "canvas.h"
+#include "ssd1306_hal/io.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/spi/ssd1306_spi.h"
+#include "intf/i2c/ssd1306_i2c_conf.h"
+#include "lcd/ssd1306_commands.h"
+#include "lcd/ssd1351_commands.h"
+#include "nano_gfx_types.h"
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__) && !defined(SDL_EMULATION)
+#define NANO_DISPLAY_LINUX_BUS
+#endif
+
+/**
+ * @defgroup NANO_DISPLAY_API NANO DISPLAY: Compile-time display drivers
+ * @{
+ *
+ * @brief Display drivers, resolved at compile time.
+ *
+ * @details Unlike C API, which calls display controller and communication interface
+ *          via ssd1306_lcd and ssd1306_intf function pointers, Display template
+ *          gets controller and interface as template arguments (policies).
+ *          This allows compiler to inline command encoding and data transfer into
+ *          hot loops of drawing functions. C API and global state are not affected,
+ *          so both APIs can be used in the same application.
+ *
+ *          @code{.cpp}
+ *          Display<Ssd1306<128,64>, LinuxI2c<1, 0x3C>> display;
+ *          NanoCanvas1 canvas(128, 64, buffer);
+ *
+ *          display.begin();
+ *          canvas.printFixed(0, 0, "Hello");
+ *          display.blt(canvas);
+ *          @endcode
+ *
+ *          Interface policy class must provide static methods: begin(), end(), isSpi(),
+ *          start(), stop(), send(), sendBuffer() and spiDataMode().
+ *          Controller policy class must provide WIDTH, HEIGHT, BITS_PER_PIXEL constants
+ *          and static templates: init<I>(), setBlock<I>(), nextPage<I>() and
+ *          pixel send functions, supported by the controller.
+ */
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             INTERFACES
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Interface policy, which uses ssd1306_intf configured via C API
+ * (ssd1306_i2cInit(), ssd1306_spiInit(), etc.). This policy works on
+ * all platforms, but doesn't eliminate runtime dispatch of interface calls.
+ */
+class DefaultInterface
+{
+public:
+    /** Does nothing, ssd1306_intf must be initialized by C API */
+    static inline void begin() { }
+    /** Closes ssd1306_intf */
+    static inline void end() { ssd1306_intf.close(); }
+    /** Returns true for spi interfaces */
+    static inline bool isSpi() { return ssd1306_intf.spi; }
+    /** Starts communication transaction */
+    static inline void start() { ssd1306_intf.start(); }
+    /** Completes communication transaction */
+    static inline void stop() { ssd1306_intf.stop(); }
+    /** Sends single byte */
+    static inline void send(uint8_t data) { ssd1306_intf.send(data); }
+    /** Sends buffer */
+    static inline void sendBuffer(const uint8_t *buffer, uint16_t size) { ssd1306_intf.send_buffer(buffer, size); }
+    /** Switches spi data/command mode */
+    static inline void spiDataMode(uint8_t mode) { ssd1306_spiDataMode(mode); }
+};
+
+#if defined(NANO_DISPLAY_LINUX_BUS)
+
+/**
+ * Linux i2c-dev interface policy. Bus is opened and written via Linux HAL
+ * functions, the policy only collects bytes of the transaction.
+ * @tparam BUS i2c bus number (/dev/i2c-BUS)
+ * @tparam SA i2c address of display controller
+ */
+template <uint8_t BUS = 1, uint8_t SA = SSD1306_SA>
+class LinuxI2c
+{
+public:
+    /** Opens i2c bus device */
+    static void begin()
+    {
+        s_fd = ssd1306_platform_i2cOpen(BUS, SA);
+    }
+
+    /** Closes i2c bus device */
+    static void end()
+    {
+        if (s_fd >= 0)
+        {
+            close(s_fd);
+            s_fd = -1;
+        }
+    }
+
+    /** Always false for i2c */
+    static inline bool isSpi() { return false; }
+
+    /** Starts i2c transaction */
+    static inline void start() { s_size = 0; }
+
+    /** Writes collected data to i2c bus */
+    static inline void stop()
+    {
+        ssd1306_platform_i2cWrite(s_fd, s_buffer, s_size);
+        s_size = 0;
+    }
+
+    /** Sends single byte */
+    static inline void send(uint8_t data)
+    {
+        s_buffer[s_size++] = data;
+        if (s_size == sizeof(s_buffer))
+        {
+            /* Restart transmission if internal buffer is full */
+            stop();
+            start();
+            send(0x40);
+        }
+    }
+
+    /** Sends buffer */
+    static inline void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        while (size--)
+        {
+            send(*buffer++);
+        }
+    }
+
+    /** i2c has no data/command pin */
+    static inline void spiDataMode(uint8_t mode) { }
+
+private:
+    static int s_fd;
+    static uint8_t s_buffer[128];
+    static uint8_t s_size;
+};
+
+template <uint8_t BUS, uint8_t SA> int LinuxI2c<BUS, SA>::s_fd = -1;
+template <uint8_t BUS, uint8_t SA> uint8_t LinuxI2c<BUS, SA>::s_buffer[128];
+template <uint8_t BUS, uint8_t SA> uint8_t LinuxI2c<BUS, SA>::s_size = 0;
+
+/**
+ * Linux spidev interface policy. Device is opened and written via Linux HAL
+ * functions, the policy only caches bytes between data/command switches.
+ * @tparam BUS spi bus number
+ * @tparam CES chip select number (/dev/spidevBUS.CES)
+ * @tparam DC gpio number of data/command pin
+ * @tparam FREQ spi clock frequency in Hz
+ */
+template <uint8_t BUS = 0, uint8_t CES = 0, int8_t DC = 24, uint32_t FREQ = 8000000>
+class LinuxSpi
+{
+public:
+    /** Opens and configures spidev device, configures data/command pin */
+    static void begin()
+    {
+        pinMode(DC, OUTPUT);
+        s_fd = ssd1306_platform_spiOpen(BUS, CES, FREQ);
+    }
+
+    /** Closes spidev device */
+    static void end()
+    {
+        if (s_fd >= 0)
+        {
+            close(s_fd);
+            s_fd = -1;
+        }
+    }
+
+    /** Always true for spi */
+    static inline bool isSpi() { return true; }
+
+    /** Starts spi transaction */
+    static inline void start() { s_size = 0; }
+
+    /** Sends all cached data */
+    static inline void stop() { flush(); }
+
+    /** Sends single byte */
+    static inline void send(uint8_t data)
+    {
+        s_cache[s_size++] = data;
+        if (s_size == sizeof(s_cache))
+        {
+            flush();
+        }
+    }
+
+    /** Sends buffer */
+    static inline void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        while (size)
+        {
+            uint16_t part = sizeof(s_cache) - s_size;
+            if (part > size)
+            {
+                part = size;
+            }
+            memcpy(&s_cache[s_size], buffer, part);
+            s_size += part;
+            buffer += part;
+            size -= part;
+            if (s_size == sizeof(s_cache))
+            {
+                flush();
+            }
+        }
+    }
+
+    /** Switches data/command pin, sending cached bytes first */
+    static inline void spiDataMode(uint8_t mode)
+    {
+        flush();
+        digitalWrite(DC, mode ? HIGH : LOW);
+    }
+
+private:
+    static int s_fd;
+    static uint8_t s_cache[1024];
+    static uint16_t s_size;
+
+    static void flush()
+    {
+        if ( s_size == 0 )
+        {
+            return;
+        }
+        ssd1306_platform_spiWrite(s_fd, s_cache, s_size);
+        s_size = 0;
+    }
+};
+
+template <uint8_t BUS, uint8_t CES, int8_t DC, uint32_t FREQ>
+int LinuxSpi<BUS, CES, DC, FREQ>::s_fd = -1;
+template <uint8_t BUS, uint8_t CES, int8_t DC, uint32_t FREQ>
+uint8_t LinuxSpi<BUS, CES, DC, FREQ>::s_cache[1024];
+template <uint8_t BUS, uint8_t CES, int8_t DC, uint32_t FREQ>
+uint16_t LinuxSpi<BUS, CES, DC, FREQ>::s_size = 0;
+
+#elif defined(SDL_EMULATION)
+
+/**
+ * i2c interface policy for SDL emulator.
+ */
+template <uint8_t BUS = 1, uint8_t SA = SSD1306_SA>
+class LinuxI2c
+{
+public:
+    static inline void begin() { sdl_core_init(); }
+    static inline void end() { sdl_core_close(); }
+    static inline bool isSpi() { return false; }
+    static inline void start() { sdl_send_init(); }
+    static inline void stop() { sdl_send_stop(); }
+    static inline void send(uint8_t data) { sdl_send_byte(data); }
+    static inline void sendBuffer(const uint8_t *buffer, uint16_t size) { while (size--) sdl_send_byte(*buffer++); }
+    static inline void spiDataMode(uint8_t mode) { }
+};
+
+/**
+ * spi interface policy for SDL emulator.
+ */
+template <uint8_t BUS = 0, uint8_t CES = 0, int8_t DC = 24, uint32_t FREQ = 8000000>
+class LinuxSpi
+{
+public:
+    static inline void begin() { sdl_core_init(); sdl_set_dc_pin(DC); }
+    static inline void end() { sdl_core_close(); }
+    static inline bool isSpi() { return true; }
+    static inline void start() { sdl_send_init(); }
+    static inline void stop() { sdl_send_stop(); }
+    static inline void send(uint8_t data) { sdl_send_byte(data); }
+    static inline void sendBuffer(const uint8_t *buffer, uint16_t size) { while (size--) sdl_send_byte(*buffer++); }
+    static inline void spiDataMode(uint8_t mode) { sdl_write_digital(DC, mode); }
+};
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             CONTROLLERS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Common command helpers for ssd1306-like controllers.
+ */
+class NanoControllerBase
+{
+public:
+    /** Starts command transaction */
+    template <class I>
+    static inline void commandStart()
+    {
+        I::start();
+        if (I::isSpi())
+            I::spiDataMode(0);
+        else
+            I::send(0x00);
+    }
+
+    /** Switches already started transaction from commands to data */
+    template <class I>
+    static inline void commandToData()
+    {
+        if (I::isSpi())
+        {
+            I::spiDataMode(1);
+        }
+        else
+        {
+            I::stop();
+            I::start();
+            I::send(0x40);
+        }
+    }
+
+    /** Sends command sequence, located in Flash */
+    template <class I>
+    static void sendCommands(const uint8_t *commands, uint8_t size)
+    {
+        commandStart<I>();
+        while (size--)
+        {
+            I::send(pgm_read_byte(commands++));
+        }
+        I::stop();
+    }
+};
+
+/**
+ * SSD1306 controller policy
+ * @tparam W width of display in pixels
+ * @tparam H height of display in pixels (32 or 64)
+ */
+template <lcduint_t W, lcduint_t H>
+class Ssd1306: public NanoControllerBase
+{
+public:
+    /** display width in pixels */
+    static const lcduint_t WIDTH = W;
+    /** display height in pixels */
+    static const lcduint_t HEIGHT = H;
+    /** bits per pixel, supported by the controller */
+    static const uint8_t BITS_PER_PIXEL = 1;
+
+    /** Initializes controller */
+    template <class I>
+    static void init()
+    {
+        static const uint8_t PROGMEM initData[] =
+        {
+#ifdef SDL_EMULATION
+            SDL_LCD_SSD1306,
+            0x00,
+#endif
+            SSD1306_DISPLAYOFF,
+            SSD1306_MEMORYMODE, HORIZONTAL_ADDRESSING_MODE,
+            SSD1306_COMSCANDEC,
+            SSD1306_SETSTARTLINE | 0x00,
+            SSD1306_SETCONTRAST, 0x7F,
+            SSD1306_SEGREMAP | 0x01,
+            SSD1306_NORMALDISPLAY,
+            SSD1306_SETMULTIPLEX, H - 1,
+            SSD1306_SETDISPLAYOFFSET, 0x00,
+            SSD1306_SETDISPLAYCLOCKDIV, 0x80,
+            SSD1306_SETPRECHARGE, 0x22,
+            SSD1306_SETCOMPINS, H == 64 ? 0x12 : 0x02,
+            SSD1306_SETVCOMDETECT, 0x20,
+            SSD1306_CHARGEPUMP, 0x14,
+            SSD1306_DISPLAYALLON_RESUME,
+            SSD1306_DISPLAYON,
+        };
+        sendCommands<I>(initData, sizeof(initData));
+    }
+
+    /**
+     * Opens GDRAM block for data transfer
+     * @param x column in pixels
+     * @param y page (pixels / 8)
+     * @param w width of block in pixels, 0 means up to right edge
+     */
+    template <class I>
+    static inline void setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+    {
+        commandStart<I>();
+        I::send(SSD1306_COLUMNADDR);
+        I::send(x);
+        I::send(w ? (x + w - 1) : (W - 1));
+        I::send(SSD1306_PAGEADDR);
+        I::send(y);
+        I::send((H >> 3) - 1);
+        commandToData<I>();
+    }
+
+    /** Moves to next page of the block. Not needed in horizontal addressing mode */
+    template <class I>
+    static inline void nextPage() { }
+
+    /** Sends buffer of vertical 8-pixel bytes */
+    template <class I>
+    static inline void sendPixelsBuffer1(const uint8_t *buffer, uint16_t len) { I::sendBuffer(buffer, len); }
+};
+
+/**
+ * SH1106 controller policy
+ * @tparam W width of display in pixels
+ * @tparam H height of display in pixels
+ */
+template <lcduint_t W, lcduint_t H>
+class Sh1106: public NanoControllerBase
+{
+public:
+    /** display width in pixels */
+    static const lcduint_t WIDTH = W;
+    /** display height in pixels */
+    static const lcduint_t HEIGHT = H;
+    /** bits per pixel, supported by the controller */
+    static const uint8_t BITS_PER_PIXEL = 1;
+
+    /** Initializes controller */
+    template <class I>
+    static void init()
+    {
+        static const uint8_t PROGMEM initData[] =
+        {
+#ifdef SDL_EMULATION
+            SDL_LCD_SH1106,
+            0x00,
+#endif
+            SSD1306_DISPLAYOFF,
+            SSD1306_COMSCANDEC,
+            SSD1306_SETSTARTLINE | 0x00,
+            SSD1306_SETCONTRAST, 0x7F,
+            SSD1306_SEGREMAP | 0x01,
+            SSD1306_NORMALDISPLAY,
+            SSD1306_SETMULTIPLEX, H - 1,
+            SSD1306_SETDISPLAYOFFSET, 0x00,
+            SSD1306_SETDISPLAYCLOCKDIV, 0x80,
+            SSD1306_SETPRECHARGE, 0x22,
+            SSD1306_SETCOMPINS, 0x12,
+            SSD1306_SETVCOMDETECT, 0x20,
+            SSD1306_CHARGEPUMP, 0x14,
+            SSD1306_DISPLAYALLON_RESUME,
+            SSD1306_DISPLAYON,
+        };
+        sendCommands<I>(initData, sizeof(initData));
+    }
+
+    /**
+     * Opens GDRAM block for data transfer
+     * @param x column in pixels
+     * @param y page (pixels / 8)
+     * @param w width of block in pixels, 0 means up to right edge
+     */
+    template <class I>
+    static inline void setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+    {
+        s_column = x;
+        s_page = y;
+        commandStart<I>();
+        I::send(SSD1306_SETPAGE | y);
+        I::send(((x+2)>>4) | SSD1306_SETHIGHCOLUMN);
+        I::send(((x+2) & 0x0f) | SSD1306_SETLOWCOLUMN);
+        commandToData<I>();
+    }
+
+    /** Moves to next page of the block */
+    template <class I>
+    static inline void nextPage()
+    {
+        I::stop();
+        setBlock<I>(s_column, s_page + 1, 0);
+    }
+
+    /** Sends buffer of vertical 8-pixel bytes */
+    template <class I>
+    static inline void sendPixelsBuffer1(const uint8_t *buffer, uint16_t len) { I::sendBuffer(buffer, len); }
+
+private:
+    static uint8_t s_column;
+    static uint8_t s_page;
+};
+
+template <lcduint_t W, lcduint_t H> uint8_t Sh1106<W, H>::s_column = 0;
+template <lcduint_t W, lcduint_t H> uint8_t Sh1106<W, H>::s_page = 0;
+
+/**
+ * SSD1351 controller policy (16-bit normal mode, spi only)
+ * @tparam W width of display in pixels
+ * @tparam H height of display in pixels
+ */
+template <lcduint_t W, lcduint_t H>
+class Ssd1351: public NanoControllerBase
+{
+public:
+    /** display width in pixels */
+    static const lcduint_t WIDTH = W;
+    /** display height in pixels */
+    static const lcduint_t HEIGHT = H;
+    /** bits per pixel, supported by the controller */
+    static const uint8_t BITS_PER_PIXEL = 16;
+
+    /** Initializes controller */
+    template <class I>
+    static void init()
+    {
+        static const uint8_t PROGMEM initData[] =
+        {
+#ifdef SDL_EMULATION
+            SDL_LCD_SSD1351,
+            0x00,
+#endif
+            SSD1351_UNLOCK, CMD_ARG, 0x12,
+            SSD1351_UNLOCK, CMD_ARG, 0xB1,
+            SSD1351_SLEEP_ON,
+            SSD1351_CLOCKDIV, CMD_ARG, 0xF1,
+            SSD1351_SETMULTIPLEX, CMD_ARG, H - 1,
+            SSD1351_SEGREMAP, CMD_ARG, 0B00110100,   // 16-bit rgb color mode, horizontal increment
+            SSD1351_SETSTARTLINE, CMD_ARG, 0x00,
+            SSD1351_SETDISPLAYOFFSET, CMD_ARG, 0x00,
+            SSD1351_SETGPIO, CMD_ARG, 0x00,
+            SSD1351_SETFUNCTION, CMD_ARG, 0x01,
+            SSD1351_SETPRECHARGE, CMD_ARG, 0x32,
+            SSD1351_VCOMH, CMD_ARG, 0x05,
+            SSD1351_PRECHARGELEVEL, CMD_ARG, 0x17,
+            SSD1351_NORMALDISPLAY,
+            SSD1351_CONTRAST, CMD_ARG, 0xC8, CMD_ARG, 0x80, CMD_ARG, 0xC8,
+            SSD1351_MASTERCURRENT, CMD_ARG, 0x0F,
+            SSD1351_EXTVSL, CMD_ARG, 0xA0, CMD_ARG, 0xB5, CMD_ARG, 0x55,
+            SSD1351_PRECHARGESECOND, CMD_ARG, 0x01,
+            SSD1351_SLEEP_OFF,
+            SSD1351_NORMALDISPLAY,
+        };
+        I::start();
+        I::spiDataMode(0);
+        for (uint8_t i = 0; i < sizeof(initData); i++)
+        {
+            uint8_t data = pgm_read_byte(&initData[i]);
+            if (data == CMD_ARG)
+            {
+                I::spiDataMode(1);
+                I::send(pgm_read_byte(&initData[++i]));
+                I::spiDataMode(0);
+            }
+            else
+            {
+                I::send(data);
+            }
+        }
+        I::stop();
+    }
+
+    /**
+     * Opens GDRAM block for data transfer
+     * @param x column in pixels
+     * @param y row in pixels
+     * @param w width of block in pixels, 0 means up to right edge
+     */
+    template <class I>
+    static inline void setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+    {
+        lcduint_t rx = w ? (x + w - 1) : (W - 1);
+        I::start();
+        I::spiDataMode(0);
+        I::send(SSD1351_COLUMNADDR);
+        I::spiDataMode(1);
+        I::send(x);
+        I::send(rx < W ? rx : (W - 1));
+        I::spiDataMode(0);
+        I::send(SSD1351_ROWADDR);
+        I::spiDataMode(1);
+        I::send(y);
+        I::send(H - 1);
+        I::spiDataMode(0);
+        I::send(SSD1331_WRITEDATA);
+        I::spiDataMode(1);
+    }
+
+    /** Not needed in normal mode */
+    template <class I>
+    static inline void nextPage() { }
+
+    /** Sends single RGB_COLOR8 pixel */
+    template <class I>
+    static inline void sendPixel8(uint8_t color)
+    {
+        uint16_t color16 = RGB8_TO_RGB16(color);
+        I::send( color16 >> 8 );
+        I::send( color16 & 0xFF );
+    }
+
+    /** Sends single RGB_COLOR16 pixel */
+    template <class I>
+    static inline void sendPixel16(uint16_t color)
+    {
+        I::send( color >> 8 );
+        I::send( color & 0xFF );
+    }
+
+    /** Sends buffer of RGB_COLOR16 pixels in display byte order */
+    template <class I>
+    static inline void sendPixelsBuffer16(const uint8_t *buffer, uint16_t len) { I::sendBuffer(buffer, len << 1); }
+
+private:
+    static const uint8_t CMD_ARG = 0xFF;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             DISPLAY
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Display with controller C, connected via interface I.
+ * All methods are resolved at compile time.
+ * @tparam C controller policy: Ssd1306, Sh1106, Ssd1351
+ * @tparam I interface policy: DefaultInterface, LinuxI2c, LinuxSpi
+ */
+template <class C, class I>
+class Display
+{
+public:
+    /** display width in pixels */
+    static const lcduint_t WIDTH = C::WIDTH;
+    /** display height in pixels */
+    static const lcduint_t HEIGHT = C::HEIGHT;
+    /** bits per pixel of display controller */
+    static const uint8_t BITS_PER_PIXEL = C::BITS_PER_PIXEL;
+
+    /** Initializes interface and display controller */
+    void begin()
+    {
+        I::begin();
+        C::template init<I>();
+    }
+
+    /** Closes interface */
+    void end()
+    {
+        I::end();
+    }
+
+    /**
+     * Draws 1-bit buffer in ssd1306 page format (see ssd1306_drawBufferFast()).
+     * @param x horizontal position in pixels
+     * @param y vertical position in pixels, must be multiple of 8
+     * @param w width in pixels
+     * @param h height in pixels, must be multiple of 8
+     * @param buf pointer to buffer
+     */
+    void drawBuffer1Fast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf)
+    {
+        C::template setBlock<I>(x, y >> 3, w);
+        for (lcduint_t j = (h >> 3); j > 0; j--)
+        {
+            C::template sendPixelsBuffer1<I>(buf, w);
+            buf += w;
+            C::template nextPage<I>();
+        }
+        I::stop();
+    }
+
+    /**
+     * Draws 8-bit buffer (see ssd1306_drawBufferFast8()).
+     * @param x horizontal position in pixels
+     * @param y vertical position in pixels
+     * @param w width in pixels
+     * @param h height in pixels
+     * @param buf pointer to buffer
+     */
+    void drawBuffer8Fast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf)
+    {
+        C::template setBlock<I>(x, y, w);
+        uint32_t count = (uint32_t)w * h;
+        while (count--)
+        {
+            C::template sendPixel8<I>(*buf++);
+        }
+        I::stop();
+    }
+
+    /**
+     * Draws 16-bit buffer (see ssd1306_drawBufferFast16()).
+     * @param x horizontal position in pixels
+     * @param y vertical position in pixels
+     * @param w width in pixels
+     * @param h height in pixels
+     * @param buf pointer to buffer
+     */
+    void drawBuffer16Fast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf)
+    {
+        C::template setBlock<I>(x, y, w);
+        while (h--)
+        {
+            C::template sendPixelsBuffer16<I>(buf, w);
+            buf += (w << 1);
+        }
+        I::stop();
+    }
+
+    /**
+     * Fills whole display with 16-bit color (color displays only).
+     * @param color RGB_COLOR16 color
+     */
+    void fill16(uint16_t color)
+    {
+        C::template setBlock<I>(0, 0, 0);
+        uint32_t count = (uint32_t)WIDTH * HEIGHT;
+        while (count--)
+        {
+            C::template sendPixel16<I>(color);
+        }
+        I::stop();
+    }
+
+    /**
+     * Fills whole monochrome display with pattern byte.
+     * @param pattern vertical 8-pixel pattern
+     */
+    void fill1(uint8_t pattern)
+    {
+        uint8_t line[16];
+        memset(line, pattern, sizeof(line));
+        C::template setBlock<I>(0, 0, 0);
+        for (lcduint_t page = 0; page < (HEIGHT >> 3); page++)
+        {
+            for (lcduint_t x = 0; x < WIDTH; x += sizeof(line))
+            {
+                C::template sendPixelsBuffer1<I>(line, WIDTH - x < sizeof(line) ? WIDTH - x : sizeof(line));
+            }
+            C::template nextPage<I>();
+        }
+        I::stop();
+    }
+
+    /** Draws 1-bit canvas at its offset position */
+    void blt(NanoCanvasOps<1> &canvas)
+    {
+        drawBuffer1Fast(canvas.offset.x, canvas.offset.y, canvas.width(), canvas.height(), canvas.getData());
+    }
+
+    /** Draws 8-bit canvas at its offset position */
+    void blt(NanoCanvasOps<8> &canvas)
+    {
+        drawBuffer8Fast(canvas.offset.x, canvas.offset.y, canvas.width(), canvas.height(), canvas.getData());
+    }
+
+    /** Draws 16-bit canvas at its offset position */
+    void blt(NanoCanvasOps<16> &canvas)
+    {
+        drawBuffer16Fast(canvas.offset.x, canvas.offset.y, canvas.width(), canvas.height(), canvas.getData());
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
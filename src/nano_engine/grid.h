@@ -0,0 +1,304 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file grid.h Spatial grid of engine objects for broad-phase collision detection
+ */
+
+#ifndef _NANO_GRID_H_
+#define _NANO_GRID_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * NanoObjectGrid keeps bounding rectangles of game objects in uniform grid with cells
+ * of engine tile size. Each object is linked to the cell of its top-left corner, so
+ * region queries and collision checks visit only objects in the cells around the region
+ * instead of all objects. Object is identified by its index [0, N-1], chosen by the
+ * application, for example, index of the brick in the level array.
+ *
+ * Inserting, moving and removing objects marks old and new bounds for refresh via
+ * refreshWorld() of the engine, so the application doesn't need to do it manually.
+ *
+ * The grid covers World area of COLS x ROWS tiles starting at (0,0). Objects outside
+ * the area are kept in border cells: they work correctly, but are checked more often.
+ *
+ * @code
+ * NanoEngine1 engine;
+ * // up to 64 objects on 128x64 World with 8x8 tiles
+ * NanoObjectGrid<NanoEngine1, engine, 64, 16, 8> grid;
+ *
+ * grid.insert(BALL, ballRect);
+ * grid.moveBy(BALL, speed);
+ * grid.collisions(BALL, [](uint8_t id) { grid.remove(id); });
+ * @endcode
+ */
+template<typename T, T &E, uint8_t N, uint8_t COLS, uint8_t ROWS>
+class NanoObjectGrid
+{
+    static_assert(N < 255 && COLS * ROWS < 255, "NanoObjectGrid supports up to 254 objects and cells");
+
+public:
+    /** Marks end of cell list and object, not present in the grid */
+    static const uint8_t NO_OBJECT = 0xFF;
+
+    /** Creates empty grid */
+    NanoObjectGrid()
+    {
+        clear();
+    }
+
+    /**
+     * Removes all objects from the grid. Doesn't refresh the screen.
+     */
+    void clear()
+    {
+        memset(m_head, NO_OBJECT, sizeof(m_head));
+        memset(m_cell, NO_OBJECT, sizeof(m_cell));
+        m_maxSize = { 0, 0 };
+    }
+
+    /**
+     * Returns true if object is present in the grid.
+     * @param id - index of object [0, N-1]
+     */
+    bool inserted(uint8_t id) const
+    {
+        return m_cell[id] != NO_OBJECT;
+    }
+
+    /**
+     * Adds object to the grid, or moves it if it is already present.
+     * @param id - index of object [0, N-1]
+     * @param rect - bounding rectangle of the object in World coordinates
+     */
+    void insert(uint8_t id, const NanoRect &rect)
+    {
+        if ( inserted(id) )
+        {
+            move(id, rect);
+            return;
+        }
+        m_rect[id] = rect;
+        updateMaxSize(rect);
+        link(id, cellIndex(rect.p1));
+        E.refreshWorld(rect);
+    }
+
+    /**
+     * Removes object from the grid and refreshes its area.
+     * @param id - index of object [0, N-1]
+     */
+    void remove(uint8_t id)
+    {
+        if ( !inserted(id) )
+        {
+            return;
+        }
+        E.refreshWorld(m_rect[id]);
+        unlink(id);
+    }
+
+    /**
+     * Moves object to new bounds, refreshes old and new areas.
+     * Object, which is not in the grid, is inserted.
+     * @param id - index of object in the grid
+     * @param rect - new bounding rectangle of the object in World coordinates
+     */
+    void move(uint8_t id, const NanoRect &rect)
+    {
+        if ( !inserted(id) )
+        {
+            insert(id, rect);
+            return;
+        }
+        uint8_t cell = cellIndex(rect.p1);
+        E.refreshWorld(m_rect[id]);
+        m_rect[id] = rect;
+        updateMaxSize(rect);
+        if ( cell != m_cell[id] )
+        {
+            unlink(id);
+            link(id, cell);
+        }
+        E.refreshWorld(rect);
+    }
+
+    /**
+     * Moves object by specified offset, refreshes old and new areas.
+     * Does nothing if object is not in the grid.
+     * @param id - index of object in the grid
+     * @param delta - offset in pixels
+     */
+    void moveBy(uint8_t id, const NanoPoint &delta)
+    {
+        if ( !inserted(id) )
+        {
+            return;
+        }
+        NanoRect rect = m_rect[id];
+        rect += delta;
+        move(id, rect);
+    }
+
+    /**
+     * Returns bounding rectangle of the object.
+     * @param id - index of object in the grid
+     */
+    const NanoRect &rect(uint8_t id) const
+    {
+        return m_rect[id];
+    }
+
+    /**
+     * Calls callback(id) for each object, which overlaps specified region.
+     * For example, draw callback can draw only objects in the tile being updated.
+     * Callback may remove reported object from the grid.
+     * @param region - rectangle in World coordinates
+     * @param callback - function or lambda, accepting object index
+     */
+    template<typename F>
+    void query(const NanoRect &region, F callback) const
+    {
+        query(region, NO_OBJECT, callback);
+    }
+
+    /**
+     * Calls callback(other) for each object, which overlaps specified object.
+     * Callback may remove reported object from the grid.
+     * @param id - index of object in the grid
+     * @param callback - function or lambda, accepting index of other object
+     */
+    template<typename F>
+    void collisions(uint8_t id, F callback) const
+    {
+        query(m_rect[id], id, callback);
+    }
+
+    /**
+     * Calls callback(a, b) once for each pair of overlapping objects, a < b.
+     * Callback must not remove or move objects; collect pairs and process them
+     * after the call instead.
+     * @param callback - function or lambda, accepting indexes of two objects
+     */
+    template<typename F>
+    void collisions(F callback) const
+    {
+        for (uint8_t id = 0; id < N; id++)
+        {
+            if ( !inserted(id) ) continue;
+            query(m_rect[id], id, [&](uint8_t other)
+            {
+                if ( other > id ) callback(id, other);
+            });
+        }
+    }
+
+private:
+    NanoRect  m_rect[N];
+    uint8_t   m_next[N];
+    uint8_t   m_cell[N];
+    uint8_t   m_head[COLS * ROWS];
+    NanoPoint m_maxSize;
+
+    static uint8_t cellX(lcdint_t x)
+    {
+        x >>= T::NE_TILE_SIZE_BITS;
+        return x < 0 ? 0 : (x >= COLS ? COLS - 1 : x);
+    }
+
+    static uint8_t cellY(lcdint_t y)
+    {
+        y >>= T::NE_TILE_SIZE_BITS;
+        return y < 0 ? 0 : (y >= ROWS ? ROWS - 1 : y);
+    }
+
+    static uint8_t cellIndex(const NanoPoint &p)
+    {
+        return cellY(p.y) * COLS + cellX(p.x);
+    }
+
+    void updateMaxSize(const NanoRect &rect)
+    {
+        if ( rect.width() > m_maxSize.x ) m_maxSize.x = rect.width();
+        if ( rect.height() > m_maxSize.y ) m_maxSize.y = rect.height();
+    }
+
+    void link(uint8_t id, uint8_t cell)
+    {
+        m_cell[id] = cell;
+        m_next[id] = m_head[cell];
+        m_head[cell] = id;
+    }
+
+    void unlink(uint8_t id)
+    {
+        uint8_t *p = &m_head[m_cell[id]];
+        while ( *p != id )
+        {
+            p = &m_next[*p];
+        }
+        *p = m_next[id];
+        m_cell[id] = NO_OBJECT;
+    }
+
+    /* Objects are linked to cells by top-left corner, so the cells to the left and *
+     * above the region are checked too, as far as the largest object extends       */
+    template<typename F>
+    void query(const NanoRect &region, uint8_t skip, F callback) const
+    {
+        uint8_t x1 = cellX(region.p1.x - m_maxSize.x + 1);
+        uint8_t x2 = cellX(region.p2.x);
+        uint8_t y1 = cellY(region.p1.y - m_maxSize.y + 1);
+        uint8_t y2 = cellY(region.p2.y);
+        for (uint8_t y = y1; y <= y2; y++)
+        {
+            for (uint8_t x = x1; x <= x2; x++)
+            {
+                uint8_t id = m_head[y * COLS + x];
+                while ( id != NO_OBJECT )
+                {
+                    uint8_t next = m_next[id];
+                    if ( (id != skip) && m_rect[id].collision(region) )
+                    {
+                        callback(id);
+                    }
+                    id = next;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
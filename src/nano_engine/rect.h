@@ -145,6 +145,15 @@ typedef struct _NanoRect
         return collisionX(p.x) && collisionY(p.y);
     }
 
+    /**
+     * Returns true if rectangles have at least one common point.
+     * @param r - rectangle to check.
+     */
+    bool collision(const _NanoRect &r) const
+    {
+        return (r.p1.x <= p2.x) && (r.p2.x >= p1.x) && (r.p1.y <= p2.y) && (r.p2.y >= p1.y);
+    }
+
     /**
      * Returns true of point belongs to rectangle area
      *
@@ -0,0 +1,291 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "text.h"
+#include "ssd1306.h"
+#include "ssd1306_trace.h"
+
+/** Marks absence of break opportunity in the current line */
+static const uint16_t NO_BREAK = 0xFFFF;
+
+NanoTextLayout::NanoTextLayout(NanoTextGlyph *glyphs, uint16_t maxGlyphs, NanoTextLine *lines, uint8_t maxLines)
+    : m_glyphs( glyphs )
+    , m_maxGlyphs( maxGlyphs )
+    , m_lines( lines )
+    , m_maxLines( maxLines )
+{
+}
+
+/* Drops trailing spaces and calculates width of the line */
+static void finishLine(const NanoTextGlyph *glyphs, NanoTextLine &line)
+{
+    while ( line.count && glyphs[line.first + line.count - 1].unicode == ' ' )
+    {
+        line.count--;
+    }
+    line.width = 0;
+    for (uint16_t i = line.first; i < line.first + line.count; i++)
+    {
+        line.width += glyphs[i].info.width + glyphs[i].info.spacing;
+    }
+    if ( line.count )
+    {
+        line.width -= glyphs[line.first + line.count - 1].info.spacing;
+    }
+}
+
+/* Cuts the line to fit "..." and returns index of the glyph after the line */
+uint16_t NanoTextLayout::addEllipsis(NanoTextLine &line)
+{
+    NanoTextGlyph dot;
+    dot.unicode = '.';
+    ssd1306_getCharBitmap('.', &dot.info);
+    lcduint_t dots = 3 * (dot.info.width + dot.info.spacing) - dot.info.spacing;
+    for (;;)
+    {
+        finishLine(m_glyphs, line);
+        lcduint_t advance = line.count ? line.width + m_glyphs[line.first + line.count - 1].info.spacing : 0;
+        bool fits = !m_width || advance + dots <= m_width;
+        if ( !line.count || (fits && line.first + line.count + 3 <= m_maxGlyphs) )
+        {
+            break;
+        }
+        line.count--;
+    }
+    if ( line.first + line.count + 3 <= m_maxGlyphs )
+    {
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            m_glyphs[line.first + line.count++] = dot;
+        }
+        finishLine(m_glyphs, line);
+    }
+    return line.first + line.count;
+}
+
+uint8_t NanoTextLayout::layout(const char *text, lcduint_t width, uint8_t flags, uint8_t maxLines)
+{
+    SSD1306_TRACE_SCOPE("text", "layout");
+    m_width = width;
+    m_flags = flags;
+    m_count = 0;
+    m_truncated = false;
+    m_maxWidth = 0;
+    m_lineHeight = s_fixedFont.h.height;
+    if ( !maxLines || maxLines > m_maxLines )
+    {
+        maxLines = m_maxLines;
+    }
+    if ( !maxLines )
+    {
+        return 0;
+    }
+    uint16_t n = 0;                 // number of stored glyphs
+    uint16_t brk = NO_BREAK;        // index of the last space in the current line
+    lcduint_t pen = 0;              // advance of the current line
+    bool wrapped = false;           // current line is started by word wrap
+    bool cut = false;               // the rest of the current line is skipped
+    bool done = false;              // the rest of the text is skipped
+    NanoTextLine *dotted = nullptr; // line, ended with "..."
+    NanoTextLine *line = &m_lines[m_count++];
+    line->first = 0;
+    line->count = 0;
+    while ( *text && !done )
+    {
+        uint16_t unicode = ssd1306_unicode16FromUtf8( *text++ );
+        if ( unicode == SSD1306_MORE_CHARS_REQUIRED || unicode == '\r' )
+        {
+            continue;
+        }
+        if ( unicode == '\n' )
+        {
+            if ( !cut )
+            {
+                finishLine(m_glyphs, *line);
+            }
+            if ( m_count >= maxLines )
+            {
+                m_truncated = *text != 0;
+                done = m_truncated;
+                break;
+            }
+            n = line->first + line->count;
+            line = &m_lines[m_count++];
+            line->first = n;
+            line->count = 0;
+            brk = NO_BREAK;
+            pen = 0;
+            wrapped = false;
+            cut = false;
+            continue;
+        }
+        if ( cut || (unicode == ' ' && wrapped && !line->count) )
+        {
+            continue;
+        }
+        SCharInfo info;
+        ssd1306_getCharBitmap(unicode, &info);
+        if ( info.height > m_lineHeight )
+        {
+            m_lineHeight = info.height;
+        }
+        /* Loop breaks long words, moved to the new line, between chars */
+        while ( width && pen + info.width > width && line->count && unicode != ' ' )
+        {
+            if ( !(flags & NANO_TEXT_WORD_WRAP) )
+            {
+                /* Without word wrap the rest of the line is skipped till next '\n' */
+                m_truncated = true;
+                cut = true;
+                if ( flags & NANO_TEXT_ELLIPSIS )
+                {
+                    n = addEllipsis(*line);
+                    dotted = line;
+                }
+                else
+                {
+                    finishLine(m_glyphs, *line);
+                }
+                break;
+            }
+            if ( m_count >= maxLines )
+            {
+                /* Last line keeps as many glyphs, as fit before "...", or ends at the last space */
+                if ( !(flags & NANO_TEXT_ELLIPSIS) && brk != NO_BREAK )
+                {
+                    line->count = brk - line->first;
+                }
+                m_truncated = true;
+                done = true;
+                break;
+            }
+            uint16_t next = n;
+            if ( brk != NO_BREAK )
+            {
+                line->count = brk - line->first;
+                next = brk + 1;
+            }
+            finishLine(m_glyphs, *line);
+            line = &m_lines[m_count++];
+            line->first = next;
+            line->count = n - next;
+            pen = 0;
+            for (uint16_t i = next; i < n; i++)
+            {
+                pen += m_glyphs[i].info.width + m_glyphs[i].info.spacing;
+            }
+            brk = NO_BREAK;
+            wrapped = true;
+        }
+        if ( cut || done )
+        {
+            continue;
+        }
+        if ( n >= m_maxGlyphs )
+        {
+            m_truncated = true;
+            done = true;
+            break;
+        }
+        if ( unicode == ' ' )
+        {
+            brk = n;
+        }
+        m_glyphs[n].unicode = unicode;
+        m_glyphs[n].info = info;
+        n++;
+        line->count++;
+        pen += info.width + info.spacing;
+    }
+    /* The last line is ended with "...", if the rest of the text is skipped */
+    if ( done && (flags & NANO_TEXT_ELLIPSIS) && dotted != line )
+    {
+        addEllipsis(*line);
+    }
+    else if ( !cut )
+    {
+        finishLine(m_glyphs, *line);
+    }
+    /* Text, ending with '\n', and empty text don't produce empty last line */
+    if ( !line->count && !m_truncated )
+    {
+        m_count--;
+    }
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        if ( m_lines[i].width > m_maxWidth )
+        {
+            m_maxWidth = m_lines[i].width;
+        }
+    }
+    return m_count;
+}
+
+lcdint_t NanoTextLayout::lineOffset(uint8_t index) const
+{
+    lcduint_t box = m_width ? m_width : m_maxWidth;
+    lcduint_t width = m_lines[index].width;
+    if ( width >= box )
+    {
+        return 0;
+    }
+    switch ( m_flags & NANO_TEXT_ALIGN_MASK )
+    {
+        case NANO_TEXT_ALIGN_CENTER: return (box - width) / 2;
+        case NANO_TEXT_ALIGN_RIGHT: return box - width;
+        default: return 0;
+    }
+}
+
+NanoRect NanoTextLayout::lineRect(uint8_t index) const
+{
+    lcdint_t x = lineOffset(index);
+    lcdint_t y = (lcdint_t)index * m_lineHeight;
+    return { { x, y },
+             { (lcdint_t)(x + m_lines[index].width - 1), (lcdint_t)(y + m_lineHeight - 1) } };
+}
+
+NanoRect NanoTextLayout::bounds() const
+{
+    NanoRect rect = { { 0, 0 }, { -1, -1 } };
+    if ( !m_maxWidth )
+    {
+        return rect;
+    }
+    bool first = true;
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        /* Empty lines add only height to the text */
+        if ( !m_lines[i].width )
+        {
+            continue;
+        }
+        NanoRect r = lineRect(i);
+        if ( first || r.p1.x < rect.p1.x ) rect.p1.x = r.p1.x;
+        if ( first || r.p2.x > rect.p2.x ) rect.p2.x = r.p2.x;
+        first = false;
+    }
+    rect.p2.y = (lcdint_t)m_count * m_lineHeight - 1;
+    return rect;
+}
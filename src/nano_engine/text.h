@@ -0,0 +1,229 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file text.h Text layout: word wrap, alignment and measurement of prepared text
+ */
+
+#ifndef _NANO_TEXT_H_
+#define _NANO_TEXT_H_
+
+#include "point.h"
+#include "rect.h"
+#include "canvas.h"
+#include "ssd1306_hal/io.h"
+#include "nano_gfx_types.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+enum
+{
+    /** Lines are aligned to the left edge of the layout box */
+    NANO_TEXT_ALIGN_LEFT        = 0x00,
+    /** Lines are centered in the layout box */
+    NANO_TEXT_ALIGN_CENTER      = 0x01,
+    /** Lines are aligned to the right edge of the layout box */
+    NANO_TEXT_ALIGN_RIGHT       = 0x02,
+    /** Mask of alignment flags */
+    NANO_TEXT_ALIGN_MASK        = 0x03,
+    /** Lines, which do not fit the width, are broken at spaces or, for long words, between chars */
+    NANO_TEXT_WORD_WRAP         = 0x04,
+    /** Text, which doesn't fit the layout, ends with "..." */
+    NANO_TEXT_ELLIPSIS          = 0x08,
+};
+
+/** Glyph of prepared text */
+typedef struct
+{
+    uint16_t unicode;   ///< unicode of the char
+    SCharInfo info;     ///< glyph size, spacing and bitmap in active font
+} NanoTextGlyph;
+
+/** Line of prepared text */
+typedef struct
+{
+    uint16_t first;     ///< index of the first glyph of the line
+    uint16_t count;     ///< number of glyphs in the line
+    lcduint_t width;    ///< width of the line in pixels
+} NanoTextLine;
+
+/**
+ * NanoTextLayout decodes utf-8 text once, looks up glyphs of the active font and splits
+ * the text into lines. The result keeps glyph bitmaps and advance widths, so prepared text
+ * can be measured and drawn on every frame without decoding and font lookups.
+ * Layout works in the memory, provided by the application, and never allocates memory itself.
+ * If the text doesn't fit glyph or line storage, it is truncated the same way, as
+ * the text, not fitting specified number of lines.
+ *
+ * @code
+ * NanoTextGlyph glyphs[64];
+ * NanoTextLine lines[4];
+ * NanoTextLayout text(glyphs, 64, lines, 4);
+ *
+ * text.layout("Connection lost. Retrying in 5 seconds", 80,
+ *             NANO_TEXT_WORD_WRAP | NANO_TEXT_ALIGN_CENTER | NANO_TEXT_ELLIPSIS);
+ * NanoRect box = text.bounds();
+ * ...
+ * text.draw(engine.canvas, 24, 16);
+ * @endcode
+ *
+ * @note Layout must be prepared again after the font is changed.
+ */
+class NanoTextLayout
+{
+public:
+    /**
+     * Creates text layout object.
+     *
+     * @param glyphs - storage for glyphs of the text
+     * @param maxGlyphs - number of elements in glyphs storage
+     * @param lines - storage for lines of the text
+     * @param maxLines - number of elements in lines storage, maximum number of lines
+     */
+    NanoTextLayout(NanoTextGlyph *glyphs, uint16_t maxGlyphs, NanoTextLine *lines, uint8_t maxLines);
+
+    /**
+     * Splits text into lines, using active font.
+     * Lines are broken at '\n' chars and, if NANO_TEXT_WORD_WRAP flag is set, when the text
+     * doesn't fit the width. Without NANO_TEXT_WORD_WRAP flag the end of too long line is cut.
+     * Spaces at the wrap position and at the end of lines are not included to the lines.
+     * Trailing '\n' doesn't start new line, and empty text gives no lines.
+     *
+     * @param text - utf-8 or ascii text, depending on the library mode
+     * @param width - width of the layout box in pixels, 0 for unlimited width
+     * @param flags - combination of NANO_TEXT_ALIGN_*, NANO_TEXT_WORD_WRAP and NANO_TEXT_ELLIPSIS
+     * @param maxLines - maximum number of lines, 0 to use all lines storage
+     * @return number of lines
+     */
+    uint8_t layout(const char *text, lcduint_t width = 0, uint8_t flags = NANO_TEXT_WORD_WRAP,
+                   uint8_t maxLines = 0);
+
+    /**
+     * Returns number of lines in prepared text.
+     */
+    uint8_t lines() const { return m_count; }
+
+    /**
+     * Returns line of prepared text.
+     * @param index - index of line [0, lines() - 1]
+     */
+    const NanoTextLine &line(uint8_t index) const { return m_lines[index]; }
+
+    /**
+     * Returns glyphs of prepared text. Glyphs of line are line(index).count elements,
+     * starting at line(index).first.
+     */
+    const NanoTextGlyph *glyphs() const { return m_glyphs; }
+
+    /**
+     * Returns height of single line in pixels.
+     */
+    lcduint_t lineHeight() const { return m_lineHeight; }
+
+    /**
+     * Returns true, if the text didn't fit and was cut.
+     */
+    bool truncated() const { return m_truncated; }
+
+    /**
+     * Returns horizontal offset of the line inside layout box, according to alignment.
+     * If width of layout box is not specified, lines are aligned to the longest one.
+     * @param index - index of line [0, lines() - 1]
+     */
+    lcdint_t lineOffset(uint8_t index) const;
+
+    /**
+     * Returns rectangle, covered by the line, relative to the top-left corner of layout box.
+     * @param index - index of line [0, lines() - 1]
+     */
+    NanoRect lineRect(uint8_t index) const;
+
+    /**
+     * Returns bounding rectangle of all lines, relative to the top-left corner of layout box.
+     * Returned rectangle is empty (p2 is less than p1), if there are no lines or all lines
+     * are empty.
+     */
+    NanoRect bounds() const;
+
+    /**
+     * Draws prepared text on the canvas with current color and mode of the canvas.
+     * Lines and glyphs outside of the canvas are skipped without drawing.
+     *
+     * @param canvas - canvas to draw on
+     * @param x - left position of layout box
+     * @param y - top position of layout box
+     */
+    template <uint8_t BPP>
+    void draw(NanoCanvasOps<BPP> &canvas, lcdint_t x, lcdint_t y) const
+    {
+        const NanoRect area = canvas.rect();
+        for (uint8_t i = 0; i < m_count; i++, y += m_lineHeight)
+        {
+            if ( y > area.p2.y )
+            {
+                break;
+            }
+            if ( y + (lcdint_t)m_lineHeight <= area.p1.y )
+            {
+                continue;
+            }
+            const NanoTextGlyph *glyph = &m_glyphs[m_lines[i].first];
+            lcdint_t gx = x + lineOffset(i);
+            for (uint16_t n = m_lines[i].count; n > 0; n--, glyph++)
+            {
+                if ( gx > area.p2.x )
+                {
+                    break;
+                }
+                if ( gx + (lcdint_t)glyph->info.width > area.p1.x )
+                {
+                    canvas.drawGlyph(gx, y, glyph->unicode, glyph->info);
+                }
+                gx += glyph->info.width + glyph->info.spacing;
+            }
+        }
+    }
+
+private:
+    NanoTextGlyph *m_glyphs;
+    uint16_t m_maxGlyphs;
+    NanoTextLine *m_lines;
+    uint8_t m_maxLines;
+    uint8_t m_count = 0;
+    uint8_t m_flags = 0;
+    bool m_truncated = false;
+    lcduint_t m_width = 0;
+    lcduint_t m_maxWidth = 0;
+    lcduint_t m_lineHeight = 0;
+
+    uint16_t addEllipsis(NanoTextLine &line);
+};
+
+/**
+ * @}
+ */
+
+#endif
@@ -30,7 +30,9 @@
 #define _NANO_ENGINE_TILER_H_
 
 #include "canvas.h"
+#include "ssd1306_trace.h"
 #include "lcd/lcd_common.h"
+#include "lcd/oled_ssd1306.h"
 
 /**
  * @ingroup NANO_ENGINE_API
@@ -41,7 +43,6 @@
  * Structure, holding currently set font.
  * @warning Only for internal use.
  */
-extern "C" SFixedFontInfo s_fixedFont;
 
 /* The table below defines arguments for NanoEngineTiler.          *
  *                            canvas        width   height  bits   */
@@ -214,6 +215,73 @@ public:
         refresh();
     }
 
+    /**
+     * @brief Enables hardware scrolling camera.
+     *
+     * Enables scrollTo() to move camera vertically via display start line
+     * instead of redrawing whole screen. Hardware scrolling affects the whole display,
+     * so all content, drawn by engine, scrolls together with the World.
+     * Only 64-line SSD1306 and SH1106 displays support this mode, for other displays
+     * scrollTo() always refreshes whole screen.
+     * @param enable - true to enable hardware scrolling, false to disable
+     */
+    static void hardwareScroll(bool enable)
+    {
+        m_hwScroll = enable && (ssd1306_lcd.height == 64) &&
+                     ((ssd1306_lcd.type == LCD_TYPE_SSD1306) ||
+                      (ssd1306_lcd.type == LCD_TYPE_SH1106));
+        if (m_startLine)
+        {
+            m_startLine = 0;
+            ssd1306_setStartLine(0);
+        }
+        refresh();
+    }
+
+    /**
+     * @brief Moves camera to new World position with minimum display update.
+     *
+     * If hardware scrolling is enabled via hardwareScroll() and camera moves only
+     * vertically by number of pixels, multiple of tile height, the function shifts
+     * display start line, and marks for refresh only newly exposed tile rows.
+     * In all other cases it works as moveToAndRefresh().
+     * @param position - new World offset
+     */
+    static void scrollTo(const NanoPoint & position)
+    {
+        lcdint_t dy = position.y - offset.y;
+        lcdint_t rows = min(ssd1306_lcd.height >> B, NE_MAX_TILES_NUM);
+        if (!m_hwScroll || (position.x != offset.x) || (dy % (lcdint_t)H) ||
+            (dy >= (lcdint_t)ssd1306_lcd.height) || (-dy >= (lcdint_t)ssd1306_lcd.height))
+        {
+            moveToAndRefresh(position);
+            return;
+        }
+        moveTo(position);
+        if (!dy)
+        {
+            return;
+        }
+        m_startLine = (m_startLine + dy + ssd1306_lcd.height) % ssd1306_lcd.height;
+        m_startLinePending = true;
+        /* Move pending refresh flags together with content and mark exposed rows */
+        lcdint_t shift = dy / (lcdint_t)H;
+        if (shift > 0)
+        {
+            for (lcdint_t y = 0; y < rows; y++)
+            {
+                m_refreshFlags[y] = (y + shift < rows) ? m_refreshFlags[y + shift] : 0xFFFF;
+            }
+        }
+        else
+        {
+            for (lcdint_t y = rows - 1; y >= 0; y--)
+            {
+                m_refreshFlags[y] = (y + shift >= 0) ? m_refreshFlags[y + shift] : 0xFFFF;
+            }
+        }
+    }
+
     /**
      * Returns current World offset
      */
@@ -251,6 +319,38 @@ public:
      */
     static bool collision(NanoPoint &p, NanoRect &rect) { return rect.collision( p ); }
 
+#if defined(CONFIG_NANO_ENGINE_TILE_HASH_ENABLE)
+    /**
+     * Forgets content of tiles, sent to the display, so that next display() call sends
+     * all refreshed tiles. Call it, if display content is changed bypassing the engine,
+     * for example, by ssd1306_clearScreen().
+     */
+    static void invalidateTiles()
+    {
+        memset(m_tileHashValid, 0, sizeof(m_tileHashValid));
+    }
+
+    /**
+     * Returns number of tiles, sent to the display since last resetTileStats() call.
+     */
+    static uint32_t getTilesSent() { return m_tilesSent; };
+
+    /**
+     * Returns number of tiles, not sent to the display since last resetTileStats() call,
+     * because their content is the same as already shown on the display.
+     */
+    static uint32_t getTilesSkipped() { return m_tilesSkipped; };
+
+    /**
+     * Resets counters of sent and skipped tiles.
+     */
+    static void resetTileStats()
+    {
+        m_tilesSent = 0;
+        m_tilesSkipped = 0;
+    }
+#endif
+
 protected:
     /**
      * Contains information on tiles to be updated.
@@ -261,6 +361,49 @@ protected:
     /** Callback to call if specific tile needs to be updated */
     static TNanoEngineOnDraw m_onDraw;
 
+    /** Time in microseconds, spent by last displayBuffer() call to send tiles to display */
+    static uint32_t m_bltTime;
+
+    /** True if hardware scrolling camera is enabled */
+    static bool m_hwScroll;
+
+    /** Current display start line, used by hardware scrolling camera */
+    static uint8_t m_startLine;
+
+    /** True if display start line must be updated on next displayBuffer() call */
+    static bool m_startLinePending;
+
+    /**
+     * Sends canvas to display, taking into account display start line.
+     * @param x - left position of canvas on the screen
+     * @param y - top position of canvas on the screen
+     */
+    static void bltTile(lcdint_t x, lcdint_t y)
+    {
+        lcdint_t ly = m_startLine ? (y + m_startLine) % ssd1306_lcd.height : y;
+#if defined(CONFIG_NANO_ENGINE_TILE_HASH_ENABLE)
+        /* Hash is kept per position in display memory, so scrolling doesn't invalidate it. *
+         * Only tiles at grid positions have their own slot, other blits are always sent.  */
+        uint8_t row = ly >> B;
+        uint8_t col = x >> B;
+        if ( (x >= 0) && (ly >= 0) && !((x | ly) & ((1 << B) - 1)) &&
+             (row < NE_MAX_TILES_NUM) && (col < 16) )
+        {
+            uint32_t hash = tileHash();
+            if ( (m_tileHashValid[row] & (1 << col)) && (m_tileHash[row][col] == hash) )
+            {
+                m_tilesSkipped++;
+                return;
+            }
+            m_tileHash[row][col] = hash;
+            m_tileHashValid[row] |= (1 << col);
+        }
+        m_tilesSent++;
+#endif
+        SSD1306_TRACE_SCOPE("engine", "blt");
+        canvas.blt(x, ly);
+    }
+
     /**
      * @brief refreshes content on oled display.
      * Refreshes content on oled display. Call it, if you want to update the screen.
@@ -280,6 +423,35 @@ private:
     static uint8_t    m_buffer[W * H * C::BITS_PER_PIXEL / 8];
 
     static NanoPoint offset;
+
+#if defined(CONFIG_NANO_ENGINE_TILE_HASH_ENABLE)
+    /** Hashes of tiles, last sent to the display, rows and columns in display memory */
+    static uint32_t   m_tileHash[NE_MAX_TILES_NUM][16];
+
+    /** Bits are set for the tiles, which have valid hash */
+    static uint16_t   m_tileHashValid[NE_MAX_TILES_NUM];
+
+    static uint32_t   m_tilesSent;
+    static uint32_t   m_tilesSkipped;
+
+    /**
+     * Calculates 32-bit hash of canvas buffer. Buffer size is always multiple of 4 bytes,
+     * so it is processed by 32-bit words: FNV-1a step followed by xor-shift to mix high
+     * bits of the product back into low ones.
+     */
+    static uint32_t tileHash()
+    {
+        uint32_t hash = 2166136261UL;
+        for (uint16_t i = 0; i < sizeof(m_buffer); i += 4)
+        {
+            uint32_t word;
+            memcpy(&word, &m_buffer[i], sizeof(word));
+            hash = (hash ^ word) * 16777619UL;
+            hash ^= hash >> 15;
+        }
+        return hash;
+    }
+#endif
 };
 
 template<class C, lcduint_t W, lcduint_t H, uint8_t B>
@@ -297,14 +469,49 @@ NanoPoint NanoEngineTiler<C,W,H,B>::offset = {0, 0};
 template<class C, lcduint_t W, lcduint_t H, uint8_t B>
 TNanoEngineOnDraw NanoEngineTiler<C,W,H,B>::m_onDraw = nullptr;
 
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t NanoEngineTiler<C,W,H,B>::m_bltTime = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_hwScroll = false;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_startLine = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_startLinePending = false;
+
+#if defined(CONFIG_NANO_ENGINE_TILE_HASH_ENABLE)
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t NanoEngineTiler<C,W,H,B>::m_tileHash[NE_MAX_TILES_NUM][16];
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint16_t NanoEngineTiler<C,W,H,B>::m_tileHashValid[NE_MAX_TILES_NUM];
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t NanoEngineTiler<C,W,H,B>::m_tilesSent = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t NanoEngineTiler<C,W,H,B>::m_tilesSkipped = 0;
+#endif
+
 template<class C, lcduint_t W, lcduint_t H, uint8_t B>
 void NanoEngineTiler<C,W,H,B>::displayBuffer()
 {
+    SSD1306_TRACE_SCOPE("engine", "displayBuffer");
+    uint32_t ts = micros();
+    if (m_startLinePending)
+    {
+        m_startLinePending = false;
+        ssd1306_setStartLine(m_startLine);
+    }
     if (!m_onDraw)  // If onDraw handler is not set, just output current canvas
     {
-        canvas.blt();
+        bltTile(canvas.offset.x, canvas.offset.y);
+        m_bltTime = micros() - ts;
         return;
     }
+    m_bltTime = 0;
     for (lcduint_t y = 0; y < ssd1306_lcd.height; y = y + NE_TILE_HEIGHT)
     {
         uint16_t flag = m_refreshFlags[y >> NE_TILE_SIZE_BITS];
@@ -314,10 +521,15 @@ void NanoEngineTiler<C,W,H,B>::displayBuffer()
             if (flag & 0x01)
             {
                 canvas.setOffset(x, y);
-                if (m_onDraw())
+                SSD1306_TRACE_BEGIN("engine", "onDraw");
+                bool tileReady = m_onDraw();
+                SSD1306_TRACE_END();
+                if (tileReady)
                 {
                     canvas.setOffset(x, y);
-                    canvas.blt();
+                    ts = micros();
+                    bltTile(x, y);
+                    m_bltTime += micros() - ts;
                 }
             }
             flag >>=1;
@@ -344,12 +556,13 @@ void NanoEngineTiler<C,W,H,B>::displayPopup(const char *msg)
                 if (m_onDraw) m_onDraw();
                 canvas.setOffset(x, y);
                 canvas.setColor(RGB_COLOR8(0,0,0));
-                canvas.fillRect(rect);
+                /* Color canvases dim content under the popup instead of hiding it */
+                canvas.fillRectAlpha(rect, 192);
                 canvas.setColor(RGB_COLOR8(192,192,192));
                 canvas.drawRect(rect);
                 canvas.printFixed( textPos.x, textPos.y, msg);
 
-                canvas.blt();
+                bltTile(x, y);
             }
             flag >>=1;
         }
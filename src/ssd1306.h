@@ -30,9 +30,13 @@
 
 #include "nano_gfx_types.h"
 #include "ssd1306_generic.h"
+#include "ssd1306_context.h"
 #include "ssd1306_1bit.h"
 #include "ssd1306_8bit.h"
 #include "ssd1306_16bit.h"
+#include "ssd1306_image.h"
+#include "ssd1306_dither.h"
+#include "ssd1306_transpose.h"
 #include "ssd1306_fonts.h"
 
 #include "lcd/lcd_common.h"
@@ -46,6 +50,7 @@
 #include "lcd/lcd_il9163.h"
 #include "lcd/lcd_ili9341.h"
 #include "lcd/composite_video.h"
+#include "lcd/linux_fb.h"
 
 #include "lcd/oled_template.h"
 
@@ -28,11 +28,6 @@
 #include "lcd/lcd_common.h"
 #include "ssd1306_hal/io.h"
 
-extern uint16_t ssd1306_color;
-extern uint8_t s_ssd1306_invertByte;
-extern lcduint_t ssd1306_cursorX;
-extern lcduint_t ssd1306_cursorY;
-extern SFixedFontInfo s_fixedFont;
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
 extern uint8_t g_ssd1306_unicode;
 #endif
@@ -47,13 +42,8 @@ static void ssd1306_drawBufferPitch16(lcdint_t x, lcdint_t y, lcduint_t w, lcdui
     ssd1306_lcd.set_block(x, y, w);
     while (h--)
     {
-        lcduint_t line = w << 1;
-        while (line--)
-        {
-            ssd1306_intf.send( *data );
-            data++;
-        }
-        data += pitch - (w << 1);
+        ssd1306_intf.send_buffer( data, w << 1 );
+        data += pitch;
     }
     ssd1306_intf.stop();
 }
@@ -104,6 +94,11 @@ void ssd1306_drawMonoBuffer16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint
 
 void ssd1306_fillScreen16(uint16_t fill_Data)
 {
+    if (ssd1306_lcd.accel)
+    {
+        ssd1306_lcd.accel->fill_rect(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1, fill_Data);
+        return;
+    }
     ssd1306_lcd.set_block(0, 0, 0);
     uint32_t count = (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height;
     while (count--)
@@ -115,6 +110,11 @@ void ssd1306_fillScreen16(uint16_t fill_Data)
 
 void ssd1306_clearScreen16(void)
 {
+    if (ssd1306_lcd.accel)
+    {
+        ssd1306_lcd.accel->clear_rect(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+        return;
+    }
     ssd1306_fillScreen16( 0x0000 );
 }
 
@@ -156,6 +156,13 @@ void ssd1306_drawHLine16(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 
 void ssd1306_drawLine16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.accel && (x1 >= 0) && (y1 >= 0) && (x2 >= 0) && (y2 >= 0) &&
+        (x1 < (lcdint_t)ssd1306_lcd.width) && (x2 < (lcdint_t)ssd1306_lcd.width) &&
+        (y1 < (lcdint_t)ssd1306_lcd.height) && (y2 < (lcdint_t)ssd1306_lcd.height))
+    {
+        ssd1306_lcd.accel->draw_line(x1, y1, x2, y2, ssd1306_color);
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
@@ -215,6 +222,20 @@ void ssd1306_fillRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
+    if (ssd1306_lcd.accel && (x2 >= 0) && (y2 >= 0) &&
+        (x1 < (lcdint_t)ssd1306_lcd.width) && (y1 < (lcdint_t)ssd1306_lcd.height))
+    {
+        /* Accelerator accepts only screen coordinates, so clip rectangle to the screen */
+        lcduint_t cx1 = x1 < 0 ? 0 : x1;
+        lcduint_t cy1 = y1 < 0 ? 0 : y1;
+        lcduint_t cx2 = x2 < (lcdint_t)ssd1306_lcd.width ? x2 : ssd1306_lcd.width - 1;
+        lcduint_t cy2 = y2 < (lcdint_t)ssd1306_lcd.height ? y2 : ssd1306_lcd.height - 1;
+        if ( (uint32_t)(cx2 - cx1 + 1) * (cy2 - cy1 + 1) >= SSD1306_ACCEL_MIN_PIXELS )
+        {
+            ssd1306_lcd.accel->fill_rect(cx1, cy1, cx2, cy2, ssd1306_color);
+            return;
+        }
+    }
     ssd1306_lcd.set_block(x1, y1, x2 - x1 + 1);
     uint16_t count = (x2 - x1 + 1) * (y2 - y1 + 1);
     while (count--)
@@ -269,6 +290,12 @@ void ssd1306_drawBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h
 
 void ssd1306_clearBlock16(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
+    if (ssd1306_lcd.accel && ((uint16_t)w * h >= SSD1306_ACCEL_MIN_PIXELS) &&
+        (x + w <= ssd1306_lcd.width) && (y + h <= ssd1306_lcd.height))
+    {
+        ssd1306_lcd.accel->clear_rect(x, y, x + w - 1, y + h - 1);
+        return;
+    }
     ssd1306_lcd.set_block(x, y, w);
     uint32_t count = w * h;
     while (count--)
@@ -37,12 +37,10 @@
 // TODO: remove
 #include "lcd/ssd1306_commands.h"
 
+#if !defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) || !defined(CONFIG_SSD1306_CONTEXT_ENABLE)
 uint8_t s_ssd1306_invertByte = 0x00000000;
-extern uint16_t ssd1306_color;
+#endif
 const uint8_t *s_font6x8 = &ssd1306xled_font6x8[4];
-extern lcduint_t ssd1306_cursorX;
-extern lcduint_t ssd1306_cursorY;
-extern SFixedFontInfo s_fixedFont;
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
 extern uint8_t g_ssd1306_unicode;
 #endif
@@ -76,89 +74,147 @@ void ssd1306_clearScreen()
     ssd1306_intf.stop();
 }
 
-uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style)
+/** Number of glyphs, decoded at once by text output functions */
+#define SSD1306_TEXT_CHUNK_SIZE  16
+
+/* Lookup tables to scale 4 bits to 8 bits (x2) and 2 bits to 8 bits (x4) */
+static const PROGMEM uint8_t s_scale2x[16] =
 {
-    uint8_t i, j=0;
-    uint8_t text_index = 0;
-    uint8_t page_offset = 0;
-    uint8_t x = xpos;
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF,
+};
+
+static const PROGMEM uint8_t s_scale4x[4] = { 0x00, 0x0F, 0xF0, 0xFF };
+
+static uint8_t ssd1306_scaleFontByte(uint8_t data, uint8_t page_offset, uint8_t factor)
+{
+    // N=1  ->   right shift goes through 0, 4
+    // N=2  ->   right shift goes through 0, 2, 4, 6
+    // N=3  ->   right shift goes through 0, 1, 2, 3, 4, 5, 6, 7
+    data >>= ((page_offset & ((1<<factor) - 1))<<(3-factor));
+    switch (factor)
+    {
+        case 1: return pgm_read_byte(&s_scale2x[data & 0x0F]);
+        case 2: return pgm_read_byte(&s_scale4x[data & 0x03]);
+        default: return (data & 0x01) ? 0xFF : 0x00;
+    }
+}
+
+/*
+ * Prints text, decoding each glyph only once. Glyphs of single text line are
+ * decoded to the small array, then all display pages of the line are sent
+ * from this array.
+ */
+static uint8_t ssd1306_printFixedScaled(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style, uint8_t factor)
+{
+    SCharInfo glyphs[SSD1306_TEXT_CHUNK_SIZE];
+    uint8_t j = 0;
+    uint8_t x;
+    uint8_t pages = s_fixedFont.pages << factor;
     y >>= 3;
-    ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
     for(;;)
     {
-        uint8_t ldata;
-        if ((x > ssd1306_lcd.width - s_fixedFont.h.width) || (ch[j] == '\0'))
+        uint8_t line_end = 0;
+        x = xpos;
+        if (y >= (ssd1306_lcd.height >> 3))
         {
-            x = xpos;
-            y++;
-            if (y >= (ssd1306_lcd.height >> 3))
-            {
-                break;
-            }
-            page_offset++;
-            if (page_offset == s_fixedFont.pages)
+            break;
+        }
+        while (!line_end)
+        {
+            uint8_t count = 0;
+            uint8_t segment_x = x;
+            while (count < SSD1306_TEXT_CHUNK_SIZE)
             {
-                text_index = j;
-                page_offset = 0;
-                if (ch[j] == '\0')
+                if ((x > ssd1306_lcd.width - (s_fixedFont.h.width << factor)) || (ch[j] == '\0'))
                 {
+                    line_end = 1;
                     break;
                 }
+                uint16_t unicode;
+                do
+                {
+                    unicode = ssd1306_unicode16FromUtf8(ch[j]);
+                    j++;
+                } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+                ssd1306_getCharBitmap(unicode, &glyphs[count]);
+                x += ((glyphs[count].width + glyphs[count].spacing) << factor);
+                count++;
             }
-            else
+            if (!count)
             {
-                j = text_index;
+                break;
             }
-            ssd1306_intf.stop();
-            ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
-        }
-        uint16_t unicode;
-        do
-        {
-            unicode = ssd1306_unicode16FromUtf8(ch[j]);
-            j++;
-        } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
-        SCharInfo char_info;
-        ssd1306_getCharBitmap(unicode, &char_info);
-        ldata = 0;
-        x += char_info.width + char_info.spacing;
-        if (char_info.height > page_offset * 8)
-        {
-            char_info.glyph += page_offset * char_info.width;
-            for( i = char_info.width; i>0; i--)
+            for (uint8_t page_offset = 0; page_offset < pages; page_offset++)
             {
-                uint8_t data;
-                if ( style == STYLE_NORMAL )
-                {
-                    data = pgm_read_byte(&char_info.glyph[0]);
-                }
-                else if ( style == STYLE_BOLD )
+                if (y + page_offset >= (ssd1306_lcd.height >> 3))
                 {
-                    uint8_t temp = pgm_read_byte(&char_info.glyph[0]);
-                    data = temp | ldata;
-                    ldata = temp;
+                    break;
                 }
-                else
+                ssd1306_lcd.set_block(segment_x, y + page_offset, ssd1306_lcd.width - segment_x);
+                for (uint8_t n = 0; n < count; n++)
                 {
-                    uint8_t temp = pgm_read_byte(&char_info.glyph[1]);
-                    data = (temp & 0xF0) | ldata;
-                    ldata = (temp & 0x0F);
+                    uint8_t spacing = glyphs[n].spacing;
+                    if (glyphs[n].height > (page_offset >> factor) * 8)
+                    {
+                        const uint8_t *glyph = glyphs[n].glyph + (page_offset >> factor) * glyphs[n].width;
+                        uint8_t ldata = 0;
+                        for (uint8_t i = glyphs[n].width; i>0; i--)
+                        {
+                            uint8_t data;
+                            if ( style == STYLE_NORMAL )
+                            {
+                                data = pgm_read_byte(glyph);
+                            }
+                            else if ( style == STYLE_BOLD )
+                            {
+                                uint8_t temp = pgm_read_byte(glyph);
+                                data = temp | ldata;
+                                ldata = temp;
+                            }
+                            else
+                            {
+                                uint8_t temp = pgm_read_byte(glyph+1);
+                                data = (temp & 0xF0) | ldata;
+                                ldata = (temp & 0x0F);
+                            }
+                            if ( factor > 0 )
+                            {
+                                data = ssd1306_scaleFontByte(data, page_offset, factor);
+                            }
+                            for (uint8_t z=(1<<factor); z>0; z--)
+                            {
+                                ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+                            }
+                            glyph++;
+                        }
+                    }
+                    else
+                    {
+                        spacing += glyphs[n].width;
+                    }
+                    for (uint8_t i = 0; i < (spacing << factor); i++)
+                    {
+                        ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
+                    }
                 }
-                ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
-                char_info.glyph++;
+                ssd1306_intf.stop();
             }
         }
-        else
+        y += pages;
+        if (ch[j] == '\0')
         {
-            char_info.spacing += char_info.width;
+            break;
         }
-        for (i = 0; i < char_info.spacing; i++)
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
     }
-    ssd1306_intf.stop();
     return j;
 }
 
+uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style)
+{
+    return ssd1306_printFixedScaled(xpos, y, ch, style, 0);
+}
+
 uint8_t ssd1306_printFixed_oldStyle(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style)
 {
     uint8_t i, j=0;
@@ -316,103 +372,7 @@ uint8_t ssd1306_printFixed2x(uint8_t xpos, uint8_t y, const char ch[], EFontStyl
 
 uint8_t ssd1306_printFixedN(uint8_t xpos, uint8_t y, const char ch[], EFontStyle style, uint8_t factor)
 {
-    uint8_t i, j=0;
-    uint8_t text_index = 0;
-    uint8_t page_offset = 0;
-    uint8_t x = xpos;
-    y >>= 3;
-    ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
-    for(;;)
-    {
-        uint8_t ldata;
-        if( (x > ssd1306_lcd.width - (s_fixedFont.h.width << factor)) || (ch[j] == '\0') )
-        {
-            x = xpos;
-            y++;
-            if (y >= (ssd1306_lcd.height >> 3))
-            {
-                break;
-            }
-            page_offset++;
-            if (page_offset == (s_fixedFont.pages << factor))
-            {
-                text_index = j;
-                page_offset = 0;
-                if (ch[j] == '\0')
-                {
-                    break;
-                }
-            }
-            else
-            {
-                j = text_index;
-            }
-            ssd1306_intf.stop();
-            ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
-        }
-        uint16_t unicode;
-        do
-        {
-            unicode = ssd1306_unicode16FromUtf8(ch[j]);
-            j++;
-        } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
-        SCharInfo char_info;
-        ssd1306_getCharBitmap(unicode, &char_info);
-        ldata = 0;
-        x += ((char_info.width + char_info.spacing) << factor);
-        if (char_info.height > (page_offset >> factor) * 8)
-        {
-            char_info.glyph += (page_offset >> factor) * char_info.width;
-            for( i=char_info.width; i>0; i--)
-            {
-                uint8_t data;
-                if ( style == STYLE_NORMAL )
-                {
-                    data = pgm_read_byte(char_info.glyph);
-                }
-                else if ( style == STYLE_BOLD )
-                {
-                    uint8_t temp = pgm_read_byte(char_info.glyph);
-                    data = temp | ldata;
-                    ldata = temp;
-                }
-                else
-                {
-                    uint8_t temp = pgm_read_byte(char_info.glyph+1);
-                    data = (temp & 0xF0) | ldata;
-                    ldata = (temp & 0x0F);
-                }
-                if ( factor > 0 )
-                {
-                    uint8_t accum = 0;
-                    uint8_t mask = ~((0xFF) << (1<<factor));
-                    // N=0  ->   right shift is always 0
-                    // N=1  ->   right shift goes through 0, 4
-                    // N=2  ->   right shift goes through 0, 2, 4, 6
-                    // N=3  ->   right shift goes through 0, 1, 2, 3, 4, 5, 6, 7
-                    data >>= ((page_offset & ((1<<factor) - 1))<<(3-factor));
-                    for (uint8_t idx = 0; idx < 1<<(3-factor); idx++)
-                    {
-                         accum |= (((data>>idx) & 0x01) ? (mask<<(idx<<factor)) : 0);
-                    }
-                    data = accum;
-                }
-                for (uint8_t z=(1<<factor); z>0; z--)
-                {
-                    ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
-                }
-                char_info.glyph++;
-            }
-        }
-        else
-        {
-            char_info.spacing += char_info.width;
-        }
-        for (i = 0; i < (char_info.spacing << factor); i++)
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
-    }
-    ssd1306_intf.stop();
-    return j;
+    return ssd1306_printFixedScaled(xpos, y, ch, style, factor);
 }
 
 size_t ssd1306_write(uint8_t ch)
@@ -836,32 +796,26 @@ void ssd1306_drawBitmap1_4(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uin
 
 void ssd1306_drawXBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
 {
-    uint8_t i, j;
+    uint8_t i, j, k;
     lcduint_t pitch = (w + 7) >> 3;
     ssd1306_lcd.set_block(x, y, w);
     for(j=(h >> 3); j>0; j--)
     {
-        uint8_t bit = 0;
-        for(i=w;i>0;i--)
+        for(i=0; i<pitch; i++)
         {
-            uint8_t data = 0;
-            for (uint8_t k = 0; k<8; k++)
+            uint8_t block[8];
+            uint8_t count = (w - (i << 3)) < 8 ? (w - (i << 3)) : 8;
+            for (k = 0; k<8; k++)
             {
-                data |= ( ((pgm_read_byte(&buf[k*pitch]) >> bit) & 0x01) << k );
+                block[k] = pgm_read_byte(&buf[k*pitch + i]);
             }
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^data);
-            bit++;
-            if (bit >= 8)
+            ssd1306_transpose8x8(block);
+            for (k = 0; k<count; k++)
             {
-                buf++;
-                bit=0;
+                ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^block[k]);
             }
         }
-        if (bit)
-        {
-            buf++;
-        }
-        buf += pitch * 7;
+        buf += pitch * 8;
         ssd1306_lcd.next_page();
     }
     ssd1306_intf.stop();
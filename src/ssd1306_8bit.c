@@ -32,11 +32,6 @@
 #include "lcd/ssd1331_commands.h"
 #include "lcd/lcd_common.h"
 
-extern uint16_t ssd1306_color;
-extern uint8_t s_ssd1306_invertByte;
-extern lcduint_t ssd1306_cursorX;
-extern lcduint_t ssd1306_cursorY;
-extern SFixedFontInfo s_fixedFont;
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
 extern uint8_t g_ssd1306_unicode;
 #endif
@@ -115,6 +110,11 @@ void ssd1306_drawBufferEx8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcd
 
 void ssd1306_fillScreen8(uint8_t fill_Data)
 {
+    if (ssd1306_lcd.accel)
+    {
+        ssd1306_lcd.accel->fill_rect(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1, RGB8_TO_RGB16(fill_Data));
+        return;
+    }
     ssd1306_lcd.set_block(0, 0, 0);
     uint32_t count = (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height;
     while (count--)
@@ -126,6 +126,11 @@ void ssd1306_fillScreen8(uint8_t fill_Data)
 
 void ssd1306_clearScreen8(void)
 {
+    if (ssd1306_lcd.accel)
+    {
+        ssd1306_lcd.accel->clear_rect(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+        return;
+    }
     ssd1306_fillScreen8( 0x00 );
 }
 
@@ -167,6 +172,13 @@ void ssd1306_drawHLine8(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 
 void ssd1306_drawLine8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.accel && (x1 >= 0) && (y1 >= 0) && (x2 >= 0) && (y2 >= 0) &&
+        (x1 < (lcdint_t)ssd1306_lcd.width) && (x2 < (lcdint_t)ssd1306_lcd.width) &&
+        (y1 < (lcdint_t)ssd1306_lcd.height) && (y2 < (lcdint_t)ssd1306_lcd.height))
+    {
+        ssd1306_lcd.accel->draw_line(x1, y1, x2, y2, RGB8_TO_RGB16(ssd1306_color));
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
@@ -226,6 +238,20 @@ void ssd1306_fillRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
+    if (ssd1306_lcd.accel && (x2 >= 0) && (y2 >= 0) &&
+        (x1 < (lcdint_t)ssd1306_lcd.width) && (y1 < (lcdint_t)ssd1306_lcd.height))
+    {
+        /* Accelerator accepts only screen coordinates, so clip rectangle to the screen */
+        lcduint_t cx1 = x1 < 0 ? 0 : x1;
+        lcduint_t cy1 = y1 < 0 ? 0 : y1;
+        lcduint_t cx2 = x2 < (lcdint_t)ssd1306_lcd.width ? x2 : ssd1306_lcd.width - 1;
+        lcduint_t cy2 = y2 < (lcdint_t)ssd1306_lcd.height ? y2 : ssd1306_lcd.height - 1;
+        if ( (uint32_t)(cx2 - cx1 + 1) * (cy2 - cy1 + 1) >= SSD1306_ACCEL_MIN_PIXELS )
+        {
+            ssd1306_lcd.accel->fill_rect(cx1, cy1, cx2, cy2, RGB8_TO_RGB16(ssd1306_color));
+            return;
+        }
+    }
     ssd1306_lcd.set_block(x1, y1, x2 - x1 + 1);
     uint16_t count = (x2 - x1 + 1) * (y2 - y1 + 1);
     while (count--)
@@ -280,6 +306,12 @@ void ssd1306_drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
 
 void ssd1306_clearBlock8(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
+    if (ssd1306_lcd.accel && ((uint16_t)w * h >= SSD1306_ACCEL_MIN_PIXELS) &&
+        (x + w <= ssd1306_lcd.width) && (y + h <= ssd1306_lcd.height))
+    {
+        ssd1306_lcd.accel->clear_rect(x, y, x + w - 1, y + h - 1);
+        return;
+    }
     ssd1306_lcd.set_block(x, y, w);
     uint32_t count = w * h;
     while (count--)
@@ -24,9 +24,7 @@
 
 #include "ssd1306_console.h"
 
-extern lcduint_t ssd1306_cursorX;
-extern lcduint_t ssd1306_cursorY;
-extern SFixedFontInfo s_fixedFont;
+#include "ssd1306_context.h"
 
 #define SSD1306_MAX_SCAN_LINES  64
 
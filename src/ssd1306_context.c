@@ -0,0 +1,75 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_context.h"
+#include "intf/i2c/ssd1306_i2c_conf.h"
+#include <stddef.h>
+
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+
+extern void ssd1306_send_buffer_generic(const uint8_t* buffer, uint16_t size);
+
+static ssd1306_context_t s_defaultContext =
+{
+    .intf = { .send_buffer = ssd1306_send_buffer_generic },
+    .color = 0xFFFF,
+    .spi_cs = 4,
+    .spi_dc = 5,
+    .spi_clock = 8000000,
+    .bus = { .fd = -1, .sa = SSD1306_SA },
+    .remote = { .key_interval = 64 },
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+    .fb = { .fd = -1 },
+#endif
+};
+
+SSD1306_THREAD_LOCAL ssd1306_context_t *s_ssd1306_context = &s_defaultContext;
+
+void ssd1306_contextInit(ssd1306_context_t *ctx)
+{
+    memset(ctx, 0, sizeof(ssd1306_context_t));
+    ctx->intf.send_buffer = ssd1306_send_buffer_generic;
+    ctx->color = 0xFFFF;
+    ctx->spi_cs = 4;
+    ctx->spi_dc = 5;
+    ctx->spi_clock = 8000000;
+    ctx->bus.fd = -1;
+    ctx->bus.sa = SSD1306_SA;
+    ctx->remote.key_interval = 64;
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+    ctx->fb.fd = -1;
+#endif
+}
+
+void ssd1306_setContext(ssd1306_context_t *ctx)
+{
+    s_ssd1306_context = ctx ? ctx : &s_defaultContext;
+}
+
+ssd1306_context_t *ssd1306_getContext(void)
+{
+    return s_ssd1306_context;
+}
+
+#endif
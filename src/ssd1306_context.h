@@ -0,0 +1,243 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_context.h Display context: state of single display
+ */
+
+#ifndef _SSD1306_CONTEXT_H_
+#define _SSD1306_CONTEXT_H_
+
+#include "nano_gfx_types.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_CONTEXT_API CONTEXT: multiple displays support
+ * @{
+ *
+ * @brief Functions to work with several displays
+ *
+ * @details By default, all library functions work with single set of global state:
+ *          interface (ssd1306_intf), display driver (ssd1306_lcd), font, color and
+ *          cursor position. If CONFIG_SSD1306_CONTEXT_ENABLE is defined (it is disabled by
+ *          default, use CONTEXT=y option of Makefile) and platform supports threads (Linux),
+ *          this state is kept in ssd1306_context_t objects. Each thread
+ *          selects own context via ssd1306_setContext(), and all library functions, called
+ *          from that thread, work with selected display. Threads, which didn't select any context,
+ *          use default context, so applications for single display do not need any changes.
+ *
+ *          @code{.c}
+ *          ssd1306_context_t left;
+ *
+ *          void *leftDisplayThread(void *arg)
+ *          {
+ *              ssd1306_contextInit(&left);
+ *              ssd1306_setContext(&left);
+ *              ssd1306_128x64_i2c_initEx(1, 0x3C, NULL);
+ *              ssd1306_setFixedFont(ssd1306xled_font6x8);
+ *              ssd1306_printFixed(0, 0, "Left", STYLE_NORMAL);
+ *              return NULL;
+ *          }
+ *          @endcode
+ *
+ * @note Driver settings (rotation, start line, color order, offsets) and state of remote
+ *       and framebuffer displays are kept in the context too, so panels of the same type can have different
+ *       settings. Transfer
+ *       state of drivers (current RAM block position) is kept per thread, not per context,
+ *       so initialize and use each display from single thread, and don't switch contexts
+ *       in the middle of drawing.
+ */
+
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+
+#include "lcd/remote_display.h"
+
+/** Library state, which is local for each thread */
+#define SSD1306_THREAD_LOCAL  __thread
+
+/** State of remote display sender (see remote_display_init()) */
+typedef struct
+{
+    ssd1306_interface_t transport;  ///< interface, packets are sent to
+    uint8_t *current;               ///< content, drawn by the application
+    uint8_t *sent;                  ///< content, known to the receiver
+    lcduint_t column;               ///< current column of RAM block
+    lcduint_t page;                 ///< current page of RAM block
+    lcduint_t x1;                   ///< left column of RAM block
+    lcduint_t x2;                   ///< right column of RAM block
+    uint8_t seq;                    ///< sequence number of next packet
+    uint8_t key_interval;           ///< number of frames between key frames
+    uint8_t frames_to_key;          ///< number of frames till next key frame
+    uint16_t crc;                   ///< CRC of packet being sent
+    uint32_t bytes;                 ///< number of bytes, sent by last flush
+} ssd1306_remote_state_t;
+
+/** State of remote display receiver (see remote_receiver_init()) */
+typedef struct
+{
+    uint8_t *buffer;                ///< content of the display
+    lcduint_t width;                ///< width of the display
+    lcduint_t height;               ///< height of the display
+    uint8_t packet[REMOTE_DISPLAY_MAX_PACKET]; ///< packet being received
+    uint16_t len;                   ///< number of received packet bytes
+    uint8_t escape;                 ///< next byte is escaped
+    uint8_t overflow;               ///< packet is longer than buffer
+    uint8_t seq;                    ///< expected sequence number
+    uint8_t synced;                 ///< sequence number is known
+    uint32_t valid_pages;           ///< pages, received with key packets
+    remote_receiver_stats_t stats;  ///< receiver statistics
+} ssd1306_remote_rx_state_t;
+
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+/** State of Linux framebuffer display (see linux_fb_init()) */
+typedef struct
+{
+    int fd;                         ///< framebuffer device or file descriptor
+    uint8_t *map;                   ///< mapped memory
+    size_t map_size;                ///< size of mapped memory
+    uint8_t *fb;                    ///< pixel (0,0) in mapped memory
+    uint32_t line_length;           ///< length of single line in bytes
+    uint8_t bpp;                    ///< bits per pixel
+    lcduint_t x1;                   ///< left column of RAM block
+    lcduint_t x2;                   ///< right column of RAM block
+    lcduint_t column;               ///< current column
+    lcduint_t row;                  ///< current page in ssd1306 compatible mode, line in normal mode
+    uint8_t byte;                   ///< first byte of 16-bit pixel, sent via interface
+    uint8_t has_byte;               ///< first byte of 16-bit pixel is received
+    uint8_t red_offset;             ///< position of red component in 32-bit pixel
+    uint8_t green_offset;           ///< position of green component in 32-bit pixel
+    uint8_t blue_offset;            ///< position of blue component in 32-bit pixel
+} ssd1306_fb_state_t;
+#endif
+
+/** Describes state of single display */
+typedef struct
+{
+    /** communication interface of the display */
+    ssd1306_interface_t intf;
+    /** display driver */
+    ssd1306_lcd_t lcd;
+    /** active font */
+    SFixedFontInfo font;
+    /** function to read glyphs of active font */
+    void (*get_char_bitmap)(uint16_t unicode, SCharInfo *info);
+    /** color for monochrome operations */
+    uint16_t color;
+    /** cursor x position for print functions */
+    lcduint_t cursor_x;
+    /** cursor y position for print functions */
+    lcduint_t cursor_y;
+    /** invert mask for 1-bit operations */
+    uint8_t invert_byte;
+    /** chip enable pin for spi interface */
+    int8_t spi_cs;
+    /** data/command pin for spi interface */
+    int8_t spi_dc;
+    /** spi clock frequency */
+    uint32_t spi_clock;
+    /** platform specific bus state */
+    ssd1306_platform_bus_t bus;
+    /** rotation and mode bits of color display drivers */
+    uint8_t lcd_rotation;
+    /** RGB/BGR color order bit of il9163, st7735 and ili9341 drivers */
+    uint8_t lcd_rgb_bit;
+    /** output rotation of ili9341 driver */
+    uint8_t lcd_rotate_output;
+    /** display start line of ssd1306 driver */
+    uint8_t lcd_start_line;
+    /** horizontal GDRAM offset of il9163 and st7735 drivers */
+    lcdint_t lcd_offset_x;
+    /** vertical GDRAM offset of il9163 and st7735 drivers */
+    lcdint_t lcd_offset_y;
+    /** remote display sender */
+    ssd1306_remote_state_t remote;
+    /** remote display receiver */
+    ssd1306_remote_rx_state_t remote_rx;
+#if defined(CONFIG_PLATFORM_FB_AVAILABLE)
+    /** Linux framebuffer display */
+    ssd1306_fb_state_t fb;
+#endif
+} ssd1306_context_t;
+
+/** Context, selected for the current thread. Use ssd1306_setContext() to change it */
+extern SSD1306_THREAD_LOCAL ssd1306_context_t *s_ssd1306_context;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define ssd1306_intf            (s_ssd1306_context->intf)
+#define ssd1306_lcd             (s_ssd1306_context->lcd)
+#define s_fixedFont             (s_ssd1306_context->font)
+#define ssd1306_color           (s_ssd1306_context->color)
+#define ssd1306_cursorX         (s_ssd1306_context->cursor_x)
+#define ssd1306_cursorY         (s_ssd1306_context->cursor_y)
+#define s_ssd1306_invertByte    (s_ssd1306_context->invert_byte)
+#define s_ssd1306_cs            (s_ssd1306_context->spi_cs)
+#define s_ssd1306_dc            (s_ssd1306_context->spi_dc)
+#define s_ssd1306_spi_clock     (s_ssd1306_context->spi_clock)
+#endif
+
+/**
+ * Initializes context with default values. Context must be initialized
+ * before passing it to ssd1306_setContext().
+ * @param ctx context to initialize
+ */
+void ssd1306_contextInit(ssd1306_context_t *ctx);
+
+/**
+ * Selects context for all library functions, called from the current thread.
+ * @param ctx context to select or NULL to select default context
+ */
+void ssd1306_setContext(ssd1306_context_t *ctx);
+
+/**
+ * Returns context, selected for the current thread.
+ */
+ssd1306_context_t *ssd1306_getContext(void);
+
+#else
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define SSD1306_THREAD_LOCAL
+
+extern SFixedFontInfo s_fixedFont;
+extern uint16_t ssd1306_color;
+extern lcduint_t ssd1306_cursorX;
+extern lcduint_t ssd1306_cursorY;
+extern uint8_t s_ssd1306_invertByte;
+#endif
+
+#endif
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_CONTEXT_H_
@@ -0,0 +1,228 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_dither.h"
+#include "ssd1306_hal/io.h"
+#include <string.h>
+
+/** Number of RGB565 pixels, converted to gray at once */
+#define SSD1306_DITHER_CHUNK  32
+
+/* 8x8 Bayer matrix, scaled to 0-255 range: threshold = 4 * index + 2 */
+static const uint8_t s_bayer[8][8] =
+{
+    {   2, 130,  34, 162,  10, 138,  42, 170 },
+    { 194,  66, 226,  98, 202,  74, 234, 106 },
+    {  50, 178,  18, 146,  58, 186,  26, 154 },
+    { 242, 114, 210,  82, 250, 122, 218,  90 },
+    {  14, 142,  46, 174,   6, 134,  38, 166 },
+    { 206,  78, 238, 110, 198,  70, 230, 102 },
+    {  62, 190,  30, 158,  54, 182,  22, 150 },
+    { 254, 126, 222,  94, 246, 118, 214,  86 },
+};
+
+void ssd1306_ditherInit(ssd1306_dither_t *dither, uint8_t *buffer, lcduint_t width, lcduint_t height,
+                        uint8_t bpp, uint8_t method, int16_t *errors)
+{
+    dither->buffer = buffer;
+    dither->errors = errors;
+    dither->width = width;
+    dither->height = height;
+    dither->row = 0;
+    dither->x = 0;
+    dither->right = 0;
+    dither->below[0] = 0;
+    dither->below[1] = 0;
+    dither->bpp = bpp;
+    dither->method = method;
+    if ( method == SSD1306_DITHER_FLOYD_STEINBERG )
+    {
+        memset(errors, 0, (width + 1) * sizeof(int16_t));
+    }
+}
+
+/*
+ * Ordered dithering. Pixel is compared with threshold from the matrix row, and
+ * the result is taken from the sign bit of the difference, so the loops have no
+ * branches and process independent pixels, which compilers can vectorize.
+ */
+static void ditherBayer1(ssd1306_dither_t *dither, const uint8_t *src, lcduint_t count)
+{
+    const uint8_t *threshold = s_bayer[dither->row & 7];
+    uint8_t shift = dither->row & 7;
+    uint8_t mask = ~(1 << shift);
+    uint8_t *dst = dither->buffer + ((dither->row % dither->height) >> 3) * dither->width + dither->x;
+    lcduint_t x0 = dither->x;
+    for (lcduint_t i = 0; i < count; i++)
+    {
+        uint8_t bit = ((int16_t)threshold[(x0 + i) & 7] - src[i]) >> 15 & 1;
+        dst[i] = (dst[i] & mask) | (bit << shift);
+    }
+}
+
+static void ditherBayer4(ssd1306_dither_t *dither, const uint8_t *src, lcduint_t count)
+{
+    const uint8_t *threshold = s_bayer[dither->row & 7];
+    uint8_t *dst = dither->buffer + (dither->row % dither->height) * ((dither->width + 1) >> 1) + (dither->x >> 1);
+    lcduint_t x0 = dither->x;
+    lcduint_t i = 0;
+    /* Scale 0-255 to 0-256, so that 15 * gray + threshold covers all 16 levels */
+    for (; i + 1 < count; i += 2)
+    {
+        uint16_t g0 = src[i] + (src[i] >> 7);
+        uint16_t g1 = src[i + 1] + (src[i + 1] >> 7);
+        uint8_t q0 = (g0 * 15 + threshold[(x0 + i) & 7]) >> 8;
+        uint8_t q1 = (g1 * 15 + threshold[(x0 + i + 1) & 7]) >> 8;
+        dst[i >> 1] = q0 | (q1 << 4);
+    }
+    /* Last pixel of odd width row occupies low half of the byte */
+    if ( i < count )
+    {
+        uint16_t g0 = src[i] + (src[i] >> 7);
+        uint8_t q0 = (g0 * 15 + threshold[(x0 + i) & 7]) >> 8;
+        dst[i >> 1] = (dst[i >> 1] & 0xF0) | q0;
+    }
+}
+
+/*
+ * Floyd-Steinberg error diffusion. Errors are kept in 1/16 units. errors[x + 1]
+ * holds error for pixel x of current row, and errors, diffused to the row below,
+ * are stored to the same array one pixel behind, when they are complete.
+ */
+static inline int16_t ditherValue(const int16_t *errors, int16_t right, uint8_t gray)
+{
+    int16_t value = gray + ((errors[1] + right + 8) >> 4);
+    value = value < 0 ? 0 : value;
+    return value > 255 ? 255 : value;
+}
+
+static void ditherFloydSteinberg1(ssd1306_dither_t *dither, const uint8_t *src, lcduint_t count)
+{
+    int16_t *errors = dither->errors + dither->x;
+    int16_t right = dither->right;
+    int16_t below0 = dither->below[0];
+    int16_t below1 = dither->below[1];
+    uint8_t shift = dither->row & 7;
+    uint8_t mask = ~(1 << shift);
+    uint8_t *dst = dither->buffer + ((dither->row % dither->height) >> 3) * dither->width + dither->x;
+    for (lcduint_t i = 0; i < count; i++)
+    {
+        int16_t value = ditherValue(&errors[i], right, src[i]);
+        uint8_t bit = value >> 7;
+        int16_t error = value - (bit ? 255 : 0);
+        dst[i] = (dst[i] & mask) | (bit << shift);
+        errors[i] = below0 + error * 3;
+        below0 = below1 + error * 5;
+        below1 = error;
+        right = error * 7;
+    }
+    dither->right = right;
+    dither->below[0] = below0;
+    dither->below[1] = below1;
+}
+
+static void ditherFloydSteinberg4(ssd1306_dither_t *dither, const uint8_t *src, lcduint_t count)
+{
+    int16_t *errors = dither->errors + dither->x;
+    int16_t right = dither->right;
+    int16_t below0 = dither->below[0];
+    int16_t below1 = dither->below[1];
+    uint8_t *dst = dither->buffer + (dither->row % dither->height) * ((dither->width + 1) >> 1);
+    lcduint_t x0 = dither->x;
+    for (lcduint_t i = 0; i < count; i++)
+    {
+        int16_t value = ditherValue(&errors[i], right, src[i]);
+        /* Nearest of 16 levels 0, 17, 34, ... 255 */
+        uint8_t q = ((value + (value >> 7)) * 15 + 128) >> 8;
+        int16_t error = value - q * 17;
+        uint8_t shift = ((x0 + i) & 1) << 2;
+        dst[(x0 + i) >> 1] = (dst[(x0 + i) >> 1] & ~(0x0F << shift)) | (q << shift);
+        errors[i] = below0 + error * 3;
+        below0 = below1 + error * 5;
+        below1 = error;
+        right = error * 7;
+    }
+    dither->right = right;
+    dither->below[0] = below0;
+    dither->below[1] = below1;
+}
+
+static void ditherSpan(ssd1306_dither_t *dither, const uint8_t *src, lcduint_t count)
+{
+    if ( dither->method == SSD1306_DITHER_FLOYD_STEINBERG )
+    {
+        if ( dither->bpp == 1 ) ditherFloydSteinberg1(dither, src, count);
+        else ditherFloydSteinberg4(dither, src, count);
+    }
+    else
+    {
+        if ( dither->bpp == 1 ) ditherBayer1(dither, src, count);
+        else ditherBayer4(dither, src, count);
+    }
+    dither->x += count;
+}
+
+static uint8_t ditherRowEnd(ssd1306_dither_t *dither)
+{
+    if ( dither->method == SSD1306_DITHER_FLOYD_STEINBERG )
+    {
+        dither->errors[dither->width] = dither->below[0];
+        dither->right = 0;
+        dither->below[0] = 0;
+        dither->below[1] = 0;
+    }
+    dither->x = 0;
+    dither->row++;
+    return (dither->row % dither->height) == 0;
+}
+
+uint8_t ssd1306_ditherGray8Row(ssd1306_dither_t *dither, const uint8_t *src)
+{
+    ditherSpan(dither, src, dither->width);
+    return ditherRowEnd(dither);
+}
+
+uint8_t ssd1306_ditherRgb565Row(ssd1306_dither_t *dither, const uint8_t *src)
+{
+    uint8_t gray[SSD1306_DITHER_CHUNK];
+    while ( dither->x < dither->width )
+    {
+        lcduint_t count = dither->width - dither->x;
+        if ( count > SSD1306_DITHER_CHUNK )
+        {
+            count = SSD1306_DITHER_CHUNK;
+        }
+        for (lcduint_t i = 0; i < count; i++)
+        {
+            uint16_t color = (src[0] << 8) | src[1];
+            uint16_t r = ((color >> 8) & 0xF8) | (color >> 13);
+            uint16_t g = ((color >> 3) & 0xFC) | ((color >> 9) & 0x03);
+            uint16_t b = ((color << 3) & 0xF8) | ((color >> 2) & 0x07);
+            gray[i] = (r * 77 + g * 150 + b * 29) >> 8;
+            src += 2;
+        }
+        ditherSpan(dither, gray, count);
+    }
+    return ditherRowEnd(dither);
+}
@@ -0,0 +1,128 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_dither.h Dithering of gray and color images for monochrome displays
+ */
+
+#ifndef _SSD1306_DITHER_H_
+#define _SSD1306_DITHER_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup DITHER_API Dithering of gray and color images
+ * @{
+ *
+ * @brief Converts 8-bit gray and RGB565 images to 1-bit and 4-bit formats.
+ *
+ * @details Dithering engine accepts source image row by row, so the image never needs
+ *          to be completely loaded to RAM: rows can come from camera, file or network.
+ *          Output rows are written to destination buffer, which can hold either full
+ *          image or only part of it. In the latter case the buffer is used as ring band:
+ *          when it is filled, ssd1306_ditherGray8Row() returns non-zero value, and
+ *          the application should output the band to the display, for example with
+ *          ssd1306_drawBuffer(), before passing next row.
+ *
+ *          Destination formats:
+ *          - 1 bit per pixel, ssd1306 page layout (8 vertical pixels per byte), the
+ *            same as NanoCanvas1 buffer. Buffer height must be multiple of 8.
+ *          - 4 bits per pixel, 2 pixels per byte, even pixel in low nibble, the same
+ *            as NanoCanvas1_4 buffer. Each row takes (width + 1) / 2 bytes.
+ *
+ *          Ordered dithering uses 8x8 Bayer threshold matrix. It is the fastest method
+ *          and doesn't need any additional memory, and its regular pattern doesn't
+ *          flicker on animated content. Floyd-Steinberg error diffusion gives better
+ *          looking still images, but needs error buffer of (width + 1) 16-bit values.
+ */
+
+/** Ordered dithering with 8x8 Bayer matrix */
+#define SSD1306_DITHER_BAYER            0
+/** Floyd-Steinberg error diffusion */
+#define SSD1306_DITHER_FLOYD_STEINBERG  1
+
+/** Dithering state, passed to all dithering functions */
+typedef struct
+{
+    uint8_t   *buffer;  ///< destination buffer
+    int16_t   *errors;  ///< Floyd-Steinberg error row, width + 1 elements
+    lcduint_t width;    ///< width of image in pixels
+    lcduint_t height;   ///< height of destination buffer in pixels
+    lcduint_t row;      ///< number of source rows, processed since ssd1306_ditherInit()
+    lcduint_t x;        ///< next pixel of current row
+    int16_t   right;    ///< error, diffused to next pixel in current row
+    int16_t   below[2]; ///< errors, diffused to the row below, not yet stored to error row
+    uint8_t   bpp;      ///< destination bits per pixel: 1 or 4
+    uint8_t   method;   ///< SSD1306_DITHER_BAYER or SSD1306_DITHER_FLOYD_STEINBERG
+} ssd1306_dither_t;
+
+/**
+ * Prepares dithering state for new image.
+ *
+ * @param dither dithering state to init
+ * @param buffer destination buffer, width * height / 8 bytes for 1 bpp,
+ *        (width + 1) / 2 * height bytes for 4 bpp (rows start at byte boundary)
+ * @param width width of image in pixels
+ * @param height height of destination buffer in pixels. It can be less than height
+ *        of the image, then the buffer is filled again from the beginning when full.
+ * @param bpp destination format: 1 or 4 bits per pixel
+ * @param method SSD1306_DITHER_BAYER or SSD1306_DITHER_FLOYD_STEINBERG
+ * @param errors error row of (width + 1) elements for SSD1306_DITHER_FLOYD_STEINBERG,
+ *        can be NULL for SSD1306_DITHER_BAYER
+ */
+void ssd1306_ditherInit(ssd1306_dither_t *dither, uint8_t *buffer, lcduint_t width, lcduint_t height,
+                        uint8_t bpp, uint8_t method, int16_t *errors);
+
+/**
+ * Dithers next row of 8-bit gray image (0 - black, 255 - white).
+ *
+ * @param dither dithering state
+ * @param src row of width pixels
+ * @return 1 if destination buffer is filled, 0 otherwise
+ */
+uint8_t ssd1306_ditherGray8Row(ssd1306_dither_t *dither, const uint8_t *src);
+
+/**
+ * Dithers next row of RGB565 image. Each pixel takes 2 bytes, most significant
+ * byte first, the same as in NanoCanvas16 buffer. Colors are converted to luminance
+ * using ITU-R BT.601 weights.
+ *
+ * @param dither dithering state
+ * @param src row of width pixels
+ * @return 1 if destination buffer is filled, 0 otherwise
+ */
+uint8_t ssd1306_ditherRgb565Row(ssd1306_dither_t *dither, const uint8_t *src);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -33,6 +33,7 @@
 #include "intf/spi/ssd1306_spi.h"
 #include "intf/ssd1306_interface.h"
 #include "ssd1306_hal/io.h"
+#include "ssd1306_trace.h"
 #include "nano_gfx_types.h"
 
 enum
@@ -43,14 +44,18 @@ enum
     SSD1306_SQUIX_FORMAT     = 0x03,
 };
 
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE) && defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_ssd1306_getCharBitmap (s_ssd1306_context->get_char_bitmap)
+#else
 uint16_t ssd1306_color = 0xFFFF;
 lcduint_t ssd1306_cursorX = 0;
 lcduint_t ssd1306_cursorY = 0;
 SFixedFontInfo s_fixedFont = {}; //{ { 0 }, 0 };
+static void (*s_ssd1306_getCharBitmap)(uint16_t unicode, SCharInfo *info) = NULL;
+#endif
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
 uint8_t g_ssd1306_unicode = 1;
 #endif
-static void (*s_ssd1306_getCharBitmap)(uint16_t unicode, SCharInfo *info) = NULL;
 
 static const uint8_t *ssd1306_getCharGlyph(char ch);
 static const uint8_t *ssd1306_getU16CharGlyph(uint16_t unicode);
@@ -92,7 +97,9 @@ void ssd1306_setSecondaryFont(const uint8_t * progmemUnicode)
 
 void ssd1306_getCharBitmap(uint16_t unicode, SCharInfo *info)
 {
-    return s_ssd1306_getCharBitmap( unicode, info );
+    SSD1306_TRACE_BEGIN("font", "getCharBitmap");
+    s_ssd1306_getCharBitmap( unicode, info );
+    SSD1306_TRACE_END();
 }
 
 uint16_t ssd1306_unicode16FromUtf8(uint8_t ch)
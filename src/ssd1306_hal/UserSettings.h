@@ -89,6 +89,35 @@
  */
 #define CONFIG_SSD1306_UNICODE_ENABLE
 
+/**
+ * Define this macro to keep display state in context objects, selected per thread
+ * (see ssd1306_setContext()). Disabled by default, because all access to ssd1306_lcd
+ * and ssd1306_intf goes through thread local pointer. Applicable only for the
+ * platforms with thread support (Linux).
+ */
+#ifndef CONFIG_SSD1306_CONTEXT_ENABLE
+//#define CONFIG_SSD1306_CONTEXT_ENABLE
+#endif
+
+/**
+ * Define this macro to compile timeline trace points into the library (see ssd1306_trace.h).
+ * Trace points are compiled out by default. Applicable only for the platforms, which
+ * can write trace files (Linux).
+ */
+#ifndef CONFIG_SSD1306_TRACE_ENABLE
+//#define CONFIG_SSD1306_TRACE_ENABLE
+#endif
+
+/**
+ * Define this macro to make NanoEngine skip sending of tiles, which content is the same as
+ * the content sent to the same display position last time. Engine keeps 32-bit hash for each
+ * tile position, so the option costs NE_MAX_TILES_NUM * 16 * 4 + NE_MAX_TILES_NUM * 2 bytes
+ * of RAM (1088 bytes for 32x32 tiles, 4352 bytes for 8x8 tiles).
+ */
+#ifndef CONFIG_NANO_ENGINE_TILE_HASH_ENABLE
+//#define CONFIG_NANO_ENGINE_TILE_HASH_ENABLE
+#endif
+
 /**
  * @}
  */
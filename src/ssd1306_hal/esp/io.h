@@ -74,10 +74,7 @@ static inline int  analogRead(int pin)    // analogRead()
 
 uint32_t millis(void);
 
-static inline uint32_t micros(void)       // micros()
-{
-    return 0;
-};
+uint32_t micros(void);
 
 void delay(uint32_t ms);
 
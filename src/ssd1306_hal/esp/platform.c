@@ -31,6 +31,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 
 #if 1
 
@@ -68,6 +69,11 @@ uint32_t millis(void)
     return xTaskGetTickCount() * portTICK_PERIOD_MS;
 }
 
+uint32_t micros(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
 void delay(uint32_t ms)     // delay()
 {
     vTaskDelay(ms / portTICK_PERIOD_MS);
@@ -31,6 +31,18 @@
 
 #define CONFIG_PLATFORM_I2C_AVAILABLE
 #define CONFIG_PLATFORM_SPI_AVAILABLE
+#if !defined(__KERNEL__)
+#define CONFIG_PLATFORM_CONTEXT_AVAILABLE
+#endif
+#if !defined(__KERNEL__) && !defined(SDL_EMULATION)
+#define CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE
+#endif
+#if !defined(__KERNEL__)
+#define CONFIG_PLATFORM_RECORDER_AVAILABLE
+#define CONFIG_PLATFORM_UART_AVAILABLE
+#define CONFIG_PLATFORM_TRACE_AVAILABLE
+#define CONFIG_PLATFORM_FB_AVAILABLE
+#endif
 
 
 #if defined(SDL_EMULATION)  // SDL Emulation mode includes
@@ -49,6 +61,17 @@
 #include <string.h>
 #endif
 
+#if defined(CONFIG_PLATFORM_CONTEXT_AVAILABLE)
+/** Linux i2c/spi bus state, kept in display context */
+typedef struct
+{
+    int      fd;            ///< i2c-dev or spidev file descriptor
+    uint8_t  sa;            ///< i2c address of display
+    uint16_t size;          ///< number of bytes, collected in buffer
+    uint8_t  buffer[1024];  ///< bytes, collected for single bus transfer
+} ssd1306_platform_bus_t;
+#endif
+
 /** Standard defines */
 #define LOW  0
 #define HIGH 1
@@ -99,6 +122,102 @@ void pinMode(int pin, int mode);
 static inline int  digitalRead(int pin) { return LOW; };
 #endif
 
+#if defined(CONFIG_PLATFORM_GPIO_EVENTS_AVAILABLE)
+/** Maximum number of gpio pins, watched by gpio events thread */
+#define SSD1306_GPIO_EVENTS_MAX_PINS   8
+/** Number of events, which can be stored in gpio events queue */
+#define SSD1306_GPIO_EVENTS_QUEUE_SIZE 16
+
+/** Debounced gpio pin state change */
+typedef struct
+{
+    uint8_t  index;     ///< index of pin in the array, passed to ssd1306_platform_gpioEventsStart()
+    uint8_t  level;     ///< new pin level: HIGH or LOW
+    uint32_t ts;        ///< timestamp of the change in milliseconds, see millis()
+} ssd1306_gpio_event_t;
+
+/**
+ * Starts background thread, waiting for edge interrupts on specified gpio pins.
+ * Each pin is exported via sysfs, configured as input with "both" edges, and
+ * its level is debounced in software. Pins set to 0 are not watched.
+ * @param pins array of gpio pin numbers
+ * @param count number of pins in array [1-SSD1306_GPIO_EVENTS_MAX_PINS]
+ * @param debounceMs time in milliseconds, pin level must be stable to be accepted
+ * @return 0 on success, negative value if edge events are not supported for the pins
+ */
+int ssd1306_platform_gpioEventsStart(const uint8_t *pins, uint8_t count, uint16_t debounceMs);
+
+/**
+ * Returns debounced state of watched pins. Bit N is set, if pin with index N
+ * in array, passed to ssd1306_platform_gpioEventsStart(), has HIGH level.
+ * The function doesn't access gpio and can be called at any rate.
+ */
+uint8_t ssd1306_platform_gpioEventsState(void);
+
+/**
+ * Reads next event from gpio events queue. Events, not read in time, are lost
+ * when queue overflows, but pin state is always available via
+ * ssd1306_platform_gpioEventsState().
+ * @param event pointer to structure to fill
+ * @return 1 if event is read, 0 if queue is empty
+ */
+int ssd1306_platform_gpioEventsRead(ssd1306_gpio_event_t *event);
+
+/**
+ * Stops gpio events thread and closes all pin descriptors.
+ */
+void ssd1306_platform_gpioEventsStop(void);
+#endif
+
+#if defined(CONFIG_PLATFORM_UART_AVAILABLE)
+/**
+ * Initializes ssd1306_intf to send data over serial device (tty, pty, usb-serial).
+ * Data format is compatible with ssd1306_uartInit_Builtin(): ssd1306_intf.stop()
+ * sends 0x7E byte, and 0x7E, 0x7D bytes are escaped with 0x7D followed by byte ^ 0x20.
+ * @param device path to serial device, for example, /dev/ttyUSB0
+ * @param baud baud rate, 0 for 115200. Standard termios rates from 1200 to 921600 are
+ *        supported, and 500000-3000000 if platform defines them
+ * @return file descriptor of opened device, or -1 on error or unsupported baud rate
+ */
+int ssd1306_platform_uartInit(const char *device, uint32_t baud);
+#endif
+
+#if !defined(SDL_EMULATION)
+/**
+ * Opens i2c-dev bus and selects slave device. Used by ssd1306_platform_i2cInit()
+ * and by compile-time interface policies (see nano_engine/display.h).
+ * @param busId i2c bus number (/dev/i2c-busId), -1 for default bus 1
+ * @param sa i2c address of display, 0 for SSD1306_SA
+ * @return file descriptor of the bus, or -1 on error
+ */
+int ssd1306_platform_i2cOpen(int8_t busId, uint8_t sa);
+
+/**
+ * Writes block of bytes to i2c bus as single transaction.
+ * @param fd file descriptor, returned by ssd1306_platform_i2cOpen()
+ * @param buffer bytes to write
+ * @param size number of bytes
+ */
+void ssd1306_platform_i2cWrite(int fd, const uint8_t *buffer, uint16_t size);
+
+/**
+ * Opens and configures spidev device (mode 0, 8 bits per word).
+ * @param busId spi bus number, -1 for default bus 0
+ * @param ces chip select number (/dev/spidevBUS.CES), -1 for default 0
+ * @param frequency spi clock frequency in Hz
+ * @return file descriptor of the device, or -1 on error
+ */
+int ssd1306_platform_spiOpen(int8_t busId, int8_t ces, uint32_t frequency);
+
+/**
+ * Sends block of bytes to spidev device as single spi message.
+ * @param fd file descriptor, returned by ssd1306_platform_spiOpen()
+ * @param buffer bytes to send
+ * @param size number of bytes
+ */
+void ssd1306_platform_spiWrite(int fd, const uint8_t *buffer, uint16_t size);
+#endif
+
 #endif
 
 #if defined(SDL_EMULATION)
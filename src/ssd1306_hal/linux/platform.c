@@ -40,6 +40,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <linux/i2c-dev.h>
 #include <linux/spi/spidev.h>
 
@@ -250,6 +252,263 @@ void digitalWrite(int pin, int level)
     gpio_write( pin, level );
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+//                        LINUX GPIO EVENTS IMPLEMENTATION
+//////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    int      fd;        // descriptor of sysfs value file, -1 if pin is not watched
+    uint8_t  raw;       // last level, read from sysfs
+    uint32_t changeTs;  // timestamp of last edge on the pin
+} gpio_event_pin_t;
+
+static gpio_event_pin_t s_event_pins[SSD1306_GPIO_EVENTS_MAX_PINS];
+static uint8_t   s_event_pins_count = 0;
+static uint16_t  s_event_debounce = 0;
+static int       s_event_wakeup[2] = { -1, -1 };
+static pthread_t s_event_thread;
+/* Debounced state: written by events thread, read by application */
+static uint8_t   s_event_state = 0;
+/* Single producer, single consumer queue: head is written by events thread only, *
+ * tail is written by reader only. */
+static ssd1306_gpio_event_t s_event_queue[SSD1306_GPIO_EVENTS_QUEUE_SIZE];
+static uint8_t   s_event_head = 0;
+static uint8_t   s_event_tail = 0;
+
+static int gpio_edge(int pin, const char *edge)
+{
+    char path[64];
+    int fd;
+
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/edge", pin);
+    fd = open(path, O_WRONLY);
+    if (-1 == fd)
+    {
+        fprintf(stderr, "Failed to set gpio pin edge[%d]: %s!\n",
+                pin, strerror(errno));
+        return(-1);
+    }
+    if (write(fd, edge, strlen(edge)) < 0)
+    {
+        fprintf(stderr, "Failed to set gpio pin edge[%d]: %s!\n",
+                pin, strerror(errno));
+        close(fd);
+        return(-1);
+    }
+    close(fd);
+    return(0);
+}
+
+static int gpio_read_fd(int fd)
+{
+    char value;
+    /* Reading value file also acknowledges pending edge event */
+    if ((lseek(fd, 0, SEEK_SET) < 0) || (read(fd, &value, 1) != 1))
+    {
+        return -1;
+    }
+    return value == '1' ? HIGH : LOW;
+}
+
+static void gpio_events_push(uint8_t index, uint8_t level, uint32_t ts)
+{
+    uint8_t head = s_event_head;
+    uint8_t next = (head + 1) % SSD1306_GPIO_EVENTS_QUEUE_SIZE;
+    if (next == __atomic_load_n(&s_event_tail, __ATOMIC_ACQUIRE))
+    {
+        /* Queue is full, the event is dropped. State bitmask is still valid */
+        return;
+    }
+    s_event_queue[head].index = index;
+    s_event_queue[head].level = level;
+    s_event_queue[head].ts = ts;
+    __atomic_store_n(&s_event_head, next, __ATOMIC_RELEASE);
+}
+
+static void *gpio_events_thread(void *arg)
+{
+    struct pollfd fds[SSD1306_GPIO_EVENTS_MAX_PINS + 1];
+    uint8_t i;
+
+    fds[0].fd = s_event_wakeup[0];
+    fds[0].events = POLLIN;
+    for (i = 0; i < s_event_pins_count; i++)
+    {
+        fds[i + 1].fd = s_event_pins[i].fd;
+        fds[i + 1].events = POLLPRI | POLLERR;
+    }
+    for(;;)
+    {
+        uint8_t state = __atomic_load_n(&s_event_state, __ATOMIC_RELAXED);
+        uint32_t ts = millis();
+        int timeout = -1;
+        /* Accept levels, which are stable for debounce period, and wait for the rest */
+        for (i = 0; i < s_event_pins_count; i++)
+        {
+            uint8_t bit = 1 << i;
+            if ((s_event_pins[i].fd < 0) || (((state & bit) ? HIGH : LOW) == s_event_pins[i].raw))
+            {
+                continue;
+            }
+            uint32_t elapsed = ts - s_event_pins[i].changeTs;
+            if ( elapsed >= s_event_debounce )
+            {
+                state ^= bit;
+                __atomic_store_n(&s_event_state, state, __ATOMIC_RELAXED);
+                gpio_events_push(i, s_event_pins[i].raw, ts);
+            }
+            else if ((timeout < 0) || (s_event_debounce - elapsed < (uint32_t)timeout))
+            {
+                timeout = s_event_debounce - elapsed;
+            }
+        }
+        if (poll(fds, s_event_pins_count + 1, timeout) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(stderr, "Failed to wait for gpio events: %s!\n", strerror(errno));
+            break;
+        }
+        if (fds[0].revents)
+        {
+            break;
+        }
+        ts = millis();
+        for (i = 0; i < s_event_pins_count; i++)
+        {
+            if (fds[i + 1].revents & (POLLPRI | POLLERR))
+            {
+                int level = gpio_read_fd(s_event_pins[i].fd);
+                if (level >= 0)
+                {
+                    s_event_pins[i].raw = level;
+                }
+                s_event_pins[i].changeTs = ts;
+            }
+        }
+    }
+    return NULL;
+}
+
+int ssd1306_platform_gpioEventsStart(const uint8_t *pins, uint8_t count, uint16_t debounceMs)
+{
+    uint8_t state = 0;
+    uint8_t i;
+
+    ssd1306_platform_gpioEventsStop();
+    if ((count == 0) || (count > SSD1306_GPIO_EVENTS_MAX_PINS))
+    {
+        return -1;
+    }
+    s_event_pins_count = count;
+    s_event_debounce = debounceMs;
+    for (i = 0; i < count; i++)
+    {
+        s_event_pins[i].fd = -1;
+    }
+    for (i = 0; i < count; i++)
+    {
+        char path[64];
+        if (!pins[i])
+        {
+            continue;
+        }
+        pinMode(pins[i], INPUT);
+        if (gpio_edge(pins[i], "both") < 0)
+        {
+            goto error;
+        }
+        snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pins[i]);
+        s_event_pins[i].fd = open(path, O_RDONLY | O_NONBLOCK);
+        if (s_event_pins[i].fd < 0)
+        {
+            fprintf(stderr, "Failed to open gpio pin value[%d]: %s!\n",
+                    pins[i], strerror(errno));
+            goto error;
+        }
+        s_event_pins[i].raw = gpio_read_fd(s_event_pins[i].fd) == HIGH ? HIGH : LOW;
+        s_event_pins[i].changeTs = millis();
+        if (s_event_pins[i].raw == HIGH)
+        {
+            state |= (1 << i);
+        }
+    }
+    s_event_head = 0;
+    s_event_tail = 0;
+    __atomic_store_n(&s_event_state, state, __ATOMIC_RELAXED);
+    if (pipe(s_event_wakeup) < 0)
+    {
+        goto error;
+    }
+    if (pthread_create(&s_event_thread, NULL, gpio_events_thread, NULL) != 0)
+    {
+        fprintf(stderr, "Failed to start gpio events thread\n");
+        goto error;
+    }
+    return 0;
+error:
+    for (i = 0; i < count; i++)
+    {
+        if (s_event_pins[i].fd >= 0)
+        {
+            close(s_event_pins[i].fd);
+        }
+    }
+    if (s_event_wakeup[0] >= 0)
+    {
+        close(s_event_wakeup[0]);
+        close(s_event_wakeup[1]);
+        s_event_wakeup[0] = s_event_wakeup[1] = -1;
+    }
+    s_event_pins_count = 0;
+    return -1;
+}
+
+uint8_t ssd1306_platform_gpioEventsState(void)
+{
+    return __atomic_load_n(&s_event_state, __ATOMIC_RELAXED);
+}
+
+int ssd1306_platform_gpioEventsRead(ssd1306_gpio_event_t *event)
+{
+    uint8_t tail = s_event_tail;
+    if (tail == __atomic_load_n(&s_event_head, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+    *event = s_event_queue[tail];
+    __atomic_store_n(&s_event_tail, (tail + 1) % SSD1306_GPIO_EVENTS_QUEUE_SIZE, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void ssd1306_platform_gpioEventsStop(void)
+{
+    uint8_t i;
+    if (!s_event_pins_count)
+    {
+        return;
+    }
+    if (write(s_event_wakeup[1], "", 1) == 1)
+    {
+        pthread_join(s_event_thread, NULL);
+    }
+    close(s_event_wakeup[0]);
+    close(s_event_wakeup[1]);
+    s_event_wakeup[0] = s_event_wakeup[1] = -1;
+    for (i = 0; i < s_event_pins_count; i++)
+    {
+        if (s_event_pins[i].fd >= 0)
+        {
+            close(s_event_pins[i].fd);
+        }
+    }
+    s_event_pins_count = 0;
+    __atomic_store_n(&s_event_state, 0, __ATOMIC_RELAXED);
+}
+
 #endif // SDL_EMULATION
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -262,22 +521,56 @@ void digitalWrite(int pin, int level)
 #if !defined(SDL_EMULATION)
 
 
+#if defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_sa        (s_ssd1306_context->bus.sa)
+#define s_fd        (s_ssd1306_context->bus.fd)
+#define s_buffer    (s_ssd1306_context->bus.buffer)
+#define s_dataSize  (s_ssd1306_context->bus.size)
+#else
 static uint8_t s_sa = SSD1306_SA;
 static int     s_fd = -1;
 static uint8_t s_buffer[128];
 static uint8_t s_dataSize = 0;
+#endif
+/* Maximum number of bytes in single i2c-dev write */
+#define I2C_BUFFER_SIZE  128
 
 static void platform_i2c_start(void)
 {
     s_dataSize = 0;
 }
 
-static void platform_i2c_stop(void)
+int ssd1306_platform_i2cOpen(int8_t busId, uint8_t sa)
+{
+    char filename[20];
+    int fd;
+    snprintf(filename, 19, "/dev/i2c-%d", busId < 0 ? 1 : busId);
+    if ((fd = open(filename, O_RDWR)) < 0)
+    {
+        fprintf(stderr, "Failed to open the i2c bus %s\n",
+                getuid() == 0 ? "": ": need to be root");
+        return -1;
+    }
+    if (ioctl(fd, I2C_SLAVE, sa ? sa : SSD1306_SA) < 0)
+    {
+        fprintf(stderr, "Failed to acquire bus access and/or talk to slave.\n");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void ssd1306_platform_i2cWrite(int fd, const uint8_t *buffer, uint16_t size)
 {
-    if (write(s_fd, s_buffer, s_dataSize) != s_dataSize)
+    if (write(fd, buffer, size) != size)
     {
         fprintf(stderr, "Failed to write to the i2c bus: %s.\n", strerror(errno));
     }
+}
+
+static void platform_i2c_stop(void)
+{
+    ssd1306_platform_i2cWrite(s_fd, s_buffer, s_dataSize);
     s_dataSize = 0;
 }
 
@@ -285,7 +578,7 @@ static void platform_i2c_send(uint8_t data)
 {
     s_buffer[s_dataSize] = data;
     s_dataSize++;
-    if (s_dataSize == sizeof(s_buffer))
+    if (s_dataSize == I2C_BUFFER_SIZE)
     {
         /* Send function puts all data to internal buffer.  *
          * Restart transmission if internal buffer is full. */
@@ -327,30 +620,17 @@ static void empty_function_two_args(const uint8_t *arg1, uint16_t arg2)
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConfig_t * cfg)
 {
-    char filename[20];
-    if (busId < 0)
-    {
-        busId = 1;
-    }
-    snprintf(filename, 19, "/dev/i2c-%d", busId);
     ssd1306_intf.start = empty_function;
     ssd1306_intf.stop = empty_function;
     ssd1306_intf.close = empty_function;
     ssd1306_intf.send = empty_function_single_arg;
     ssd1306_intf.send_buffer = empty_function_two_args;
-    if ((s_fd = open(filename, O_RDWR)) < 0)
-    {
-        fprintf(stderr, "Failed to open the i2c bus %s\n",
-                getuid() == 0 ? "": ": need to be root");
-        return;
-    }
     if (sa)
     {
         s_sa = sa;
     }
-    if (ioctl(s_fd, I2C_SLAVE, s_sa) < 0)
+    if ((s_fd = ssd1306_platform_i2cOpen(busId, s_sa)) < 0)
     {
-        fprintf(stderr, "Failed to acquire bus access and/or talk to slave.\n");
         return;
     }
     ssd1306_intf.start = platform_i2c_start;
@@ -396,10 +676,15 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
 
 #if !defined(SDL_EMULATION)
 
+#if defined(CONFIG_SSD1306_CONTEXT_ENABLE)
+#define s_spi_fd            (s_ssd1306_context->bus.fd)
+#define s_spi_cache         (s_ssd1306_context->bus.buffer)
+#define s_spi_cached_count  (s_ssd1306_context->bus.size)
+#else
 static int     s_spi_fd = -1;
-extern uint32_t s_ssd1306_spi_clock;
 static uint8_t s_spi_cache[1024];
 static int s_spi_cached_count = 0;
+#endif
 
 static void platform_spi_start(void)
 {
@@ -411,28 +696,62 @@ static void platform_spi_stop(void)
     platform_spi_send_cache();
 }
 
-static void platform_spi_send_cache()
+int ssd1306_platform_spiOpen(int8_t busId, int8_t ces, uint32_t frequency)
 {
-    /* TODO: Yeah, sending single bytes is too slow, but *
-     * need to figure out how to detect data/command bytes *
-     * to send bytes as one block */
-    if ( s_spi_cached_count == 0 )
+    char filename[20];
+    int fd;
+    snprintf(filename, 19, "/dev/spidev%d.%d", busId < 0 ? 0 : busId, ces < 0 ? 0 : ces);
+    if ((fd = open(filename, O_RDWR)) < 0)
     {
-        return;
+        fprintf(stderr, "Failed to initialize SPI: %s%s!\n",
+                strerror(errno), getuid() == 0 ? "": ", need to be root");
+        return -1;
+    }
+    unsigned int speed = frequency;
+    if (ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0)
+    {
+        fprintf(stderr, "Failed to set speed on SPI line: %s!\n", strerror(errno));
     }
+    uint8_t mode = SPI_MODE_0;
+    if (ioctl (fd, SPI_IOC_WR_MODE, &mode) < 0)
+    {
+        fprintf(stderr, "Failed to set SPI mode: %s!\n", strerror(errno));
+    }
+    uint8_t spi_bpw = 8;
+    if (ioctl (fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bpw) < 0)
+    {
+        fprintf(stderr, "Failed to set SPI BPW: %s!\n", strerror(errno));
+    }
+    return fd;
+}
+
+void ssd1306_platform_spiWrite(int fd, const uint8_t *buffer, uint16_t size)
+{
     struct spi_ioc_transfer mesg;
     memset(&mesg, 0, sizeof mesg);
-    mesg.tx_buf = (unsigned long)&s_spi_cache[0];
+    mesg.tx_buf = (unsigned long)buffer;
     mesg.rx_buf = 0;
-    mesg.len = s_spi_cached_count;
+    mesg.len = size;
     mesg.delay_usecs = 0;
     mesg.speed_hz = 0;
     mesg.bits_per_word = 8;
     mesg.cs_change = 0;
-    if (ioctl(s_spi_fd, SPI_IOC_MESSAGE(1), &mesg) < 1)
+    if (ioctl(fd, SPI_IOC_MESSAGE(1), &mesg) < 1)
     {
         fprintf(stderr, "SPI failed to send SPI message: %s\n", strerror (errno)) ;
     }
+}
+
+static void platform_spi_send_cache()
+{
+    /* TODO: Yeah, sending single bytes is too slow, but *
+     * need to figure out how to detect data/command bytes *
+     * to send bytes as one block */
+    if ( s_spi_cached_count == 0 )
+    {
+        return;
+    }
+    ssd1306_platform_spiWrite(s_spi_fd, &s_spi_cache[0], s_spi_cached_count);
     s_spi_cached_count = 0;
 }
 
@@ -480,15 +799,6 @@ void ssd1306_platform_spiInit(int8_t busId,
                               int8_t ces,
                               int8_t dcPin)
 {
-    char filename[20];
-    if (busId < 0)
-    {
-        busId = 0;
-    }
-    if (ces < 0)
-    {
-        ces = 0;
-    }
     s_ssd1306_cs = -1;    // SPI interface does't need separate ces pin
     s_ssd1306_dc = dcPin;
     ssd1306_intf.spi = 1;
@@ -498,28 +808,10 @@ void ssd1306_platform_spiInit(int8_t busId,
     ssd1306_intf.send_buffer = empty_function_args_spi;
     ssd1306_intf.close = empty_function;
 
-    snprintf(filename, 19, "/dev/spidev%d.%d", busId, ces);
-    if ((s_spi_fd = open(filename, O_RDWR)) < 0)
+    if ((s_spi_fd = ssd1306_platform_spiOpen(busId, ces, s_ssd1306_spi_clock)) < 0)
     {
-        printf("Failed to initialize SPI: %s%s!\n",
-               strerror(errno), getuid() == 0 ? "": ", need to be root");
         return;
     }
-    unsigned int speed = s_ssd1306_spi_clock;
-    if (ioctl(s_spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0)
-    {
-        printf("Failed to set speed on SPI line: %s!\n", strerror(errno));
-    }
-    uint8_t mode = SPI_MODE_0;
-    if (ioctl (s_spi_fd, SPI_IOC_WR_MODE, &mode) < 0)
-    {
-        printf("Failed to set SPI mode: %s!\n", strerror(errno));
-    }
-    uint8_t spi_bpw = 8;
-    if (ioctl (s_spi_fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bpw) < 0)
-    {
-        printf("Failed to set SPI BPW: %s!\n", strerror(errno));
-    }
 
     ssd1306_intf.spi = 1;
     ssd1306_intf.start = platform_spi_start;
@@ -566,6 +858,155 @@ void ssd1306_platform_spiInit(int8_t busId, int8_t ces, int8_t dcPin)
 
 #endif // CONFIG_PLATFORM_SPI_AVAILABLE
 
+//////////////////////////////////////////////////////////////////////////////////
+//                        LINUX UART IMPLEMENTATION
+//////////////////////////////////////////////////////////////////////////////////
+#if defined(CONFIG_PLATFORM_UART_AVAILABLE)
+
+#include <termios.h>
+
+static int     s_uart_fd = -1;
+static uint8_t s_uart_buffer[256];
+static int     s_uart_size = 0;
+
+static void platform_uart_flush(void)
+{
+    int offset = 0;
+    while (offset < s_uart_size)
+    {
+        int result = write(s_uart_fd, s_uart_buffer + offset, s_uart_size - offset);
+        if (result < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            fprintf(stderr, "Failed to write to serial device: %s\n", strerror(errno));
+            break;
+        }
+        offset += result;
+    }
+    s_uart_size = 0;
+}
+
+static void platform_uart_put(uint8_t data)
+{
+    s_uart_buffer[s_uart_size++] = data;
+    if (s_uart_size == sizeof(s_uart_buffer))
+    {
+        platform_uart_flush();
+    }
+}
+
+static void platform_uart_start(void)
+{
+}
+
+static void platform_uart_stop(void)
+{
+    platform_uart_put(0x7E);
+    platform_uart_flush();
+}
+
+static void platform_uart_send(uint8_t data)
+{
+    if ((data == 0x7E) || (data == 0x7D))
+    {
+        platform_uart_put(0x7D);
+        data ^= 0x20;
+    }
+    platform_uart_put(data);
+}
+
+static void platform_uart_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        platform_uart_send(*buffer);
+        buffer++;
+    }
+}
+
+static void platform_uart_close(void)
+{
+    if (s_uart_fd >= 0)
+    {
+        platform_uart_flush();
+        close(s_uart_fd);
+        s_uart_fd = -1;
+    }
+}
+
+/* Returns B0 for rates, not supported by termios */
+static speed_t platform_uart_speed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 1200: return B1200;
+        case 2400: return B2400;
+        case 4800: return B4800;
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 0:
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+#ifdef B500000
+        case 500000: return B500000;
+#endif
+#ifdef B576000
+        case 576000: return B576000;
+#endif
+        case 921600: return B921600;
+#ifdef B1000000
+        case 1000000: return B1000000;
+#endif
+#ifdef B1500000
+        case 1500000: return B1500000;
+#endif
+#ifdef B2000000
+        case 2000000: return B2000000;
+#endif
+#ifdef B3000000
+        case 3000000: return B3000000;
+#endif
+        default: return B0;
+    }
+}
+
+int ssd1306_platform_uartInit(const char *device, uint32_t baud)
+{
+    struct termios tio;
+    speed_t speed = platform_uart_speed(baud);
+    platform_uart_close();
+    if (speed == B0)
+    {
+        fprintf(stderr, "Unsupported baud rate %u for serial device %s\n", baud, device);
+        return -1;
+    }
+    if ((s_uart_fd = open(device, O_RDWR | O_NOCTTY)) < 0)
+    {
+        fprintf(stderr, "Failed to open serial device %s: %s\n", device, strerror(errno));
+        return -1;
+    }
+    if (tcgetattr(s_uart_fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tcsetattr(s_uart_fd, TCSANOW, &tio);
+    }
+    s_uart_size = 0;
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = platform_uart_start;
+    ssd1306_intf.stop = platform_uart_stop;
+    ssd1306_intf.send = platform_uart_send;
+    ssd1306_intf.send_buffer = platform_uart_send_buffer;
+    ssd1306_intf.close = platform_uart_close;
+    return s_uart_fd;
+}
+
+#endif // CONFIG_PLATFORM_UART_AVAILABLE
+
 #else  // end of !KERNEL, KERNEL is below
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConfig_t * cfg)
@@ -187,7 +187,6 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
 #if !defined(SDL_EMULATION)
 
 static int     s_spi_fd = -1;
-extern uint32_t s_ssd1306_spi_clock;
 
 static void platform_spi_start(void)
 {
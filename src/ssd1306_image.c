@@ -0,0 +1,188 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_image.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+#include "ssd1306_hal/io.h"
+
+/** Number of image bytes, collected before sending them to the display */
+#define SSD1306_IMAGE_CHUNK  16
+
+
+lcduint_t ssd1306_imageWidth(const uint8_t *image)
+{
+    return (pgm_read_byte(&image[1]) << 8) | pgm_read_byte(&image[2]);
+}
+
+lcduint_t ssd1306_imageHeight(const uint8_t *image)
+{
+    return (pgm_read_byte(&image[3]) << 8) | pgm_read_byte(&image[4]);
+}
+
+void ssd1306_drawRleImage1(lcdint_t x, lcdint_t y, const uint8_t *image)
+{
+    uint8_t chunk[SSD1306_IMAGE_CHUNK];
+    uint8_t len = 0;
+    lcduint_t w = ssd1306_imageWidth(image);
+    lcduint_t col = 0;
+    uint32_t count = (uint32_t)w * (ssd1306_imageHeight(image) >> 3);
+    const uint8_t *data = image + SSD1306_IMAGE_HEADER_SIZE;
+    ssd1306_lcd.set_block(x, y >> 3, w);
+    while (count)
+    {
+        uint8_t ctl = pgm_read_byte(data++);
+        uint8_t n = (ctl & 0x7F) + 1;
+        uint8_t value = 0;
+        if ( n > count )
+        {
+            n = count;
+        }
+        count -= n;
+        if ( ctl & 0x80 )
+        {
+            value = pgm_read_byte(data++) ^ s_ssd1306_invertByte;
+        }
+        while (n--)
+        {
+            chunk[len++] = (ctl & 0x80) ? value : (pgm_read_byte(data++) ^ s_ssd1306_invertByte);
+            col++;
+            if ( (len == SSD1306_IMAGE_CHUNK) || (col == w) )
+            {
+                ssd1306_lcd.send_pixels_buffer1(chunk, len);
+                len = 0;
+            }
+            if ( col == w )
+            {
+                ssd1306_lcd.next_page();
+                col = 0;
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawRleImage8(lcdint_t x, lcdint_t y, const uint8_t *image)
+{
+    uint8_t chunk[SSD1306_IMAGE_CHUNK];
+    uint8_t len = 0;
+    /* Displays in native RGB332 mode accept pixels as is, others convert each pixel */
+    uint8_t native = ssd1306_lcd.send_pixels8 == ssd1306_intf.send;
+    lcduint_t w = ssd1306_imageWidth(image);
+    uint32_t count = (uint32_t)w * ssd1306_imageHeight(image);
+    const uint8_t *data = image + SSD1306_IMAGE_HEADER_SIZE;
+    ssd1306_lcd.set_block(x, y, w);
+    while (count)
+    {
+        uint8_t ctl = pgm_read_byte(data++);
+        uint8_t n = (ctl & 0x7F) + 1;
+        uint8_t color = 0;
+        if ( n > count )
+        {
+            n = count;
+        }
+        count -= n;
+        if ( ctl & 0x80 )
+        {
+            color = pgm_read_byte(data++);
+        }
+        while (n--)
+        {
+            chunk[len++] = (ctl & 0x80) ? color : pgm_read_byte(data++);
+            if ( (len == SSD1306_IMAGE_CHUNK) || (!n && !count) )
+            {
+                if ( native )
+                {
+                    ssd1306_intf.send_buffer(chunk, len);
+                }
+                else
+                {
+                    for (uint8_t i = 0; i < len; i++)
+                    {
+                        ssd1306_lcd.send_pixels8( chunk[i] );
+                    }
+                }
+                len = 0;
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawRleImage16(lcdint_t x, lcdint_t y, const uint8_t *image)
+{
+    uint8_t chunk[SSD1306_IMAGE_CHUNK];
+    uint8_t len = 0;
+    lcduint_t w = ssd1306_imageWidth(image);
+    uint32_t count = (uint32_t)w * ssd1306_imageHeight(image);
+    const uint8_t *data = image + SSD1306_IMAGE_HEADER_SIZE;
+    ssd1306_lcd.set_block(x, y, w);
+    while (count)
+    {
+        uint8_t ctl = pgm_read_byte(data++);
+        uint8_t n = (ctl & 0x7F) + 1;
+        uint8_t hi = 0;
+        uint8_t lo = 0;
+        if ( n > count )
+        {
+            n = count;
+        }
+        count -= n;
+        if ( ctl & 0x80 )
+        {
+            hi = pgm_read_byte(&data[0]);
+            lo = pgm_read_byte(&data[1]);
+            data += 2;
+        }
+        while (n--)
+        {
+            if ( !(ctl & 0x80) )
+            {
+                hi = pgm_read_byte(&data[0]);
+                lo = pgm_read_byte(&data[1]);
+                data += 2;
+            }
+            /* RGB565 pixels are sent MSB first, the same way ssd1306_drawBuffer16() does */
+            chunk[len++] = hi;
+            chunk[len++] = lo;
+            if ( (len == SSD1306_IMAGE_CHUNK) || (!n && !count) )
+            {
+                ssd1306_intf.send_buffer(chunk, len);
+                len = 0;
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawRleImage(lcdint_t x, lcdint_t y, const uint8_t *image)
+{
+    switch ( pgm_read_byte(&image[0]) )
+    {
+        case 1: ssd1306_drawRleImage1(x, y, image); break;
+        case 8: ssd1306_drawRleImage8(x, y, image); break;
+        case 16: ssd1306_drawRleImage16(x, y, image); break;
+        default: break;
+    }
+}
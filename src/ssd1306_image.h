@@ -0,0 +1,126 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_image.h Streaming compressed image functions
+ */
+
+#ifndef _SSD1306_IMAGE_H_
+#define _SSD1306_IMAGE_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_IMAGE_API DIRECT DRAW: Compressed images
+ * @{
+ *
+ * @brief Functions to draw compressed images, located in Flash.
+ *
+ * @details Compressed images are decoded on the fly and sent directly to GDRAM
+ *          in the display raster order. Image is never unpacked to RAM, so decoding
+ *          requires only small fixed chunk of stack regardless of image size.
+ *          Images can be prepared with tools/imgencoder.py script.
+ *
+ *          Image format:
+ *          TYPE|WIDTH(MSB)|WIDTH(LSB)|HEIGHT(MSB)|HEIGHT(LSB)|PACKETS...
+ *
+ *          TYPE is bits per pixel: 1, 8 or 16.
+ *          Each packet starts with control byte. If bit 7 is set, the next
+ *          unit is repeated (control & 0x7F) + 1 times, otherwise (control + 1) units
+ *          follow as is. Unit is single pixel for 8-bit (RGB_COLOR8) and
+ *          16-bit (RGB_COLOR16, MSB first) images. For 1-bit images unit is single
+ *          byte of vertical 8 pixels (ssd1306 page layout), units go from left to
+ *          right, page by page.
+ */
+
+/** Offset of the first packet in compressed image */
+#define SSD1306_IMAGE_HEADER_SIZE   5
+
+/**
+ * Returns width of compressed image in pixels.
+ * @param image pointer to compressed image, located in Flash
+ */
+lcduint_t ssd1306_imageWidth(const uint8_t *image);
+
+/**
+ * Returns height of compressed image in pixels.
+ * @param image pointer to compressed image, located in Flash
+ */
+lcduint_t ssd1306_imageHeight(const uint8_t *image);
+
+/**
+ * Draws 1-bit compressed image, located in Flash, on the display.
+ * This function works for monochrome displays and ssd1306 compatible mode.
+ *
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels, must be multiple of 8
+ * @param image pointer to compressed image, located in Flash
+ * @note The function doesn't perform clipping. Image must fit the display.
+ */
+void ssd1306_drawRleImage1(lcdint_t x, lcdint_t y, const uint8_t *image);
+
+/**
+ * Draws 8-bit compressed image, located in Flash, on the display.
+ * The function works both in 8-bit and 16-bit normal modes.
+ *
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param image pointer to compressed image, located in Flash
+ * @note The function doesn't perform clipping. Image must fit the display.
+ */
+void ssd1306_drawRleImage8(lcdint_t x, lcdint_t y, const uint8_t *image);
+
+/**
+ * Draws 16-bit compressed image, located in Flash, on the display.
+ *
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param image pointer to compressed image, located in Flash
+ * @note The function doesn't perform clipping. Image must fit the display.
+ */
+void ssd1306_drawRleImage16(lcdint_t x, lcdint_t y, const uint8_t *image);
+
+/**
+ * Draws compressed image, located in Flash, on the display.
+ * Calls ssd1306_drawRleImage1(), ssd1306_drawRleImage8() or ssd1306_drawRleImage16()
+ * depending on image type. Does nothing for unknown image types.
+ *
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param image pointer to compressed image, located in Flash
+ */
+void ssd1306_drawRleImage(lcdint_t x, lcdint_t y, const uint8_t *image);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_IMAGE_H_
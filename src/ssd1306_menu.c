@@ -33,9 +33,6 @@
 #define max(x,y) ((x)>(y)?(x):(y))
 #endif
 
-extern SFixedFontInfo s_fixedFont;
-extern uint16_t ssd1306_color;
-
 static uint8_t getMaxScreenItems(void)
 {
     return ((ssd1306_displayHeight() - 16) / (s_fixedFont.pages * 8));
@@ -123,6 +120,47 @@ static void drawMenuItem16(SAppMenu *menu, uint8_t index)
     ssd1306_positiveMode();
 }
 
+/* Moves visible items of color menu with display accelerator and draws only items, *
+ * exposed by the scroll. Returns 0 if accelerator is not available or menu jumps     *
+ * by whole screen, and must be redrawn.                                             */
+static uint8_t scrollMenuItems(SAppMenu *menu, uint8_t scrollPosition, void (*drawItem)(SAppMenu *, uint8_t))
+{
+    uint8_t maxItems = getMaxScreenItems8();
+    uint8_t shift = scrollPosition > menu->scrollPosition ? scrollPosition - menu->scrollPosition
+                                                          : menu->scrollPosition - scrollPosition;
+    if ( !ssd1306_lcd.accel || (shift >= maxItems) )
+    {
+        return 0;
+    }
+    lcduint_t right = ssd1306_displayWidth() - 6;
+    lcduint_t bottom = 8 + maxItems * s_fixedFont.h.height - 1;
+    lcduint_t distance = shift * s_fixedFont.h.height;
+    uint8_t first = scrollPosition;
+    if ( scrollPosition > menu->scrollPosition )
+    {
+        ssd1306_lcd.accel->copy_rect(5, 8 + distance, right, bottom, 5, 8);
+        ssd1306_lcd.accel->clear_rect(5, bottom + 1 - distance, right, bottom);
+        first = scrollPosition + maxItems - shift;
+    }
+    else
+    {
+        ssd1306_lcd.accel->copy_rect(5, 8, right, bottom - distance, 5, 8 + distance);
+        ssd1306_lcd.accel->clear_rect(5, 8, right, 8 + distance - 1);
+    }
+    menu->scrollPosition = scrollPosition;
+    for (uint8_t i = first; i < min(menu->count, first + shift); i++)
+    {
+        drawItem(menu, i);
+    }
+    if ( (menu->oldSelection >= scrollPosition) && (menu->oldSelection < scrollPosition + maxItems) )
+    {
+        drawItem(menu, menu->oldSelection);
+    }
+    drawItem(menu, menu->selection);
+    menu->oldSelection = menu->selection;
+    return 1;
+}
+
 void ssd1306_showMenu(SAppMenu *menu)
 {
     ssd1306_drawRect(4, 4, ssd1306_displayWidth() - 5, ssd1306_displayHeight() - 5);
@@ -182,8 +220,11 @@ void ssd1306_updateMenu8(SAppMenu *menu)
         uint8_t scrollPosition = calculateScrollPosition8( menu, menu->selection );
         if ( scrollPosition != menu->scrollPosition )
         {
-            ssd1306_clearScreen8();
-            ssd1306_showMenu8(menu);
+            if ( !scrollMenuItems(menu, scrollPosition, drawMenuItem8) )
+            {
+                ssd1306_clearScreen8();
+                ssd1306_showMenu8(menu);
+            }
         }
         else
         {
@@ -201,8 +242,11 @@ void ssd1306_updateMenu16(SAppMenu *menu)
         uint8_t scrollPosition = calculateScrollPosition8( menu, menu->selection );
         if ( scrollPosition != menu->scrollPosition )
         {
-            ssd1306_clearScreen16();
-            ssd1306_showMenu16(menu);
+            if ( !scrollMenuItems(menu, scrollPosition, drawMenuItem16) )
+            {
+                ssd1306_clearScreen16();
+                ssd1306_showMenu16(menu);
+            }
         }
         else
         {
@@ -0,0 +1,198 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_trace.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_intf_wrapper.h"
+
+#if defined(CONFIG_SSD1306_TRACE_ENABLE) && defined(CONFIG_PLATFORM_TRACE_AVAILABLE)
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#define TRACE_MAX_DEPTH   32
+
+typedef struct
+{
+    const char *category;
+    const char *name;
+    uint64_t start;
+    uint32_t bytes;
+} trace_scope_t;
+
+static FILE *s_file = NULL;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t s_startTime;
+static uint8_t s_firstEvent;
+static ssd1306_intf_wrapper_t s_wrapper;
+
+/* Scopes are nested per thread, so each thread has its own stack */
+static __thread trace_scope_t s_stack[TRACE_MAX_DEPTH];
+static __thread uint8_t s_depth = 0;
+static __thread trace_scope_t s_transaction;
+
+static uint64_t trace_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void trace_write(const trace_scope_t *scope, uint64_t end)
+{
+    pthread_mutex_lock(&s_lock);
+    /* Scope could be opened before tracing was started */
+    if ( s_file && scope->start >= s_startTime )
+    {
+        fprintf(s_file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"pid\":%d,\"tid\":%ld,\"args\":{\"bytes\":%u}}",
+                s_firstEvent ? "" : ",\n", scope->name, scope->category,
+                (scope->start - s_startTime) / 1000.0, (end - scope->start) / 1000.0,
+                (int)getpid(), (long)syscall(SYS_gettid), scope->bytes);
+        s_firstEvent = 0;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+static void trace_bytes(uint32_t count)
+{
+    uint8_t depth = s_depth < TRACE_MAX_DEPTH ? s_depth : TRACE_MAX_DEPTH;
+    for (uint8_t i = 0; i < depth; i++)
+    {
+        s_stack[i].bytes += count;
+    }
+    s_transaction.bytes += count;
+}
+
+void ssd1306_traceBegin(const char *category, const char *name)
+{
+    if ( s_depth < TRACE_MAX_DEPTH )
+    {
+        trace_scope_t *scope = &s_stack[s_depth];
+        scope->category = category;
+        scope->name = name;
+        scope->start = s_file ? trace_now() : 0;
+        scope->bytes = 0;
+    }
+    s_depth++;
+}
+
+void ssd1306_traceEnd(void)
+{
+    if ( !s_depth )
+    {
+        return;
+    }
+    s_depth--;
+    if ( s_depth < TRACE_MAX_DEPTH && s_file )
+    {
+        trace_write(&s_stack[s_depth], trace_now());
+    }
+}
+
+static void trace_start(void)
+{
+    s_transaction.category = "intf";
+    s_transaction.name = "transaction";
+    s_transaction.start = trace_now();
+    s_transaction.bytes = 0;
+    s_wrapper.orig.start();
+}
+
+static void trace_stop(void)
+{
+    s_wrapper.orig.stop();
+    trace_write(&s_transaction, trace_now());
+}
+
+static void trace_send(uint8_t data)
+{
+    trace_bytes(1);
+    s_wrapper.orig.send(data);
+}
+
+static void trace_sendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    trace_scope_t scope = { "intf", "send_buffer", trace_now(), size };
+    trace_bytes(size);
+    s_wrapper.orig.send_buffer(buffer, size);
+    trace_write(&scope, trace_now());
+}
+
+static void trace_close(void)
+{
+    ssd1306_traceStop();
+    if ( ssd1306_intf.close )
+    {
+        ssd1306_intf.close();
+    }
+}
+
+int ssd1306_traceStart(const char *filename)
+{
+    if ( s_file && ssd1306_traceStop() < 0 )
+    {
+        return -1;
+    }
+    FILE *file = fopen(filename, "w");
+    if ( !file )
+    {
+        return -1;
+    }
+    fputs("[\n", file);
+    pthread_mutex_lock(&s_lock);
+    s_startTime = trace_now();
+    s_firstEvent = 1;
+    s_file = file;
+    pthread_mutex_unlock(&s_lock);
+    s_wrapper.intf.start = trace_start;
+    s_wrapper.intf.stop = trace_stop;
+    s_wrapper.intf.send = trace_send;
+    s_wrapper.intf.send_buffer = trace_sendBuffer;
+    s_wrapper.intf.close = trace_close;
+    ssd1306_intfWrap(&s_wrapper);
+    return 0;
+}
+
+int ssd1306_traceStop(void)
+{
+    if ( !s_file )
+    {
+        return 0;
+    }
+    if ( ssd1306_intfUnwrap(&s_wrapper) < 0 )
+    {
+        return -1;
+    }
+    pthread_mutex_lock(&s_lock);
+    fputs("\n]\n", s_file);
+    fclose(s_file);
+    s_file = NULL;
+    pthread_mutex_unlock(&s_lock);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_trace.h timeline trace points
+ */
+
+#ifndef _SSD1306_TRACE_H_
+#define _SSD1306_TRACE_H_
+
+#include "ssd1306_hal/io.h"
+
+/**
+ * @defgroup SSD1306_TRACE_API TRACE: timeline trace points
+ * @{
+ *
+ * @brief Scoped trace points, exported as Chrome trace-event JSON.
+ *
+ * @details Trace points mark graphics engine frames, tile drawing, canvas
+ *          primitives, font lookup and interface transactions. The library
+ *          contains trace points only if CONFIG_SSD1306_TRACE_ENABLE is defined
+ *          (for example, make TRACE=y), otherwise all trace macros are empty.
+ *          On Linux ssd1306_traceStart() writes events to JSON file, which can be
+ *          opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ *          Each scope is written as complete event ("ph":"X") with start time
+ *          and duration in microseconds. Scopes, opened by the same thread, are
+ *          nested. "bytes" argument of the event holds number of bytes, sent via
+ *          ssd1306_intf while the scope was open. Interface transactions
+ *          (ssd1306_intf.start() - ssd1306_intf.stop()) and send_buffer() calls
+ *          are written as separate events of "intf" category.
+ */
+
+#if defined(CONFIG_SSD1306_TRACE_ENABLE) && defined(CONFIG_PLATFORM_TRACE_AVAILABLE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Starts writing trace events to JSON file. The function wraps interface,
+ * initialized at the moment of the call, to trace transactions, so call it
+ * after interface initialization.
+ *
+ * @param filename path to JSON file to create
+ * @return 0 on success, -1 if file cannot be created
+ */
+int ssd1306_traceStart(const char *filename);
+
+/**
+ * Opens trace scope. Use SSD1306_TRACE_BEGIN() macro instead of direct call.
+ * @param category event category, for example "engine", "canvas"
+ * @param name event name, must be static string
+ */
+void ssd1306_traceBegin(const char *category, const char *name);
+
+/**
+ * Closes last opened trace scope and writes event to the file.
+ * Use SSD1306_TRACE_END() macro instead of direct call.
+ */
+void ssd1306_traceEnd(void);
+
+/**
+ * Stops tracing, restores original interface functions and closes JSON file.
+ * If another interface wrapper (for example, ssd1306_recorderStart()) was started
+ * after the trace, it must be stopped first.
+ * @return 0 on success, -1 if trace is not the last started interface wrapper
+ */
+int ssd1306_traceStop(void);
+
+#ifdef __cplusplus
+}
+
+/**
+ * Helper class, which opens trace scope in constructor and closes it in destructor.
+ */
+class NanoTraceScope
+{
+public:
+    /**
+     * Opens trace scope
+     * @param category event category
+     * @param name event name
+     */
+    NanoTraceScope(const char *category, const char *name) { ssd1306_traceBegin(category, name); }
+    ~NanoTraceScope() { ssd1306_traceEnd(); }
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define SSD1306_TRACE_CONCAT2(a, b) a ## b
+#define SSD1306_TRACE_CONCAT(a, b)  SSD1306_TRACE_CONCAT2(a, b)
+#endif
+
+/** Traces C++ block from this point till the end of the block */
+#define SSD1306_TRACE_SCOPE(category, name) \
+        NanoTraceScope SSD1306_TRACE_CONCAT(nanoTraceScope_, __LINE__)(category, name)
+#endif
+
+/** Opens trace scope */
+#define SSD1306_TRACE_BEGIN(category, name) ssd1306_traceBegin(category, name)
+/** Closes last opened trace scope */
+#define SSD1306_TRACE_END()                 ssd1306_traceEnd()
+
+#else
+
+#define SSD1306_TRACE_SCOPE(category, name)
+#define SSD1306_TRACE_BEGIN(category, name)
+#define SSD1306_TRACE_END()
+
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _SSD1306_TRACE_H_ */
@@ -0,0 +1,81 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_transpose.h"
+#include "ssd1306_hal/io.h"
+
+#if defined(__AVR__)
+
+/* Bit N of 4-bit index is moved to bit 0 of byte N */
+static const uint32_t s_spread[16] PROGMEM =
+{
+    0x00000000, 0x00000001, 0x00000100, 0x00000101,
+    0x00010000, 0x00010001, 0x00010100, 0x00010101,
+    0x01000000, 0x01000001, 0x01000100, 0x01000101,
+    0x01010000, 0x01010001, 0x01010100, 0x01010101,
+};
+
+void ssd1306_transpose8x8(uint8_t *block)
+{
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    for (uint8_t j = 8; j > 0; j--)
+    {
+        uint8_t data = block[j - 1];
+        lo = (lo << 1) | pgm_read_dword(&s_spread[data & 0x0F]);
+        hi = (hi << 1) | pgm_read_dword(&s_spread[data >> 4]);
+    }
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        block[i] = lo;
+        block[i + 4] = hi;
+        lo >>= 8;
+        hi >>= 8;
+    }
+}
+
+#else
+
+void ssd1306_transpose8x8(uint8_t *block)
+{
+    uint64_t x = 0;
+    uint64_t t;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        x |= (uint64_t)block[i] << (i * 8);
+    }
+    /* Swap 1x1, 2x2 and 4x4 bit sub-blocks, lying on opposite sides of the diagonal */
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x ^= t ^ (t << 28);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        block[i] = x >> (i * 8);
+    }
+}
+
+#endif
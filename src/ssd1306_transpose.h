@@ -0,0 +1,83 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_transpose.h 8x8 bit matrix transpose for 1-bit image layouts
+ */
+
+#ifndef _SSD1306_TRANSPOSE_H_
+#define _SSD1306_TRANSPOSE_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_TRANSPOSE_API GENERIC: 1-bit layout conversion
+ * @{
+ *
+ * @brief Functions to convert 1-bit images between row-major and page-major layouts.
+ *
+ * @details ssd1306 compatible displays and NanoCanvas1 keep 8 vertical pixels in each byte
+ *          (page-major layout), while XBM images and VGA buffer keep 8 horizontal pixels
+ *          in each byte, least significant bit being the left pixel (row-major layout).
+ *          Conversion between the layouts is transpose of 8x8 bit blocks. The same kernel
+ *          rotates page-major images by 90 degrees, if the order of bytes in the block is
+ *          reversed.
+ *
+ *          On 32-bit and 64-bit platforms the block is transposed as single 64-bit word
+ *          in 3 steps, each swapping bit groups of the block with shifts and masks.
+ *          On AVR the block is assembled from 4-bit table lookups, which avoids long
+ *          shifts, not supported by 8-bit hardware.
+ */
+
+/**
+ * Transposes 8x8 bit block in place: bit i of byte j becomes bit j of byte i.
+ * For example, 8 bytes of XBM image rows become 8 bytes of ssd1306 columns, and vice versa.
+ * @param block 8 bytes of the block
+ */
+void ssd1306_transpose8x8(uint8_t *block);
+
+/**
+ * Reverses order of bits in the byte.
+ * @param data byte to reverse
+ * @return byte with bit 7 of data in bit 0, bit 6 in bit 1, etc.
+ */
+static inline uint8_t ssd1306_reverseBits(uint8_t data)
+{
+    data = (data >> 4) | (data << 4);
+    data = ((data & 0xCC) >> 2) | ((data & 0x33) << 2);
+    return ((data & 0xAA) >> 1) | ((data & 0x55) << 1);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,679 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Host benchmark suite for ssd1306 library.
+ *
+ * The tool measures canvas primitives, font rendering, direct draw functions of
+ * lcd drivers, interface throughput and NanoEngine frames. All display output
+ * goes through counting interface, which either drops the data (null interface)
+ * or forwards it to SDL emulator (when compiled with SDL_EMULATION).
+ */
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/spi/ssd1306_spi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CANVAS_WIDTH      128
+#define BENCH_CANVAS_HEIGHT     64
+#define BENCH_MAX_WIDTH         240
+#define BENCH_MAX_HEIGHT        320
+#define BENCH_DC_PIN            5
+#define BENCH_MIN_TIME_MS       50
+
+enum
+{
+    FORMAT_TEXT,
+    FORMAT_CSV,
+    FORMAT_JSON,
+};
+
+enum
+{
+    API_MONO,
+    API_RGB8,
+    API_RGB16,
+};
+
+typedef struct
+{
+    const char *name;
+    void (*init)(void);
+    uint8_t spi;
+    uint8_t api;
+} bench_driver_t;
+
+typedef struct
+{
+    const char *name;
+    void (*select)(const uint8_t *font);
+    const uint8_t *font;
+    const char *text;
+} bench_font_t;
+
+static const bench_driver_t s_drivers[] =
+{
+    { "ssd1306_128x64",   ssd1306_128x64_init,   0, API_MONO  },
+    { "ssd1306_128x32",   ssd1306_128x32_init,   0, API_MONO  },
+    { "sh1106_128x64",    sh1106_128x64_init,    0, API_MONO  },
+    { "pcd8544_84x48",    pcd8544_84x48_init,    1, API_MONO  },
+    { "ssd1325_128x64",   ssd1325_128x64_init,   1, API_MONO  },
+    { "ssd1327_128x128",  ssd1327_128x128_init,  1, API_MONO  },
+    { "ssd1331_96x64",    ssd1331_96x64_init,    1, API_RGB8  },
+    { "ssd1331_96x64x16", ssd1331_96x64_init16,  1, API_RGB16 },
+    { "ssd1351_128x128",  ssd1351_128x128_init,  1, API_RGB16 },
+    { "il9163_128x128",   il9163_128x128_init,   1, API_RGB16 },
+    { "st7735_128x160",   st7735_128x160_init,   1, API_RGB16 },
+    { "ili9341_240x320",  ili9341_240x320_init,  1, API_RGB16 },
+};
+
+static const bench_font_t s_fonts[] =
+{
+    { "fixed6x8",     ssd1306_setFixedFont, ssd1306xled_font6x8,           "Hello, world!" },
+    { "fixed8x16",    ssd1306_setFixedFont, ssd1306xled_font8x16,          "Hello, world!" },
+    { "fixed5x7",     ssd1306_setFixedFont, ssd1306xled_font5x7,           "Hello, world!" },
+    { "digital5x7",   ssd1306_setFixedFont, digital_font5x7,               "12:34:56" },
+    { "courier11x16", ssd1306_setFixedFont, courier_new_font11x16_digits,  "12:34" },
+    { "comic24x32",   ssd1306_setFixedFont, comic_sans_font24x32_123,      "1234" },
+    { "free11x12",    ssd1306_setFreeFont,  free_calibri11x12,             "Hello, world!" },
+};
+
+static const uint8_t s_bitmap1[32] =
+{
+    0x00, 0xE0, 0xF8, 0xFC, 0xFE, 0xFE, 0xFC, 0xF8, 0xF8, 0xFC, 0xFE, 0xFE, 0xFC, 0xF8, 0xE0, 0x00,
+    0x00, 0x01, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x01, 0x00,
+};
+
+static uint8_t s_bitmap8[16 * 16];
+static uint8_t s_canvasBuffer[BENCH_CANVAS_WIDTH * BENCH_CANVAS_HEIGHT * 2];
+static uint8_t s_screenBuffer[BENCH_MAX_WIDTH * BENCH_MAX_HEIGHT * 2];
+static uint8_t s_glyphCacheBuffer[4096];
+static uint8_t s_alphaMap[32 * 32];
+
+static uint8_t s_format = FORMAT_TEXT;
+static uint8_t s_emulator = 0;
+static uint32_t s_minTimeNs = BENCH_MIN_TIME_MS * 1000000UL;
+static const char *s_groupFilter = NULL;
+static const char *s_targetFilter = NULL;
+static uint32_t s_resultsCount = 0;
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          COUNTING INTERFACE
+//////////////////////////////////////////////////////////////////////////////////
+
+static ssd1306_interface_t s_target;
+static uint32_t s_busBytes = 0;
+
+static void bench_start(void)
+{
+    if (s_target.start) s_target.start();
+}
+
+static void bench_stop(void)
+{
+    if (s_target.stop) s_target.stop();
+}
+
+static void bench_send(uint8_t data)
+{
+    s_busBytes++;
+    if (s_target.send) s_target.send(data);
+}
+
+static void bench_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    s_busBytes += size;
+    if (s_target.send_buffer) s_target.send_buffer(buffer, size);
+}
+
+static void bench_close(void)
+{
+    if (s_target.close) s_target.close();
+}
+
+static const char *bench_interfaceName(void)
+{
+    return s_emulator ? "emulator" : "null";
+}
+
+static void bench_setupInterface(uint8_t spi)
+{
+    static uint8_t emulatorReady = 0;
+    if ( !s_emulator )
+    {
+        memset(&s_target, 0, sizeof(s_target));
+        /* Null interface has no D/C line, so skip gpio access */
+        s_ssd1306_dc = 0;
+    }
+    else if ( !emulatorReady )
+    {
+#if defined(SDL_EMULATION)
+        if (spi)
+            ssd1306_platform_spiInit(-1, -1, BENCH_DC_PIN);
+        else
+            ssd1306_platform_i2cInit(-1, 0, NULL);
+        s_target = ssd1306_intf;
+#endif
+        emulatorReady = 1;
+    }
+    ssd1306_intf.spi = spi;
+    ssd1306_intf.start = bench_start;
+    ssd1306_intf.stop = bench_stop;
+    ssd1306_intf.send = bench_send;
+    ssd1306_intf.send_buffer = bench_send_buffer;
+    ssd1306_intf.close = bench_close;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          MEASUREMENT AND REPORTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool bench_selected(const char *group, const char *target)
+{
+    if ( s_groupFilter && strcmp(s_groupFilter, group) ) return false;
+    if ( s_targetFilter && !strstr(target, s_targetFilter) ) return false;
+    return true;
+}
+
+static void bench_report(const char *group, const char *target, const char *test,
+                         uint32_t count, double ns, uint32_t pixels, uint32_t bytes)
+{
+    double pps = (pixels && ns > 0) ? pixels * 1e9 / ns : 0;
+    switch (s_format)
+    {
+    case FORMAT_CSV:
+        if ( !s_resultsCount )
+        {
+            printf("group,target,test,interface,iterations,ns_per_op,pixels_per_op,pixels_per_s,bytes_per_op\n");
+        }
+        printf("%s,%s,%s,%s,%u,%.1f,%u,%.0f,%u\n", group, target, test, bench_interfaceName(),
+               count, ns, pixels, pps, bytes);
+        break;
+    case FORMAT_JSON:
+        printf("%s\n    {\"group\": \"%s\", \"target\": \"%s\", \"test\": \"%s\", \"iterations\": %u, "
+               "\"ns_per_op\": %.1f, \"pixels_per_op\": %u, \"pixels_per_s\": %.0f, \"bytes_per_op\": %u}",
+               s_resultsCount ? "," : "", group, target, test, count, ns, pixels, pps, bytes);
+        break;
+    default:
+        printf("%-7s %-17s %-22s %12.1f ns/op %14.0f px/s %8u B/op\n",
+               group, target, test, ns, pps, bytes);
+        break;
+    }
+    fflush(stdout);
+    s_resultsCount++;
+}
+
+/**
+ * Runs operation until minimal measurement time is reached and reports
+ * average time of single operation. Bytes on wire are taken from the first
+ * (warm-up) call.
+ */
+template <typename F>
+static void bench_run(const char *group, const char *target, const char *test, uint32_t pixels, F op)
+{
+    s_busBytes = 0;
+    op();
+    uint32_t bytes = s_busBytes;
+    uint32_t count = 1;
+    uint64_t elapsed;
+    for (;;)
+    {
+        uint64_t start = bench_ns();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            op();
+        }
+        elapsed = bench_ns() - start;
+        if ( (elapsed >= s_minTimeNs) || (count >= 0x40000000UL) )
+        {
+            break;
+        }
+        /* Estimate number of iterations, required to reach measurement time */
+        uint64_t next = elapsed ? (uint64_t)count * s_minTimeNs * 5 / 4 / elapsed : (uint64_t)count * 100;
+        if (next > (uint64_t)count * 100) next = (uint64_t)count * 100;
+        count = next > count ? (uint32_t)next : count * 2;
+    }
+    bench_report(group, target, test, count, (double)elapsed / count, pixels, bytes);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                              CANVAS TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+template <uint8_t BPP>
+static void bench_canvasXBitmap1(NanoCanvasOps<BPP> &canvas, const char *target)
+{
+    bench_run("canvas", target, "drawXBitmap1", 16 * 16,
+              [&]{ canvas.drawXBitmap1(8, 8, 16, 16, s_bitmap1); });
+}
+
+template <uint8_t BPP>
+static void bench_canvasBitmap8(NanoCanvasOps<BPP> &canvas, const char *target)
+{
+    bench_run("canvas", target, "drawBitmap8", 16 * 16,
+              [&]{ canvas.drawBitmap8(8, 8, 16, 16, s_bitmap8); });
+}
+
+/* Compares alpha blending with opaque fill and copy of the same 32x32 area */
+template <uint8_t BPP>
+static void bench_canvasAlpha(NanoCanvasOps<BPP> &canvas, const char *target)
+{
+    const uint8_t *image = s_screenBuffer;
+    bench_run("canvas", target, "fillRectAlpha128", 32 * 32, [&]{ canvas.fillRectAlpha(8, 8, 39, 39, 128); });
+    bench_run("canvas", target, "drawBufferAlpha255", 32 * 32, [&]{ canvas.drawBufferAlpha(8, 8, 32, 32, image, 255); });
+    bench_run("canvas", target, "drawBufferAlpha128", 32 * 32, [&]{ canvas.drawBufferAlpha(8, 8, 32, 32, image, 128); });
+    bench_run("canvas", target, "drawBufferAlphaMap", 32 * 32, [&]{ canvas.drawBufferAlphaMap(8, 8, 32, 32, image, s_alphaMap); });
+    bench_run("canvas", target, "drawColorAlphaMap", 32 * 32, [&]{ canvas.drawBufferAlphaMap(8, 8, 32, 32, nullptr, s_alphaMap); });
+}
+
+/* 4-bit canvas has no XBMP support, 1-bit canvas has no 8-bit bitmaps */
+template <> void bench_canvasXBitmap1<4>(NanoCanvasOps<4> &canvas, const char *target) { }
+template <> void bench_canvasBitmap8<1>(NanoCanvasOps<1> &canvas, const char *target) { }
+/* Only 8-bit and 16-bit canvases support blending */
+template <> void bench_canvasAlpha<1>(NanoCanvasOps<1> &canvas, const char *target) { }
+template <> void bench_canvasAlpha<4>(NanoCanvasOps<4> &canvas, const char *target) { }
+
+template <uint8_t BPP>
+static void bench_canvas(const char *target)
+{
+    if ( !bench_selected("canvas", target) ) return;
+    const lcdint_t w = BENCH_CANVAS_WIDTH;
+    const lcdint_t h = BENCH_CANVAS_HEIGHT;
+    NanoCanvasOps<BPP> canvas(w, h, s_canvasBuffer);
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    const char *text = "Hello, world!";
+    uint32_t textPixels = strlen(text) * 6 * 8;
+
+    bench_run("canvas", target, "putPixel", 1, [&]{ canvas.putPixel(17, 23); });
+    bench_run("canvas", target, "drawHLine", w, [&]{ canvas.drawHLine(0, 21, w - 1); });
+    bench_run("canvas", target, "drawVLine", h, [&]{ canvas.drawVLine(21, 0, h - 1); });
+    bench_run("canvas", target, "drawLine", w, [&]{ canvas.drawLine(0, 0, w - 1, h - 1); });
+    bench_run("canvas", target, "drawRect", 2 * (w + h) - 4, [&]{ canvas.drawRect(0, 0, w - 1, h - 1); });
+    bench_run("canvas", target, "fillRect", 32 * 32, [&]{ canvas.fillRect(8, 8, 39, 39); });
+    bench_run("canvas", target, "clear", w * h, [&]{ canvas.clear(); });
+    bench_run("canvas", target, "drawBitmap1", 16 * 16, [&]{ canvas.drawBitmap1(8, 8, 16, 16, s_bitmap1); });
+    bench_canvasXBitmap1<BPP>(canvas, target);
+    bench_canvasBitmap8<BPP>(canvas, target);
+    bench_canvasAlpha<BPP>(canvas, target);
+    bench_run("canvas", target, "printFixed", textPixels, [&]{ canvas.printFixed(3, 5, text); });
+    bench_run("canvas", target, "printFixedBold", textPixels, [&]{ canvas.printFixed(3, 5, text, STYLE_BOLD); });
+    canvas.setMode(CANVAS_MODE_TRANSPARENT);
+    bench_run("canvas", target, "printFixedTransparent", textPixels, [&]{ canvas.printFixed(3, 5, text); });
+    canvas.setMode(0);
+    if ( BPP >= 8 )
+    {
+        NanoGlyphCache cache(s_glyphCacheBuffer, sizeof(s_glyphCacheBuffer));
+        canvas.setGlyphCache(&cache);
+        bench_run("canvas", target, "printFixedCached", textPixels, [&]{ canvas.printFixed(3, 5, text); });
+        canvas.setGlyphCache(nullptr);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          DIRECT DRAW (LCD) TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static void bench_initDriver(const bench_driver_t *driver)
+{
+    bench_setupInterface(driver->spi);
+    driver->init();
+    if ( driver->api != API_MONO )
+    {
+        ssd1306_setMode(LCD_MODE_NORMAL);
+    }
+}
+
+static void bench_lcdMono(const char *target)
+{
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    bench_run("lcd", target, "clearScreen", w * h, []{ ssd1306_clearScreen(); });
+    bench_run("lcd", target, "fillScreen", w * h, []{ ssd1306_fillScreen(0x55); });
+    bench_run("lcd", target, "drawLine", w, [&]{ ssd1306_drawLine(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "drawRect", 2 * (w + h) - 4, [&]{ ssd1306_drawRect(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "fillRect", 32 * 32, []{ ssd1306_fillRect(8, 8, 39, 39); });
+    bench_run("lcd", target, "drawBitmap", 16 * 16, []{ ssd1306_drawBitmap(8, 8, 16, 16, s_bitmap1); });
+    bench_run("lcd", target, "drawXBitmap", 16 * 16, []{ ssd1306_drawXBitmap(8, 1, 16, 16, s_bitmap1); });
+    bench_run("lcd", target, "printFixed", 13 * 6 * 8, []{ ssd1306_printFixed(0, 8, "Hello, world!", STYLE_NORMAL); });
+    bench_run("lcd", target, "drawBufferFast", w * h, [&]{ ssd1306_drawBufferFast(0, 0, w, h, s_screenBuffer); });
+    NanoCanvas1 canvas(32, 32, s_canvasBuffer);
+    bench_run("lcd", target, "canvas1.bltRotated90", 32 * 32, [&]{ canvas.bltRotated(0, 0, 1); });
+}
+
+static void bench_lcdRgb8(const char *target)
+{
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_setColor(RGB_COLOR8(255, 255, 0));
+    bench_run("lcd", target, "clearScreen8", w * h, []{ ssd1306_clearScreen8(); });
+    bench_run("lcd", target, "fillScreen8", w * h, []{ ssd1306_fillScreen8(0x1C); });
+    bench_run("lcd", target, "drawLine8", w, [&]{ ssd1306_drawLine8(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "drawRect8", 2 * (w + h) - 4, [&]{ ssd1306_drawRect8(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "fillRect8", 32 * 32, []{ ssd1306_fillRect8(8, 8, 39, 39); });
+    bench_run("lcd", target, "drawMonoBitmap8", 16 * 16, []{ ssd1306_drawMonoBitmap8(8, 8, 16, 16, s_bitmap1); });
+    bench_run("lcd", target, "drawBitmap8", 16 * 16, []{ ssd1306_drawBitmap8(8, 8, 16, 16, s_bitmap8); });
+    bench_run("lcd", target, "printFixed8", 13 * 6 * 8, []{ ssd1306_printFixed8(0, 8, "Hello, world!", STYLE_NORMAL); });
+    bench_run("lcd", target, "drawBufferFast8", w * h, [&]{ ssd1306_drawBufferFast8(0, 0, w, h, s_screenBuffer); });
+}
+
+static void bench_lcdRgb16(const char *target)
+{
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_setColor(RGB_COLOR16(255, 255, 0));
+    bench_run("lcd", target, "clearScreen16", w * h, []{ ssd1306_clearScreen16(); });
+    bench_run("lcd", target, "fillScreen16", w * h, []{ ssd1306_fillScreen16(0x07E0); });
+    bench_run("lcd", target, "drawLine16", w, [&]{ ssd1306_drawLine16(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "drawRect16", 2 * (w + h) - 4, [&]{ ssd1306_drawRect16(0, 0, w - 1, h - 1); });
+    bench_run("lcd", target, "fillRect16", 32 * 32, []{ ssd1306_fillRect16(8, 8, 39, 39); });
+    bench_run("lcd", target, "drawMonoBitmap16", 16 * 16, []{ ssd1306_drawMonoBitmap16(8, 8, 16, 16, s_bitmap1); });
+    bench_run("lcd", target, "drawBitmap16", 16 * 16, []{ ssd1306_drawBitmap16(8, 8, 16, 16, s_bitmap8); });
+    bench_run("lcd", target, "printFixed16", 13 * 6 * 8, []{ ssd1306_printFixed16(0, 8, "Hello, world!", STYLE_NORMAL); });
+    bench_run("lcd", target, "drawBufferFast16", w * h, [&]{ ssd1306_drawBufferFast16(0, 0, w, h, s_screenBuffer); });
+}
+
+static void bench_lcd(const bench_driver_t *driver)
+{
+    if ( !bench_selected("lcd", driver->name) ) return;
+    uint64_t start = bench_ns();
+    s_busBytes = 0;
+    bench_initDriver(driver);
+    /* Initialization may contain delays, required by datasheet, so it is measured once */
+    bench_report("lcd", driver->name, "init", 1, (double)(bench_ns() - start), 0, s_busBytes);
+    switch (driver->api)
+    {
+    case API_RGB8:  bench_lcdRgb8(driver->name); break;
+    case API_RGB16: bench_lcdRgb16(driver->name); break;
+    default:        bench_lcdMono(driver->name); break;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                              FONT TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static void bench_fonts(void)
+{
+    for (uint8_t i = 0; i < sizeof(s_fonts) / sizeof(s_fonts[0]); i++)
+    {
+        const bench_font_t *font = &s_fonts[i];
+        if ( !bench_selected("font", font->name) ) continue;
+        NanoCanvas1 canvas1(BENCH_CANVAS_WIDTH, BENCH_CANVAS_HEIGHT, s_canvasBuffer);
+        NanoCanvas16 canvas16(BENCH_CANVAS_WIDTH, BENCH_CANVAS_HEIGHT, s_canvasBuffer);
+        font->select(font->font);
+        lcduint_t height;
+        lcduint_t width = ssd1306_getTextSize(font->text, &height);
+        uint32_t pixels = width * height;
+
+        bench_initDriver(&s_drivers[0]);
+        font->select(font->font);
+        bench_run("font", font->name, "canvas1.printFixed", pixels, [&]{ canvas1.printFixed(0, 0, font->text); });
+        bench_run("font", font->name, "canvas16.printFixed", pixels, [&]{ canvas16.printFixed(0, 0, font->text); });
+        bench_run("font", font->name, "ssd1306_printFixed", pixels,
+                  [&]{ ssd1306_printFixed(0, 0, font->text, STYLE_NORMAL); });
+        bench_run("font", font->name, "ssd1306_printFixedN", pixels * 4,
+                  [&]{ ssd1306_printFixedN(0, 0, font->text, STYLE_NORMAL, FONT_SIZE_2X); });
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                              DITHER TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static const struct
+{
+    const char *name;
+    uint8_t bpp;
+    uint8_t method;
+} s_dithers[] =
+{
+    { "bayer1", 1, SSD1306_DITHER_BAYER },
+    { "bayer4", 4, SSD1306_DITHER_BAYER },
+    { "floyd1", 1, SSD1306_DITHER_FLOYD_STEINBERG },
+    { "floyd4", 4, SSD1306_DITHER_FLOYD_STEINBERG },
+};
+
+static void bench_dither(void)
+{
+    const lcduint_t w = BENCH_CANVAS_WIDTH;
+    const lcduint_t h = BENCH_CANVAS_HEIGHT;
+    static uint8_t gray[BENCH_CANVAS_WIDTH * BENCH_CANVAS_HEIGHT];
+    static int16_t errors[BENCH_CANVAS_WIDTH + 1];
+    /* Diagonal gradient: gray image and the same image in RGB565, MSB first */
+    for (lcduint_t y = 0; y < h; y++)
+    {
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            uint8_t value = (x + y) * 255 / (w + h - 2);
+            uint16_t color = RGB_COLOR16(value, value, value);
+            gray[y * w + x] = value;
+            s_screenBuffer[(y * w + x) * 2] = color >> 8;
+            s_screenBuffer[(y * w + x) * 2 + 1] = color & 0xFF;
+        }
+    }
+    for (uint8_t i = 0; i < sizeof(s_dithers) / sizeof(s_dithers[0]); i++)
+    {
+        if ( !bench_selected("dither", s_dithers[i].name) ) continue;
+        uint8_t bpp = s_dithers[i].bpp;
+        uint8_t method = s_dithers[i].method;
+        ssd1306_dither_t dither;
+        bench_run("dither", s_dithers[i].name, "gray8", w * h, [&]
+        {
+            ssd1306_ditherInit(&dither, s_canvasBuffer, w, h, bpp, method, errors);
+            for (lcduint_t y = 0; y < h; y++) ssd1306_ditherGray8Row(&dither, &gray[y * w]);
+        });
+        bench_run("dither", s_dithers[i].name, "rgb565", w * h, [&]
+        {
+            ssd1306_ditherInit(&dither, s_canvasBuffer, w, h, bpp, method, errors);
+            for (lcduint_t y = 0; y < h; y++) ssd1306_ditherRgb565Row(&dither, &s_screenBuffer[y * w * 2]);
+        });
+        if ( bpp != 1 ) continue;
+        /* Streaming to the display through single page buffer */
+        bench_initDriver(&s_drivers[0]);
+        bench_run("dither", s_dithers[i].name, "gray8_page_lcd", w * h, [&]
+        {
+            ssd1306_ditherInit(&dither, s_canvasBuffer, w, 8, bpp, method, errors);
+            for (lcduint_t y = 0; y < h; y++)
+            {
+                if ( ssd1306_ditherGray8Row(&dither, &gray[y * w]) )
+                {
+                    ssd1306_drawBuffer(0, y >> 3, w, 8, s_canvasBuffer);
+                }
+            }
+        });
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                              ENGINE TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+template <class E>
+static bool bench_engineDraw(void)
+{
+    E::canvas.clear();
+    E::canvas.setColor(0xFFFF);
+    E::canvas.drawRect(2, 2, 12, 12);
+    E::canvas.printFixed(0, 0, "Ab");
+    return true;
+}
+
+template <class E>
+static void bench_engine(const bench_driver_t *driver)
+{
+    static E engine;
+    static const uint8_t ratios[] = { 0, 25, 50, 100 };
+    bench_initDriver(driver);
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    engine.drawCallback(bench_engineDraw<E>);
+    engine.begin();
+    /* Flush initial full screen refresh, so that each test starts with clean state */
+    engine.display();
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    if ( w > (16 << E::NE_TILE_SIZE_BITS) ) w = 16 << E::NE_TILE_SIZE_BITS;
+    for (uint8_t i = 0; i < sizeof(ratios); i++)
+    {
+        lcduint_t rows = h * ratios[i] / 100;
+        char test[24];
+        snprintf(test, sizeof(test), "frame_dirty%u", ratios[i]);
+        bench_run("engine", driver->name, test, w * rows, [&]
+        {
+            if (rows) engine.refresh(0, 0, w - 1, rows - 1);
+            engine.display();
+        });
+    }
+}
+
+static void bench_engines(const bench_driver_t *driver)
+{
+    if ( !bench_selected("engine", driver->name) ) return;
+    switch (driver->api)
+    {
+    case API_RGB8:  bench_engine<NanoEngine8>(driver); break;
+    case API_RGB16: bench_engine<NanoEngine16>(driver); break;
+    default:        bench_engine<NanoEngine1>(driver); break;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                            INTERFACE TESTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static void bench_interface(void)
+{
+    if ( !bench_selected("intf", bench_interfaceName()) ) return;
+    bench_setupInterface(s_drivers[0].spi);
+    bench_run("intf", bench_interfaceName(), "send_1024", 0, []
+    {
+        ssd1306_intf.start();
+        for (uint16_t i = 0; i < 1024; i++) ssd1306_intf.send(s_screenBuffer[i]);
+        ssd1306_intf.stop();
+    });
+    bench_run("intf", bench_interfaceName(), "send_buffer_1024", 0, []
+    {
+        ssd1306_intf.start();
+        ssd1306_intf.send_buffer(s_screenBuffer, 1024);
+        ssd1306_intf.stop();
+    });
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                                  MAIN
+//////////////////////////////////////////////////////////////////////////////////
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: benchmark [options]\n");
+    fprintf(stderr, "        -i null|emu   interface to send display data to (default: null)\n");
+    fprintf(stderr, "        -f text|csv|json  output format (default: text)\n");
+    fprintf(stderr, "        -g group      run only group: intf, canvas, font, dither, lcd, engine\n");
+    fprintf(stderr, "        -d target     run only targets containing the string (driver, canvas or font name)\n");
+    fprintf(stderr, "        -t ms         minimal measurement time per test (default: %d)\n", BENCH_MIN_TIME_MS);
+    fprintf(stderr, "Example: benchmark -g lcd -d ssd1351 -f csv\n");
+}
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if ( !strcmp(argv[i], "-h") ) { usage(); return 0; }
+        if ( !value ) { usage(); return 1; }
+        if ( !strcmp(argv[i], "-i") ) s_emulator = !strcmp(value, "emu");
+        else if ( !strcmp(argv[i], "-f") ) s_format = !strcmp(value, "csv") ? FORMAT_CSV :
+                                                      !strcmp(value, "json") ? FORMAT_JSON : FORMAT_TEXT;
+        else if ( !strcmp(argv[i], "-g") ) s_groupFilter = value;
+        else if ( !strcmp(argv[i], "-d") ) s_targetFilter = value;
+        else if ( !strcmp(argv[i], "-t") ) s_minTimeNs = strtoul(value, NULL, 10) * 1000000UL;
+        else { usage(); return 1; }
+        i++;
+    }
+#if !defined(SDL_EMULATION)
+    if ( s_emulator )
+    {
+        fprintf(stderr, "Emulator interface requires benchmark built with SDL_EMULATION=y\n");
+        return 1;
+    }
+#endif
+    for (uint16_t i = 0; i < sizeof(s_bitmap8); i++)
+    {
+        s_bitmap8[i] = i * 13;
+    }
+    /* Soft circle: opaque center, transparent corners and 4 pixels wide gradient edge */
+    for (uint16_t i = 0; i < sizeof(s_alphaMap); i++)
+    {
+        int dx = 2 * (i & 31) - 31;
+        int dy = 2 * (i >> 5) - 31;
+        int r = dx * dx + dy * dy;
+        s_alphaMap[i] = r <= 24 * 24 ? 255 : r >= 32 * 32 ? 0 : (uint8_t)(255 * (32 * 32 - r) / (32 * 32 - 24 * 24));
+    }
+    if ( s_format == FORMAT_JSON )
+    {
+        printf("{\n  \"interface\": \"%s\",\n  \"results\": [", bench_interfaceName());
+    }
+    bench_interface();
+    bench_canvas<1>("canvas1");
+    bench_canvas<4>("canvas4");
+    bench_canvas<8>("canvas8");
+    bench_canvas<16>("canvas16");
+    bench_fonts();
+    bench_dither();
+    for (uint8_t i = 0; i < sizeof(s_drivers) / sizeof(s_drivers[0]); i++)
+    {
+        /* SDL emulator shows single display only */
+        if ( s_emulator && !bench_selected("lcd", s_drivers[i].name) && !bench_selected("engine", s_drivers[i].name) )
+        {
+            continue;
+        }
+        bench_lcd(&s_drivers[i]);
+        bench_engines(&s_drivers[i]);
+        if ( s_emulator ) break;
+    }
+    if ( s_format == FORMAT_JSON )
+    {
+        printf("\n  ]\n}\n");
+    }
+    if ( ssd1306_intf.close )
+    {
+        ssd1306_intf.close();
+    }
+    return 0;
+}
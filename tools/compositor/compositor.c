@@ -0,0 +1,261 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#define _GNU_SOURCE
+#include "compositor.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+size_t compositor_surfaceSize(uint16_t w, uint16_t h, uint8_t bpp)
+{
+    if ( !w || !h )
+    {
+        return 0;
+    }
+    switch ( bpp )
+    {
+        case 1: return (h & 7) ? 0 : (size_t)w * h / 8;
+        case 8: return (size_t)w * h;
+        case 16: return (size_t)w * h * 2;
+        default: return 0;
+    }
+}
+
+int compositor_sendMsg(int sock, const compositor_msg_t *msg, int fd, int flags)
+{
+    union
+    {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct iovec iov = { (void *)msg, sizeof(*msg) };
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    if ( fd >= 0 )
+    {
+        memset(&control, 0, sizeof(control));
+        hdr.msg_control = control.data;
+        hdr.msg_controllen = sizeof(control.data);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+    while ( sendmsg(sock, &hdr, MSG_NOSIGNAL | flags) < 0 )
+    {
+        if ( errno != EINTR )
+        {
+            return -errno;
+        }
+    }
+    return 0;
+}
+
+int compositor_recvMsg(int sock, compositor_msg_t *msg, int *fd)
+{
+    union
+    {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct iovec iov = { msg, sizeof(*msg) };
+    struct msghdr hdr;
+    ssize_t len;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control.data;
+    hdr.msg_controllen = sizeof(control.data);
+    if ( fd )
+    {
+        *fd = -1;
+    }
+    while ( (len = recvmsg(sock, &hdr, MSG_CMSG_CLOEXEC)) < 0 )
+    {
+        if ( errno != EINTR )
+        {
+            return -errno;
+        }
+    }
+    if ( len == 0 )
+    {
+        return -ECONNRESET;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+    {
+        if ( cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS )
+        {
+            int received;
+            memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+            if ( fd && *fd < 0 )
+                *fd = received;
+            else
+                close(received);
+        }
+    }
+    if ( len != sizeof(*msg) || (hdr.msg_flags & MSG_TRUNC) )
+    {
+        if ( fd && *fd >= 0 )
+        {
+            close(*fd);
+            *fd = -1;
+        }
+        return -EPROTO;
+    }
+    return 0;
+}
+
+/* Sends request and waits for reply */
+static int compositor_request(compositor_surface_t *surface, compositor_msg_t *msg, int *fd)
+{
+    int result = compositor_sendMsg(surface->sock, msg, -1, 0);
+    if ( result < 0 )
+    {
+        return result;
+    }
+    result = compositor_recvMsg(surface->sock, msg, fd);
+    if ( result < 0 )
+    {
+        return result;
+    }
+    return msg->type == COMPOSITOR_REPLY ? msg->result : -EPROTO;
+}
+
+int compositor_connect(compositor_surface_t *surface, const char *path, int16_t x, int16_t y,
+                       uint16_t w, uint16_t h, uint8_t bpp, int8_t z)
+{
+    struct sockaddr_un addr;
+    compositor_msg_t msg;
+    int fd;
+    int result;
+
+    memset(surface, 0, sizeof(*surface));
+    surface->sock = -1;
+    surface->size = compositor_surfaceSize(w, h, bpp);
+    if ( !surface->size )
+    {
+        return -EINVAL;
+    }
+    surface->sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if ( surface->sock < 0 )
+    {
+        return -errno;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path ? path : COMPOSITOR_SOCKET, sizeof(addr.sun_path) - 1);
+    if ( connect(surface->sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 )
+    {
+        result = -errno;
+        compositor_disconnect(surface);
+        return result;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.type = COMPOSITOR_CREATE;
+    msg.bpp = bpp;
+    msg.z = z;
+    msg.visible = 1;
+    msg.x = x;
+    msg.y = y;
+    msg.w = w;
+    msg.h = h;
+    result = compositor_request(surface, &msg, &fd);
+    if ( result == 0 && fd < 0 )
+    {
+        result = -EPROTO;
+    }
+    if ( result == 0 )
+    {
+        void *buffer = mmap(NULL, surface->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        result = buffer == MAP_FAILED ? -errno : 0;
+        surface->buffer = buffer == MAP_FAILED ? NULL : (uint8_t *)buffer;
+    }
+    if ( fd >= 0 )
+    {
+        close(fd);
+    }
+    if ( result < 0 )
+    {
+        compositor_disconnect(surface);
+        return result;
+    }
+    surface->width = w;
+    surface->height = h;
+    surface->bpp = bpp;
+    return 0;
+}
+
+int compositor_damage(compositor_surface_t *surface, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    compositor_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = COMPOSITOR_DAMAGE;
+    msg.x = x;
+    msg.y = y;
+    msg.w = w;
+    msg.h = h;
+    return compositor_sendMsg(surface->sock, &msg, -1, 0);
+}
+
+int compositor_configure(compositor_surface_t *surface, int16_t x, int16_t y, int8_t z, uint8_t visible)
+{
+    compositor_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = COMPOSITOR_CONFIG;
+    msg.x = x;
+    msg.y = y;
+    msg.z = z;
+    msg.visible = visible;
+    return compositor_sendMsg(surface->sock, &msg, -1, 0);
+}
+
+int compositor_sync(compositor_surface_t *surface)
+{
+    compositor_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = COMPOSITOR_SYNC;
+    return compositor_request(surface, &msg, NULL);
+}
+
+void compositor_disconnect(compositor_surface_t *surface)
+{
+    if ( surface->buffer )
+    {
+        munmap(surface->buffer, surface->size);
+        surface->buffer = NULL;
+    }
+    if ( surface->sock >= 0 )
+    {
+        close(surface->sock);
+        surface->sock = -1;
+    }
+}
@@ -0,0 +1,158 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Display compositor protocol and client functions.
+ *
+ * Each client connection to the compositor owns single surface: rectangular canvas,
+ * placed on the screen at specified position and z-order. Surface pixels are kept in
+ * shared memory, created by the compositor, in the same layout as NanoCanvas1,
+ * NanoCanvas8 or NanoCanvas16 buffers use, so the client draws to it with regular
+ * canvas object. Control messages are sent over Unix SOCK_SEQPACKET socket, and carry
+ * only rectangles, not pixels: after drawing the client posts damaged area, and the
+ * compositor redraws that part of the screen on next frame.
+ */
+
+#ifndef _COMPOSITOR_H_
+#define _COMPOSITOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default path of compositor socket */
+#define COMPOSITOR_SOCKET      "/tmp/ssd1306_compositor.sock"
+
+/** Creates surface: bpp, z, x, y, w, h. Reply carries shared memory descriptor */
+#define COMPOSITOR_CREATE      1
+/** Marks surface area as changed: x, y, w, h in surface coordinates, w = 0 for whole surface */
+#define COMPOSITOR_DAMAGE      2
+/** Moves surface to x, y, changes its z-order and visibility */
+#define COMPOSITOR_CONFIG      3
+/** Requests reply after all previously posted changes are sent to display */
+#define COMPOSITOR_SYNC        4
+/** Reply to COMPOSITOR_CREATE and COMPOSITOR_SYNC */
+#define COMPOSITOR_REPLY       5
+
+/** Control message */
+typedef struct
+{
+    uint8_t  type;      ///< message type: COMPOSITOR_CREATE, etc.
+    uint8_t  bpp;       ///< bits per pixel of surface: 1, 8 or 16
+    int8_t   z;         ///< z-order, surfaces with greater z are drawn on top
+    uint8_t  visible;   ///< 0 to hide surface, 1 to show it
+    int16_t  x;         ///< left position of surface or damaged area
+    int16_t  y;         ///< top position of surface or damaged area
+    uint16_t w;         ///< width of surface or damaged area
+    uint16_t h;         ///< height of surface or damaged area
+    int32_t  result;    ///< reply: 0 on success, negative errno value on error
+} compositor_msg_t;
+
+/** Client side of the surface */
+typedef struct
+{
+    int      sock;      ///< control socket
+    uint8_t *buffer;    ///< surface pixels in NanoCanvas layout
+    size_t   size;      ///< size of buffer in bytes
+    uint16_t width;     ///< width of surface in pixels
+    uint16_t height;    ///< height of surface in pixels
+    uint8_t  bpp;       ///< bits per pixel of surface
+} compositor_surface_t;
+
+/**
+ * Returns size of surface buffer in bytes, or 0 if parameters are not supported.
+ * Height of 1-bit surface must be multiple of 8, as NanoCanvas1 requires.
+ */
+size_t compositor_surfaceSize(uint16_t w, uint16_t h, uint8_t bpp);
+
+/**
+ * Sends message with optional file descriptor.
+ * @param sock socket
+ * @param msg message to send
+ * @param fd descriptor to pass to other side, or -1
+ * @param flags additional sendmsg() flags, for example, MSG_DONTWAIT
+ * @return 0 on success, negative errno value on error
+ */
+int compositor_sendMsg(int sock, const compositor_msg_t *msg, int fd, int flags);
+
+/**
+ * Receives message with optional file descriptor.
+ * @param sock socket
+ * @param msg message to fill
+ * @param fd pointer to store received descriptor (-1 if there is no descriptor), or NULL
+ * @return 0 on success, -ECONNRESET if other side closed connection, negative errno value on error
+ */
+int compositor_recvMsg(int sock, compositor_msg_t *msg, int *fd);
+
+/**
+ * Connects to compositor and creates surface. Surface content is initially black.
+ * @param surface surface to init
+ * @param path compositor socket path, or NULL for COMPOSITOR_SOCKET
+ * @param x left position of surface on the screen
+ * @param y top position of surface on the screen
+ * @param w width of surface in pixels
+ * @param h height of surface in pixels
+ * @param bpp bits per pixel: 1, 8 or 16
+ * @param z z-order of surface
+ * @return 0 on success, negative errno value on error
+ */
+int compositor_connect(compositor_surface_t *surface, const char *path, int16_t x, int16_t y,
+                       uint16_t w, uint16_t h, uint8_t bpp, int8_t z);
+
+/**
+ * Posts changed area of the surface. Screen is updated asynchronously, on next compositor frame.
+ * @param surface surface
+ * @param x left position of area in surface coordinates
+ * @param y top position of area in surface coordinates
+ * @param w width of area, 0 for whole surface
+ * @param h height of area
+ * @return 0 on success, negative errno value on error
+ */
+int compositor_damage(compositor_surface_t *surface, int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+/**
+ * Changes position, z-order and visibility of the surface.
+ * @return 0 on success, negative errno value on error
+ */
+int compositor_configure(compositor_surface_t *surface, int16_t x, int16_t y, int8_t z, uint8_t visible);
+
+/**
+ * Waits until all changes, posted before the call, are sent to display.
+ * @return 0 on success, negative errno value on error
+ */
+int compositor_sync(compositor_surface_t *surface);
+
+/**
+ * Destroys surface and closes connection. Compositor redraws area, covered by the surface.
+ */
+void compositor_disconnect(compositor_surface_t *surface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
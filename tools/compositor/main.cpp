@@ -0,0 +1,1005 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Display compositor.
+ *
+ * Daemon owns the display and composes surfaces of several client processes.
+ * Clients draw to shared memory canvases and post damaged rectangles over Unix
+ * socket (see compositor.h). On each frame the daemon recomposes damaged areas
+ * in 8-line bands, drops columns, which do not differ from the display content,
+ * and sends remaining changes with as few set_block() calls as possible.
+ * Self test runs daemon and 3 demo clients and checks the display content.
+ */
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+#include "lcd/linux_fb.h"
+#include "intf/ssd1306_interface.h"
+#include "compositor.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_SURFACES     16
+/* Cost of starting new block in bytes: set_block() sends 6-7 command bytes, *
+ * so it is cheaper to resend several unchanged columns of adjacent bands.   */
+#define SET_BLOCK_COST   8
+#define DEMO_WIDTH       128
+#define DEMO_HEIGHT      64
+
+typedef struct
+{
+    int       sock;      // -1 for free slot
+    uint8_t  *buffer;    // NULL until client creates surface
+    size_t    size;
+    int16_t   x;
+    int16_t   y;
+    uint16_t  w;
+    uint16_t  h;
+    uint8_t   bpp;
+    int8_t    z;
+    uint8_t   visible;
+    uint8_t   sync;      // reply to COMPOSITOR_SYNC is pending
+    uint32_t  order;     // creation order, later surface is on top of surfaces with the same z
+} surface_t;
+
+/* Columns range to update in 8-line band, empty if x1 > x2 */
+typedef struct
+{
+    lcdint_t  x1;
+    lcdint_t  x2;
+} span_t;
+
+static surface_t s_surfaces[MAX_SURFACES];
+static surface_t *s_stack[MAX_SURFACES];
+static uint8_t s_stackSize;
+static uint32_t s_order;
+static int s_listen = -1;
+static int s_wakeFd = -1;
+
+static lcduint_t s_width;
+static lcduint_t s_height;
+static lcduint_t s_bands;
+static uint8_t s_bpp;          // 1: display in ssd1306 page layout, 16: RGB 5-6-5 display
+static uint8_t *s_shown;       // content, sent to display
+static uint8_t *s_band;        // composed band
+static span_t *s_dirty;
+static span_t *s_changed;
+static uint8_t s_pending;
+static uint32_t s_frameMs = 33;
+static uint32_t s_lastFrame;
+static volatile sig_atomic_t s_quit = 0;
+
+static uint32_t s_frames;
+static uint32_t s_blocks;
+static uint32_t s_bytes;
+
+static uint32_t s_demoFrames = 200;
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          COMPOSITION
+//////////////////////////////////////////////////////////////////////////////////
+
+static void screen_damage(int x1, int y1, int x2, int y2)
+{
+    if ( x1 < 0 ) x1 = 0;
+    if ( y1 < 0 ) y1 = 0;
+    if ( x2 >= (int)s_width ) x2 = s_width - 1;
+    if ( y2 >= (int)s_height ) y2 = s_height - 1;
+    if ( x1 > x2 || y1 > y2 )
+    {
+        return;
+    }
+    for (int b = y1 >> 3; b <= (y2 >> 3); b++)
+    {
+        if ( s_dirty[b].x1 > x1 ) s_dirty[b].x1 = x1;
+        if ( s_dirty[b].x2 < x2 ) s_dirty[b].x2 = x2;
+    }
+    s_pending = 1;
+}
+
+static void surface_damage(const surface_t *s, int x, int y, int w, int h)
+{
+    if ( !s->buffer || !s->visible )
+    {
+        return;
+    }
+    if ( !w )
+    {
+        x = 0;
+        y = 0;
+        w = s->w;
+        h = s->h;
+    }
+    int x2 = x + w - 1;
+    int y2 = y + h - 1;
+    if ( x < 0 ) x = 0;
+    if ( y < 0 ) y = 0;
+    if ( x2 >= s->w ) x2 = s->w - 1;
+    if ( y2 >= s->h ) y2 = s->h - 1;
+    if ( x <= x2 && y <= y2 )
+    {
+        screen_damage(s->x + x, s->y + y, s->x + x2, s->y + y2);
+    }
+}
+
+/* Sorts visible surfaces by z-order, the bottom one first */
+static void restack(void)
+{
+    s_stackSize = 0;
+    for (int i = 0; i < MAX_SURFACES; i++)
+    {
+        surface_t *s = &s_surfaces[i];
+        if ( s->sock < 0 || !s->buffer || !s->visible )
+        {
+            continue;
+        }
+        int j = s_stackSize++;
+        while ( j > 0 && (s_stack[j - 1]->z > s->z ||
+                          (s_stack[j - 1]->z == s->z && s_stack[j - 1]->order > s->order)) )
+        {
+            s_stack[j] = s_stack[j - 1];
+            j--;
+        }
+        s_stack[j] = s;
+    }
+}
+
+/* Returns surface pixel in RGB 5-6-5 format */
+static inline uint16_t surface_pixel(const surface_t *s, int sx, int sy)
+{
+    switch ( s->bpp )
+    {
+        case 1:
+            return ((s->buffer[(sy >> 3) * s->w + sx] >> (sy & 7)) & 1) ? 0xFFFF : 0;
+        case 8:
+            return RGB8_TO_RGB16(s->buffer[sy * s->w + sx]);
+        default:
+        {
+            const uint8_t *p = &s->buffer[(sy * s->w + sx) * 2];
+            return (p[0] << 8) | p[1];
+        }
+    }
+}
+
+/* Returns 8 vertical pixels of the surface, starting at row sy (can be negative). *
+ * Rows outside of the surface must be masked by the caller.                    */
+static inline uint8_t surface_column(const surface_t *s, int sx, int sy)
+{
+    if ( s->bpp == 1 )
+    {
+        int page = sy >> 3;
+        uint16_t lo = page >= 0 ? s->buffer[page * s->w + sx] : 0;
+        uint16_t hi = page + 1 < (s->h >> 3) ? s->buffer[(page + 1) * s->w + sx] : 0;
+        return ((lo | (hi << 8)) >> (sy & 7)) & 0xFF;
+    }
+    uint8_t bits = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        if ( sy + i >= 0 && sy + i < s->h && surface_pixel(s, sx, sy + i) )
+        {
+            bits |= (1 << i);
+        }
+    }
+    return bits;
+}
+
+/* Composes band b in columns x1-x2 to s_band */
+static void compose_band(lcduint_t b, int x1, int x2)
+{
+    int top = b << 3;
+    int bottom = top + 7 < (int)s_height ? top + 7 : s_height - 1;
+    if ( s_bpp == 1 )
+    {
+        memset(&s_band[x1], 0, x2 - x1 + 1);
+    }
+    else
+    {
+        for (int y = top; y <= bottom; y++)
+        {
+            memset(&s_band[((y - top) * s_width + x1) * 2], 0, (x2 - x1 + 1) * 2);
+        }
+    }
+    for (uint8_t i = 0; i < s_stackSize; i++)
+    {
+        const surface_t *s = s_stack[i];
+        int cx1 = x1 > s->x ? x1 : s->x;
+        int cx2 = x2 < s->x + s->w - 1 ? x2 : s->x + s->w - 1;
+        int cy1 = top > s->y ? top : s->y;
+        int cy2 = bottom < s->y + s->h - 1 ? bottom : s->y + s->h - 1;
+        if ( cx1 > cx2 || cy1 > cy2 )
+        {
+            continue;
+        }
+        if ( s_bpp == 1 )
+        {
+            uint8_t mask = (0xFF << (cy1 - top)) & (0xFF >> (7 - (cy2 - top)));
+            for (int x = cx1; x <= cx2; x++)
+            {
+                uint8_t bits = surface_column(s, x - s->x, top - s->y);
+                s_band[x] = (s_band[x] & ~mask) | (bits & mask);
+            }
+            continue;
+        }
+        for (int y = cy1; y <= cy2; y++)
+        {
+            uint8_t *dst = &s_band[((y - top) * s_width + cx1) * 2];
+            if ( s->bpp == 16 )
+            {
+                memcpy(dst, &s->buffer[((y - s->y) * s->w + cx1 - s->x) * 2], (cx2 - cx1 + 1) * 2);
+                continue;
+            }
+            for (int x = cx1; x <= cx2; x++)
+            {
+                uint16_t color = surface_pixel(s, x - s->x, y - s->y);
+                *dst++ = color >> 8;
+                *dst++ = color & 0xFF;
+            }
+        }
+    }
+}
+
+/* Copies composed band to s_shown and returns columns, which differ from display content */
+static span_t commit_band(lcduint_t b, int x1, int x2)
+{
+    span_t span = { x2 + 1, x1 - 1 };
+    if ( s_bpp == 1 )
+    {
+        uint8_t *shown = &s_shown[b * s_width];
+        while ( x1 <= x2 && shown[x1] == s_band[x1] ) x1++;
+        while ( x2 >= x1 && shown[x2] == s_band[x2] ) x2--;
+        if ( x1 <= x2 )
+        {
+            memcpy(&shown[x1], &s_band[x1], x2 - x1 + 1);
+            span.x1 = x1;
+            span.x2 = x2;
+        }
+        return span;
+    }
+    lcduint_t rows = (b << 3) + 8 <= s_height ? 8 : s_height - (b << 3);
+    for (lcduint_t r = 0; r < rows; r++)
+    {
+        uint8_t *shown = &s_shown[((b << 3) + r) * s_width * 2];
+        const uint8_t *band = &s_band[r * s_width * 2];
+        int l = x1;
+        int h = x2;
+        while ( l <= h && !memcmp(&shown[l * 2], &band[l * 2], 2) ) l++;
+        while ( h >= l && !memcmp(&shown[h * 2], &band[h * 2], 2) ) h--;
+        if ( l <= h )
+        {
+            memcpy(&shown[l * 2], &band[l * 2], (h - l + 1) * 2);
+            if ( span.x1 > l ) span.x1 = l;
+            if ( span.x2 < h ) span.x2 = h;
+        }
+    }
+    return span;
+}
+
+/* Sends columns x1-x2 of count bands, starting with band first, with single set_block() */
+static void send_run(lcduint_t first, lcduint_t count, lcdint_t x1, lcdint_t x2)
+{
+    lcduint_t w = x2 - x1 + 1;
+    s_blocks++;
+    if ( s_bpp == 1 )
+    {
+        ssd1306_lcd.set_block(x1, first, w);
+        for (lcduint_t b = first; b < first + count; b++)
+        {
+            ssd1306_lcd.send_pixels_buffer1(&s_shown[b * s_width + x1], w);
+            ssd1306_lcd.next_page();
+        }
+        ssd1306_intf.stop();
+        s_bytes += w * count;
+        return;
+    }
+    lcduint_t y = first << 3;
+    lcduint_t h = y + (count << 3) <= s_height ? (count << 3) : s_height - y;
+    ssd1306_drawBufferEx16(x1, y, w, h, s_width * 2, &s_shown[(y * s_width + x1) * 2]);
+    s_bytes += w * h * 2;
+}
+
+static void screen_flush(void)
+{
+    for (lcduint_t b = 0; b < s_bands; b++)
+    {
+        s_changed[b].x1 = 1;
+        s_changed[b].x2 = 0;
+        if ( s_dirty[b].x1 <= s_dirty[b].x2 )
+        {
+            compose_band(b, s_dirty[b].x1, s_dirty[b].x2);
+            s_changed[b] = commit_band(b, s_dirty[b].x1, s_dirty[b].x2);
+            s_dirty[b].x1 = s_width;
+            s_dirty[b].x2 = -1;
+        }
+    }
+    /* Adjacent bands are merged to single block, if their union costs less than new set_block() */
+    uint32_t columnBytes = s_bpp == 1 ? 1 : 16;
+    lcduint_t first = 0;
+    lcduint_t count = 0;
+    span_t run = { 1, 0 };
+    for (lcduint_t b = 0; b <= s_bands; b++)
+    {
+        span_t span = b < s_bands ? s_changed[b] : (span_t){ 1, 0 };
+        if ( span.x1 > span.x2 )
+        {
+            if ( count ) send_run(first, count, run.x1, run.x2);
+            count = 0;
+            continue;
+        }
+        if ( count )
+        {
+            lcdint_t ux1 = run.x1 < span.x1 ? run.x1 : span.x1;
+            lcdint_t ux2 = run.x2 > span.x2 ? run.x2 : span.x2;
+            uint32_t merged = (ux2 - ux1 + 1) * (count + 1);
+            uint32_t separate = (run.x2 - run.x1 + 1) * count + (span.x2 - span.x1 + 1);
+            if ( (merged - separate) * columnBytes <= SET_BLOCK_COST )
+            {
+                run.x1 = ux1;
+                run.x2 = ux2;
+                count++;
+                continue;
+            }
+            send_run(first, count, run.x1, run.x2);
+        }
+        first = b;
+        count = 1;
+        run = span;
+    }
+    s_frames++;
+}
+
+static int screen_init(void)
+{
+    s_width = ssd1306_lcd.width;
+    s_height = ssd1306_lcd.height;
+    s_bands = (s_height + 7) >> 3;
+    free(s_shown);
+    free(s_band);
+    free(s_dirty);
+    free(s_changed);
+    s_shown = (uint8_t *)calloc(s_bpp == 1 ? s_width * s_bands : s_width * s_height * 2, 1);
+    s_band = (uint8_t *)calloc(s_bpp == 1 ? s_width : s_width * 16, 1);
+    s_dirty = (span_t *)malloc(s_bands * sizeof(span_t));
+    s_changed = (span_t *)malloc(s_bands * sizeof(span_t));
+    if ( !s_shown || !s_band || !s_dirty || !s_changed )
+    {
+        return -1;
+    }
+    for (lcduint_t b = 0; b < s_bands; b++)
+    {
+        s_dirty[b].x1 = s_width;
+        s_dirty[b].x2 = -1;
+    }
+    if ( s_bpp == 1 )
+    {
+        ssd1306_clearScreen();
+    }
+    else
+    {
+        ssd1306_setMode(LCD_MODE_NORMAL);
+        ssd1306_fillScreen16(0);
+    }
+    s_frames = 0;
+    s_blocks = 0;
+    s_bytes = 0;
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          CLIENTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static void client_close(surface_t *s);
+
+/* Client, which doesn't read replies, must not block the daemon, so it is dropped */
+static void client_reply(surface_t *s, int32_t result, int fd)
+{
+    compositor_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = COMPOSITOR_REPLY;
+    msg.result = result;
+    if ( compositor_sendMsg(s->sock, &msg, fd, MSG_DONTWAIT) < 0 )
+    {
+        client_close(s);
+    }
+}
+
+static void client_close(surface_t *s)
+{
+    surface_damage(s, 0, 0, 0, 0);
+    if ( s->buffer )
+    {
+        munmap(s->buffer, s->size);
+    }
+    close(s->sock);
+    memset(s, 0, sizeof(*s));
+    s->sock = -1;
+    restack();
+}
+
+/* Creates shared memory for surface. The memory is sealed, so the client cannot *
+ * shrink it and crash the compositor with SIGBUS.                               */
+static int client_create(surface_t *s, const compositor_msg_t *msg)
+{
+    size_t size = compositor_surfaceSize(msg->w, msg->h, msg->bpp);
+    if ( s->buffer )
+    {
+        return -EEXIST;
+    }
+    if ( !size )
+    {
+        return -EINVAL;
+    }
+    int fd = memfd_create("ssd1306_surface", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if ( fd < 0 )
+    {
+        return -errno;
+    }
+    if ( ftruncate(fd, size) < 0 ||
+         fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0 )
+    {
+        int result = -errno;
+        close(fd);
+        return result;
+    }
+    void *buffer = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if ( buffer == MAP_FAILED )
+    {
+        int result = -errno;
+        close(fd);
+        return result;
+    }
+    s->buffer = (uint8_t *)buffer;
+    s->size = size;
+    s->x = msg->x;
+    s->y = msg->y;
+    s->w = msg->w;
+    s->h = msg->h;
+    s->bpp = msg->bpp;
+    s->z = msg->z;
+    s->visible = msg->visible;
+    s->order = s_order++;
+    restack();
+    surface_damage(s, 0, 0, 0, 0);
+    client_reply(s, 0, fd);
+    close(fd);
+    return 0;
+}
+
+static void client_message(surface_t *s)
+{
+    compositor_msg_t msg;
+    if ( compositor_recvMsg(s->sock, &msg, NULL) < 0 )
+    {
+        client_close(s);
+        return;
+    }
+    switch ( msg.type )
+    {
+        case COMPOSITOR_CREATE:
+        {
+            int result = client_create(s, &msg);
+            if ( result < 0 )
+            {
+                client_reply(s, result, -1);
+            }
+            break;
+        }
+        case COMPOSITOR_DAMAGE:
+            surface_damage(s, msg.x, msg.y, msg.w, msg.h);
+            break;
+        case COMPOSITOR_CONFIG:
+            if ( s->buffer )
+            {
+                surface_damage(s, 0, 0, 0, 0);
+                s->x = msg.x;
+                s->y = msg.y;
+                s->z = msg.z;
+                s->visible = msg.visible;
+                restack();
+                surface_damage(s, 0, 0, 0, 0);
+            }
+            break;
+        case COMPOSITOR_SYNC:
+            s->sync = 1;
+            s_pending = 1;
+            break;
+        default:
+            client_close(s);
+            break;
+    }
+}
+
+static void client_accept(void)
+{
+    int sock = accept4(s_listen, NULL, NULL, SOCK_CLOEXEC);
+    if ( sock < 0 )
+    {
+        return;
+    }
+    for (int i = 0; i < MAX_SURFACES; i++)
+    {
+        if ( s_surfaces[i].sock < 0 )
+        {
+            s_surfaces[i].sock = sock;
+            return;
+        }
+    }
+    close(sock);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          DAEMON
+//////////////////////////////////////////////////////////////////////////////////
+
+static int compositor_listen(const char *path)
+{
+    struct sockaddr_un addr;
+    for (int i = 0; i < MAX_SURFACES; i++)
+    {
+        s_surfaces[i].sock = -1;
+    }
+    s_listen = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if ( s_listen < 0 )
+    {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if ( bind(s_listen, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(s_listen, MAX_SURFACES) < 0 )
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", path, strerror(errno));
+        close(s_listen);
+        s_listen = -1;
+        return -1;
+    }
+    return 0;
+}
+
+static void compositor_shutdown(const char *path)
+{
+    for (int i = 0; i < MAX_SURFACES; i++)
+    {
+        if ( s_surfaces[i].sock >= 0 )
+        {
+            client_close(&s_surfaces[i]);
+        }
+    }
+    if ( s_listen >= 0 )
+    {
+        close(s_listen);
+        s_listen = -1;
+        unlink(path);
+    }
+}
+
+/* Waits for client messages and sends frame, when it is time. *
+ * Returns 1 if s_wakeFd is readable.                          */
+static int compositor_step(void)
+{
+    struct pollfd fds[MAX_SURFACES + 2];
+    surface_t *owners[MAX_SURFACES];
+    int count = 0;
+    int timeout = -1;
+    int woken = 0;
+    fds[count].fd = s_listen;
+    fds[count++].events = POLLIN;
+    fds[count].fd = s_wakeFd;
+    fds[count++].events = POLLIN;
+    for (int i = 0; i < MAX_SURFACES; i++)
+    {
+        if ( s_surfaces[i].sock >= 0 )
+        {
+            owners[count - 2] = &s_surfaces[i];
+            fds[count].fd = s_surfaces[i].sock;
+            fds[count++].events = POLLIN;
+        }
+    }
+    if ( s_pending )
+    {
+        uint32_t elapsed = millis() - s_lastFrame;
+        timeout = elapsed >= s_frameMs ? 0 : s_frameMs - elapsed;
+    }
+    if ( poll(fds, count, timeout) > 0 )
+    {
+        if ( fds[0].revents & POLLIN )
+        {
+            client_accept();
+        }
+        woken = (fds[1].revents & POLLIN) != 0;
+        for (int i = 2; i < count; i++)
+        {
+            if ( fds[i].revents & (POLLIN | POLLHUP | POLLERR) )
+            {
+                if ( owners[i - 2]->sock >= 0 ) client_message(owners[i - 2]);
+            }
+        }
+    }
+    if ( s_pending && millis() - s_lastFrame >= s_frameMs )
+    {
+        s_lastFrame = millis();
+        s_pending = 0;
+        screen_flush();
+        for (int i = 0; i < MAX_SURFACES; i++)
+        {
+            if ( s_surfaces[i].sock >= 0 && s_surfaces[i].sync )
+            {
+                s_surfaces[i].sync = 0;
+                client_reply(&s_surfaces[i], 0, -1);
+            }
+        }
+    }
+    return woken;
+}
+
+static void on_signal(int sig)
+{
+    s_quit = 1;
+}
+
+static int run_daemon(const char *path)
+{
+    if ( screen_init() < 0 || compositor_listen(path) < 0 )
+    {
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    while ( !s_quit )
+    {
+        compositor_step();
+    }
+    compositor_shutdown(path);
+    fprintf(stderr, "%u frames, %u blocks, %u bytes\n", s_frames, s_blocks, s_bytes);
+    ssd1306_intf.close();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          DEMO CLIENTS
+//////////////////////////////////////////////////////////////////////////////////
+
+/* Full screen monochrome surface with bouncing ball */
+static int demo_ui(const char *path, compositor_surface_t *surface)
+{
+    if ( compositor_connect(surface, path, 0, 0, DEMO_WIDTH, DEMO_HEIGHT, 1, 0) < 0 )
+    {
+        return -1;
+    }
+    NanoCanvas1 canvas(DEMO_WIDTH, DEMO_HEIGHT, surface->buffer);
+    NanoRect ball = { {20, 20}, {27, 27} };
+    NanoPoint speed = { 3, 2 };
+    canvas.setColor(0xFFFF);
+    canvas.drawRect(0, 0, DEMO_WIDTH - 1, DEMO_HEIGHT - 1);
+    compositor_damage(surface, 0, 0, 0, 0);
+    for (uint32_t i = 0; i < s_demoFrames; i++)
+    {
+        canvas.setColor(0);
+        canvas.fillRect(ball);
+        compositor_damage(surface, ball.p1.x, ball.p1.y, 8, 8);
+        ball += speed;
+        if ( ball.p1.x <= 1 || ball.p2.x >= DEMO_WIDTH - 2 ) speed.x = -speed.x;
+        if ( ball.p1.y <= 1 || ball.p2.y >= DEMO_HEIGHT - 2 ) speed.y = -speed.y;
+        canvas.setColor(0xFFFF);
+        canvas.fillRect(ball);
+        compositor_damage(surface, ball.p1.x, ball.p1.y, 8, 8);
+        if ( compositor_sync(surface) < 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* 8-bit status line on top of the screen */
+static int demo_status(const char *path, compositor_surface_t *surface)
+{
+    char text[24];
+    if ( compositor_connect(surface, path, 0, 0, DEMO_WIDTH, 8, 8, 1) < 0 )
+    {
+        return -1;
+    }
+    NanoCanvas8 canvas(DEMO_WIDTH, 8, surface->buffer);
+    canvas.setColor(RGB_COLOR8(255, 255, 0));
+    for (uint32_t i = 0; i < s_demoFrames; i++)
+    {
+        snprintf(text, sizeof(text), "status %05u", i);
+        canvas.printFixed(0, 0, text);
+        /* Only digits change */
+        compositor_damage(surface, 42, 0, 30, 8);
+        if ( compositor_sync(surface) < 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* 16-bit alarm popup, blinking and moving over other surfaces */
+static int demo_alarm(const char *path, compositor_surface_t *surface)
+{
+    int16_t x = 24;
+    if ( compositor_connect(surface, path, x, 28, 48, 16, 16, 2) < 0 )
+    {
+        return -1;
+    }
+    NanoCanvas16 canvas(48, 16, surface->buffer);
+    canvas.setColor(RGB_COLOR16(255, 0, 0));
+    canvas.fillRect(0, 0, 47, 15);
+    canvas.setColor(RGB_COLOR16(255, 255, 255));
+    canvas.drawRect(0, 0, 47, 15);
+    canvas.printFixed(9, 4, "ALARM");
+    compositor_damage(surface, 0, 0, 0, 0);
+    for (uint32_t i = 0; i < s_demoFrames; i++)
+    {
+        x = 24 + (i % 32);
+        compositor_configure(surface, x, 28, 2, (i & 8) ? 0 : 1);
+        if ( compositor_sync(surface) < 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int run_demo(const char *name, const char *path)
+{
+    compositor_surface_t surface;
+    int result;
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    if ( !strcmp(name, "ui") ) result = demo_ui(path, &surface);
+    else if ( !strcmp(name, "status") ) result = demo_status(path, &surface);
+    else if ( !strcmp(name, "alarm") ) result = demo_alarm(path, &surface);
+    else
+    {
+        fprintf(stderr, "Unknown client: %s\n", name);
+        return 1;
+    }
+    compositor_disconnect(&surface);
+    return result < 0 ? 1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          SELF TEST
+//////////////////////////////////////////////////////////////////////////////////
+
+/* Checks framebuffer content against straightforward per-pixel composition */
+static uint32_t check_content(void)
+{
+    const uint8_t *fb = linux_fb_getBuffer();
+    uint32_t lineLength = linux_fb_getLineLength();
+    uint32_t errors = 0;
+    for (lcduint_t y = 0; y < s_height; y++)
+    {
+        for (lcduint_t x = 0; x < s_width; x++)
+        {
+            uint16_t expected = 0;
+            for (int i = s_stackSize - 1; i >= 0; i--)
+            {
+                const surface_t *s = s_stack[i];
+                if ( (int)x >= s->x && (int)x < s->x + s->w && (int)y >= s->y && (int)y < s->y + s->h )
+                {
+                    expected = surface_pixel(s, x - s->x, y - s->y);
+                    break;
+                }
+            }
+            uint16_t actual;
+            if ( s_bpp == 1 )
+            {
+                actual = (fb[y * lineLength + (x >> 3)] >> (x & 7)) & 1;
+                expected = expected ? 1 : 0;
+            }
+            else
+            {
+                actual = ((const uint16_t *)(fb + y * lineLength))[x];
+            }
+            errors += actual != expected;
+        }
+    }
+    return errors;
+}
+
+static int run_selftest_bpp(uint8_t bpp)
+{
+    static const char *clients[] = { "ui", "status", "alarm" };
+    const int clientCount = sizeof(clients) / sizeof(clients[0]);
+    char path[64];
+    char fbPath[64];
+    int done[2];
+    pid_t pids[clientCount];
+
+    snprintf(path, sizeof(path), "/tmp/compositor_%d.sock", (int)getpid());
+    snprintf(fbPath, sizeof(fbPath), "/tmp/compositor_%d.fb", (int)getpid());
+    if ( linux_fb_init(fbPath, DEMO_WIDTH, DEMO_HEIGHT, bpp) < 0 )
+    {
+        return 1;
+    }
+    s_bpp = bpp == 1 ? 1 : 16;
+    s_frameMs = 0;
+    if ( screen_init() < 0 || compositor_listen(path) < 0 || pipe(done) < 0 )
+    {
+        return 1;
+    }
+    s_wakeFd = done[0];
+    for (int i = 0; i < clientCount; i++)
+    {
+        pids[i] = fork();
+        if ( pids[i] == 0 )
+        {
+            compositor_surface_t surface;
+            compositor_msg_t msg;
+            close(s_listen);
+            close(done[0]);
+            /* Clients start one by one, so z-order ties are resolved the same way each run */
+            usleep(i * 20000);
+            ssd1306_setFixedFont(ssd1306xled_font6x8);
+            int result = !strcmp(clients[i], "ui") ? demo_ui(path, &surface) :
+                         !strcmp(clients[i], "status") ? demo_status(path, &surface) :
+                         demo_alarm(path, &surface);
+            char ch = result < 0 ? 1 : 0;
+            if ( write(done[1], &ch, 1) != 1 )
+            {
+                _exit(1);
+            }
+            /* Surface stays on the screen until compositor closes connection */
+            compositor_recvMsg(surface.sock, &msg, NULL);
+            _exit(0);
+        }
+    }
+    close(done[1]);
+    int finished = 0;
+    int failed = 0;
+    while ( finished < clientCount )
+    {
+        if ( compositor_step() )
+        {
+            char ch;
+            if ( read(done[0], &ch, 1) != 1 )
+            {
+                failed = 1;
+                break;
+            }
+            finished++;
+            failed |= ch;
+        }
+    }
+    uint32_t errors = check_content();
+    uint32_t raw = s_frames * (s_bpp == 1 ? s_width * s_bands : s_width * s_height * 2);
+    printf("%2d bpp display\n", bpp);
+    printf("  frames:          %u\n", s_frames);
+    printf("  set_block calls: %u (%.1f per frame)\n", s_blocks, s_frames ? (double)s_blocks / s_frames : 0.0);
+    printf("  pixel bytes:     %u (full frames: %u, reduction %.1fx)\n", s_bytes, raw,
+           s_bytes ? (double)raw / s_bytes : 0.0);
+    printf("  content:         %s\n", !failed && !errors ? "match" : "MISMATCH");
+    compositor_shutdown(path);
+    for (int i = 0; i < clientCount; i++)
+    {
+        waitpid(pids[i], NULL, 0);
+    }
+    close(done[0]);
+    s_wakeFd = -1;
+    linux_fb_close();
+    unlink(fbPath);
+    return !failed && !errors ? 0 : 2;
+}
+
+static int run_selftest(void)
+{
+    signal(SIGPIPE, SIG_IGN);
+    int result = run_selftest_bpp(1);
+    if ( result == 0 )
+    {
+        result = run_selftest_bpp(16);
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          MAIN
+//////////////////////////////////////////////////////////////////////////////////
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options] [-d | -c client]\n", name);
+    fprintf(stderr, "    Without -d and -c runs self test with framebuffer in temporary file\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "        -d            run compositor daemon on ssd1306 128x64 i2c display\n");
+    fprintf(stderr, "        -c client     run demo client: ui, status or alarm\n");
+    fprintf(stderr, "        -l path       socket path (default: %s)\n", COMPOSITOR_SOCKET);
+    fprintf(stderr, "        -f device     daemon: output to framebuffer device or file instead of i2c display\n");
+    fprintf(stderr, "        -b bpp        daemon: bits per pixel for framebuffer file, 1 or 16 (default: 1)\n");
+    fprintf(stderr, "        -r fps        daemon: maximum frame rate (default: 30)\n");
+    fprintf(stderr, "        -n frames     demo client: number of frames (default: 200)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = COMPOSITOR_SOCKET;
+    const char *client = NULL;
+    const char *device = NULL;
+    int daemon = 0;
+    uint8_t bpp = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if ( !strcmp(argv[i], "-d") )
+        {
+            daemon = 1;
+            continue;
+        }
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if ( !value )
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        if ( !strcmp(argv[i], "-c") ) client = value;
+        else if ( !strcmp(argv[i], "-l") ) path = value;
+        else if ( !strcmp(argv[i], "-f") ) device = value;
+        else if ( !strcmp(argv[i], "-b") ) bpp = strtoul(value, NULL, 0);
+        else if ( !strcmp(argv[i], "-r") ) s_frameMs = 1000 / (strtoul(value, NULL, 0) ? strtoul(value, NULL, 0) : 1);
+        else if ( !strcmp(argv[i], "-n") ) s_demoFrames = strtoul(value, NULL, 0);
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if ( client )
+    {
+        return run_demo(client, path);
+    }
+    if ( daemon )
+    {
+        if ( device )
+        {
+            if ( linux_fb_init(device, DEMO_WIDTH, DEMO_HEIGHT, bpp) < 0 )
+            {
+                return 1;
+            }
+            s_bpp = linux_fb_getBpp() == 1 ? 1 : 16;
+        }
+        else
+        {
+            ssd1306_128x64_i2c_init();
+            s_bpp = 1;
+        }
+        return run_daemon(path);
+    }
+    return run_selftest();
+}
@@ -0,0 +1,146 @@
+#!/usr/bin/python
+# -*- coding: UTF-8 -*-
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Converts image to compressed format, supported by ssd1306_drawRleImage()
+# Requires PIL (pip install Pillow)
+
+import os
+import sys
+from PIL import Image
+
+def print_help_and_exit():
+    print("Usage: imgencoder.py [args] image > outputFile")
+    print("args:")
+    print("      -b <N>    bits per pixel: 1, 8 or 16 (default 1)")
+    print("      -n <S>    name of C array (default is image file name)")
+    print("      -t <N>    threshold for 1-bit images 0-255 (default 128)")
+    print("      -i        invert 1-bit image")
+    print("Examples:")
+    print("   [convert logo.png to monochrome compressed image]")
+    print("      imgencoder.py -b 1 logo.png > logo.h")
+    print("   [convert photo.png to 16-bit compressed image]")
+    print("      imgencoder.py -b 16 -n photo photo.png > photo.h")
+    exit(1)
+
+def image_units(img, bpp, threshold, invert):
+    width, height = img.size
+    units = []
+    if bpp == 1:
+        gray = img.convert("L")
+        pixels = gray.load()
+        for page in range((height + 7) // 8):
+            for x in range(width):
+                data = 0
+                for bit in range(8):
+                    y = page * 8 + bit
+                    if y >= height:
+                        break
+                    lit = pixels[x, y] >= threshold
+                    if lit != invert:
+                        data |= (1 << bit)
+                units.append([data])
+    else:
+        rgb = img.convert("RGB")
+        pixels = rgb.load()
+        for y in range(height):
+            for x in range(width):
+                r, g, b = pixels[x, y]
+                if bpp == 8:
+                    units.append([(r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6)])
+                else:
+                    color = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+                    units.append([color >> 8, color & 0xFF])
+    return units
+
+def encode_rle(units):
+    packets = []
+    i = 0
+    count = len(units)
+    literal = []
+    while i < count:
+        run = 1
+        while i + run < count and run < 128 and units[i + run] == units[i]:
+            run += 1
+        if run >= 2:
+            if literal:
+                packets.append([len(literal) - 1] + sum(literal, []))
+                literal = []
+            packets.append([0x80 | (run - 1)] + units[i])
+            i += run
+        else:
+            literal.append(units[i])
+            if len(literal) == 128:
+                packets.append([len(literal) - 1] + sum(literal, []))
+                literal = []
+            i += 1
+    if literal:
+        packets.append([len(literal) - 1] + sum(literal, []))
+    return packets
+
+bpp = 1
+name = None
+threshold = 128
+invert = False
+filename = None
+
+args = sys.argv[1:]
+while args:
+    arg = args.pop(0)
+    if arg == "-b" and args:
+        bpp = int(args.pop(0))
+    elif arg == "-n" and args:
+        name = args.pop(0)
+    elif arg == "-t" and args:
+        threshold = int(args.pop(0))
+    elif arg == "-i":
+        invert = True
+    elif arg.startswith("-"):
+        print_help_and_exit()
+    else:
+        filename = arg
+
+if filename is None or bpp not in (1, 8, 16):
+    print_help_and_exit()
+
+if name is None:
+    name = os.path.splitext(os.path.basename(filename))[0]
+    name = "".join([c if c.isalnum() else "_" for c in name])
+
+img = Image.open(filename)
+width, height = img.size
+if bpp == 1:
+    height = (height + 7) // 8 * 8
+packets = encode_rle(image_units(img, bpp, threshold, invert))
+data = [bpp, width >> 8, width & 0xFF, height >> 8, height & 0xFF]
+raw_size = width * height * bpp // 8
+
+print("// %s: %dx%d, %d bpp, %d bytes (%d bytes uncompressed)" %
+      (os.path.basename(filename), width, height, bpp, len(data) + len(sum(packets, [])), raw_size))
+print("const uint8_t %s[] PROGMEM =" % name)
+print("{")
+print("    " + ", ".join(["0x%02X" % x for x in data]) + ",")
+for packet in packets:
+    print("    " + ", ".join(["0x%02X" % x for x in packet]) + ",")
+print("};")
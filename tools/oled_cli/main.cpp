@@ -23,24 +23,54 @@
 */
 
 #include "ssd1306.h"
+#include "nano_engine.h"
 #include "intf/ssd1306_interface.h"
 #include "intf/i2c/ssd1306_i2c.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
+typedef struct
+{
+    const char *name;
+    void (*init)(void);
+    /* 1 - monochrome canvas in ssd1306 compatible mode, 8 - RGB332 canvas in normal mode */
+    uint8_t bpp;
+} oled_driver_t;
+
+static const oled_driver_t s_drivers[] =
+{
+    { "ssd1306_128x64",  ssd1306_128x64_init,  1 },
+    { "ssd1306_128x32",  ssd1306_128x32_init,  1 },
+    { "sh1106_128x64",   sh1106_128x64_init,   1 },
+    { "pcd8544_84x48",   pcd8544_84x48_init,   1 },
+    { "ssd1325_128x64",  ssd1325_128x64_init,  1 },
+    { "ssd1327_128x128", ssd1327_128x128_init, 1 },
+    { "ssd1331_96x64",   ssd1331_96x64_init,   8 },
+    { "ssd1351_128x128", ssd1351_128x128_init, 8 },
+    { "il9163_128x128",  il9163_128x128_init,  8 },
+    { "st7735_128x160",  st7735_128x160_init,  8 },
+    { "ili9341_240x320", ili9341_240x320_init, 8 },
+};
+
+static const oled_driver_t *s_driver = NULL;
+static int s_dcPin = -1;
 
 int init_interface(char *intf, char *bus, char *devId)
 {
     if (!strcmp(intf, "spi"))
     {
-        ssd1306_platform_spiInit(bus[0] - '0', strtol(devId, NULL, 16), -1);
+        ssd1306_platform_spiInit(bus[0] - '0', strtol(devId, NULL, 16), s_dcPin);
     }
     else if (!strcmp(intf, "i2c"))
     {
-        ssd1306_platform_i2cInit(bus[0] - '0', strtol(devId, NULL, 16), -1);
-//        ssd1306_i2cInitEx(bus[0] - '0', bus[0] - '0', strtol(devId, NULL, 16));
+        ssd1306_platform_i2cInit(bus[0] - '0', strtol(devId, NULL, 16), NULL);
     }
     else
     {
@@ -51,8 +81,15 @@ int init_interface(char *intf, char *bus, char *devId)
 
 int init_driver(char *driver)
 {
-    if (!strcmp(driver, "ssd1306_128x64")) ssd1306_128x64_init();
-    else return -1;
+    for (unsigned i = 0; i < sizeof(s_drivers) / sizeof(s_drivers[0]); i++)
+    {
+        if (!strcmp(driver, s_drivers[i].name))
+        {
+            s_driver = &s_drivers[i];
+        }
+    }
+    if (!s_driver) return -1;
+    s_driver->init();
     ssd1306_fillScreen(0x00);
     ssd1306_setFixedFont(ssd1306xled_font6x8);
     ssd1306_printFixed (0,  8, "ssd1306 library", STYLE_NORMAL);
@@ -146,28 +183,426 @@ int execute_mono_cmd(int argc, char *argv[])
     return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+//                          BINARY MODE
+//////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Each binary command is: opcode (1 byte), payload length (2 bytes, little endian),
+ * payload. All coordinates and sizes are 16-bit little endian signed values.
+ * Commands are drawn to memory canvas, and only changed area is sent to the display
+ * on SYNC command, or once per frame period if it is specified.
+ */
+enum
+{
+    OLED_CMD_NOP    = 0x00, ///< no operation
+    OLED_CMD_SYNC   = 0x01, ///< send changed area to display
+    OLED_CMD_CLEAR  = 0x02, ///< [color] fills canvas with color, 0 by default
+    OLED_CMD_COLOR  = 0x03, ///< color: sets color for next commands
+    OLED_CMD_RECT   = 0x04, ///< x1, y1, x2, y2: draws rectangle
+    OLED_CMD_FILL   = 0x05, ///< x1, y1, x2, y2: fills rectangle
+    OLED_CMD_LINE   = 0x06, ///< x1, y1, x2, y2: draws line
+    OLED_CMD_BITMAP = 0x07, ///< x, y, w, h, data: draws monochrome bitmap with current color
+    OLED_CMD_TEXT   = 0x08, ///< x, y, style (1 byte), text: prints text with 6x8 font
+    OLED_CMD_BLIT   = 0x09, ///< x, y, w, h, data: copies pixels in canvas format to region
+    OLED_CMD_QUIT   = 0x0F, ///< flushes canvas and stops the tool
+};
+
+#define OLED_CMD_HEADER_SIZE   3
+#define OLED_CMD_MAX_SIZE      (OLED_CMD_HEADER_SIZE + 0xFFFF)
+#define OLED_READ_CHUNK_SIZE   65536
+
+static inline lcdint_t get16(const uint8_t *p)
+{
+    return static_cast<int16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t millis_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+template <class C>
+class CommandProcessor
+{
+public:
+    CommandProcessor(uint8_t *buffer)
+        : m_canvas(ssd1306_lcd.width, ssd1306_lcd.height, buffer)
+    {
+        m_canvas.clear();
+        m_canvas.setColor( m_color );
+    }
+
+    /** Executes single command, returns -1 on QUIT command, 1 on SYNC command */
+    int execute(uint8_t opcode, const uint8_t *data, uint16_t len);
+
+    /** Sends changed area to the display */
+    void flush();
+
+    bool isDirty() const { return m_dirty; }
+
+private:
+    C m_canvas;
+    NanoRect m_rect;
+    uint16_t m_color = 0xFFFF;
+    bool m_dirty = false;
+
+    void invalidate(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+    void blit(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data);
+};
+
+template <class C>
+void CommandProcessor<C>::invalidate(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if ( x1 > x2 ) { lcdint_t t = x1; x1 = x2; x2 = t; }
+    if ( y1 > y2 ) { lcdint_t t = y1; y1 = y2; y2 = t; }
+    if ( x1 < 0 ) x1 = 0;
+    if ( y1 < 0 ) y1 = 0;
+    if ( x2 >= (lcdint_t)ssd1306_lcd.width ) x2 = ssd1306_lcd.width - 1;
+    if ( y2 >= (lcdint_t)ssd1306_lcd.height ) y2 = ssd1306_lcd.height - 1;
+    if ( x1 > x2 || y1 > y2 )
+    {
+        return;
+    }
+    if ( !m_dirty )
+    {
+        m_rect = { {x1, y1}, {x2, y2} };
+        m_dirty = true;
+        return;
+    }
+    if ( x1 < m_rect.p1.x ) m_rect.p1.x = x1;
+    if ( y1 < m_rect.p1.y ) m_rect.p1.y = y1;
+    if ( x2 > m_rect.p2.x ) m_rect.p2.x = x2;
+    if ( y2 > m_rect.p2.y ) m_rect.p2.y = y2;
+}
+
+template <class C>
+int CommandProcessor<C>::execute(uint8_t opcode, const uint8_t *data, uint16_t len)
+{
+    static const uint16_t minLen[16] = { 0, 0, 0, 2, 8, 8, 8, 8, 5, 8, 0, 0, 0, 0, 0, 0 };
+    if ( opcode < 16 && len < minLen[opcode] )
+    {
+        fprintf(stderr, "Command 0x%02X is too short: %u bytes\n", opcode, len);
+        return 0;
+    }
+    switch ( opcode )
+    {
+    case OLED_CMD_NOP:
+        break;
+    case OLED_CMD_SYNC:
+        return 1;
+    case OLED_CMD_CLEAR:
+    {
+        m_canvas.setColor( len >= 2 ? get16(data) : 0 );
+        m_canvas.fillRect( 0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1 );
+        m_canvas.setColor( m_color );
+        invalidate( 0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1 );
+        break;
+    }
+    case OLED_CMD_COLOR:
+        m_color = get16(data);
+        m_canvas.setColor( m_color );
+        break;
+    case OLED_CMD_RECT:
+    case OLED_CMD_FILL:
+    case OLED_CMD_LINE:
+    {
+        lcdint_t x1 = get16(&data[0]), y1 = get16(&data[2]);
+        lcdint_t x2 = get16(&data[4]), y2 = get16(&data[6]);
+        if ( opcode == OLED_CMD_LINE ) m_canvas.drawLine( x1, y1, x2, y2 );
+        else if ( opcode == OLED_CMD_RECT ) m_canvas.drawRect( x1, y1, x2, y2 );
+        else m_canvas.fillRect( x1, y1, x2, y2 );
+        invalidate( x1, y1, x2, y2 );
+        break;
+    }
+    case OLED_CMD_BITMAP:
+    case OLED_CMD_BLIT:
+    {
+        lcdint_t x = get16(&data[0]), y = get16(&data[2]);
+        int16_t w = get16(&data[4]), h = get16(&data[6]);
+        if ( w <= 0 || h <= 0 )
+        {
+            fprintf(stderr, "Command 0x%02X has wrong size: %dx%d\n", opcode, w, h);
+            break;
+        }
+        /* w and h are positive 16-bit values, so size fits 64 bits without overflow */
+        uint64_t size = opcode == OLED_CMD_BITMAP || C::BITS_PER_PIXEL == 1
+                      ? (uint64_t)w * ((h + 7) >> 3)
+                      : (uint64_t)w * h * (C::BITS_PER_PIXEL >> 3);
+        if ( (uint64_t)(len - 8) < size )
+        {
+            fprintf(stderr, "Command 0x%02X has wrong size: %u bytes\n", opcode, len);
+            break;
+        }
+        if ( opcode == OLED_CMD_BITMAP ) m_canvas.drawBitmap1( x, y, w, h, &data[8] );
+        else blit( x, y, w, h, &data[8] );
+        invalidate( x, y, x + w - 1, y + h - 1 );
+        break;
+    }
+    case OLED_CMD_TEXT:
+    {
+        char text[256];
+        uint16_t size = len - 5 < (uint16_t)sizeof(text) - 1 ? len - 5 : sizeof(text) - 1;
+        memcpy( text, &data[5], size );
+        text[size] = '\0';
+        lcdint_t x = get16(&data[0]), y = get16(&data[2]);
+        m_canvas.printFixed( x, y, text, static_cast<EFontStyle>(data[4]) );
+        lcduint_t height;
+        lcduint_t width = ssd1306_getTextSize( text, &height );
+        invalidate( x, y, x + width - 1, y + height - 1 );
+        break;
+    }
+    case OLED_CMD_QUIT:
+        return -1;
+    default:
+        fprintf(stderr, "Unknown command 0x%02X\n", opcode);
+        break;
+    }
+    return 0;
+}
+
+template <>
+void CommandProcessor<NanoCanvas1>::blit(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data)
+{
+    /* Clear the region, so that both set and cleared pixels of the bitmap are copied */
+    m_canvas.setColor( BLACK );
+    m_canvas.fillRect( x, y, x + w - 1, y + h - 1 );
+    m_canvas.setColor( WHITE );
+    m_canvas.drawBitmap1( x, y, w, h, data );
+    m_canvas.setColor( m_color );
+}
+
+template <>
+void CommandProcessor<NanoCanvas8>::blit(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data)
+{
+    m_canvas.drawBitmap8( x, y, w, h, data );
+}
+
+template <>
+void CommandProcessor<NanoCanvas1>::flush()
+{
+    if ( !m_dirty ) return;
+    const uint8_t *buf = m_canvas.getData();
+    lcduint_t w = m_rect.p2.x - m_rect.p1.x + 1;
+    for (lcdint_t page = m_rect.p1.y >> 3; page <= (m_rect.p2.y >> 3); page++)
+    {
+        ssd1306_drawBuffer( m_rect.p1.x, page, w, 8, &buf[page * ssd1306_lcd.width + m_rect.p1.x] );
+    }
+    m_dirty = false;
+}
+
+template <>
+void CommandProcessor<NanoCanvas8>::flush()
+{
+    if ( !m_dirty ) return;
+    const uint8_t *buf = m_canvas.getData();
+    ssd1306_drawBufferEx8( m_rect.p1.x, m_rect.p1.y,
+                           m_rect.p2.x - m_rect.p1.x + 1, m_rect.p2.y - m_rect.p1.y + 1,
+                           ssd1306_lcd.width, &buf[m_rect.p1.y * ssd1306_lcd.width + m_rect.p1.x] );
+    m_dirty = false;
+}
+
+/**
+ * Reads binary commands from fd until end of stream or QUIT command.
+ * Returns -1 if QUIT command is received.
+ */
+template <class C>
+static int process_stream(CommandProcessor<C> &proc, int fd, int period)
+{
+    static uint8_t buffer[OLED_CMD_MAX_SIZE + OLED_READ_CHUNK_SIZE];
+    uint32_t len = 0;
+    uint32_t lastFlush = millis_now();
+    bool sync = false;
+    for (;;)
+    {
+        /* Wait for the data, but not longer than till the end of frame period */
+        int timeout = -1;
+        if ( period > 0 && (sync || proc.isDirty()) )
+        {
+            int32_t left = period - (int32_t)(millis_now() - lastFlush);
+            timeout = left > 0 ? left : 0;
+        }
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int n = poll( &pfd, 1, timeout );
+        if ( n > 0 )
+        {
+            n = read( fd, &buffer[len], OLED_READ_CHUNK_SIZE );
+            if ( n <= 0 )
+            {
+                break;
+            }
+            len += n;
+            uint32_t pos = 0;
+            while ( len - pos >= OLED_CMD_HEADER_SIZE )
+            {
+                uint16_t size = buffer[pos + 1] | (buffer[pos + 2] << 8);
+                if ( len - pos < (uint32_t)OLED_CMD_HEADER_SIZE + size )
+                {
+                    break;
+                }
+                int result = proc.execute( buffer[pos], &buffer[pos + OLED_CMD_HEADER_SIZE], size );
+                pos += OLED_CMD_HEADER_SIZE + size;
+                if ( result < 0 )
+                {
+                    proc.flush();
+                    return -1;
+                }
+                if ( result > 0 )
+                {
+                    sync = true;
+                }
+            }
+            memmove( buffer, &buffer[pos], len - pos );
+            len -= pos;
+        }
+        /* Without frame period the canvas is sent on each SYNC command, *
+         * otherwise changes are sent not more than once per period      */
+        if ( period <= 0 ? sync : (millis_now() - lastFlush >= (uint32_t)period) )
+        {
+            if ( sync || proc.isDirty() )
+            {
+                proc.flush();
+                lastFlush = millis_now();
+            }
+            sync = false;
+        }
+    }
+    proc.flush();
+    return 0;
+}
+
+static int open_socket(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( fd < 0 )
+    {
+        perror("socket");
+        return -1;
+    }
+    memset( &addr, 0, sizeof(addr) );
+    addr.sun_family = AF_UNIX;
+    strncpy( addr.sun_path, path, sizeof(addr.sun_path) - 1 );
+    unlink( path );
+    if ( bind( fd, (struct sockaddr *)&addr, sizeof(addr) ) < 0 || listen( fd, 1 ) < 0 )
+    {
+        perror(path);
+        close( fd );
+        return -1;
+    }
+    return fd;
+}
+
+template <class C>
+static int run_binary(const char *socketPath, int period)
+{
+    uint8_t *buffer = (uint8_t *)malloc( (uint32_t)ssd1306_lcd.width * ssd1306_lcd.height * C::BITS_PER_PIXEL / 8 );
+    CommandProcessor<C> proc( buffer );
+    int result = 0;
+    if ( !socketPath )
+    {
+        process_stream( proc, STDIN_FILENO, period );
+    }
+    else
+    {
+        int server = open_socket( socketPath );
+        result = server < 0 ? 1 : 0;
+        /* Clients are served one by one, canvas content is kept between connections */
+        while ( server >= 0 )
+        {
+            int client = accept( server, NULL, NULL );
+            if ( client < 0 )
+            {
+                perror("accept");
+                result = 1;
+                break;
+            }
+            int quit = process_stream( proc, client, period );
+            close( client );
+            if ( quit < 0 )
+            {
+                break;
+            }
+        }
+        if ( server >= 0 )
+        {
+            close( server );
+            unlink( socketPath );
+        }
+    }
+    free( buffer );
+    return result;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: oled_cli [options] [interface] [bus] [devId] [oled_driver]\n");
+    fprintf(stderr, "        interface     - spi, i2c\n");
+    fprintf(stderr, "        bus           - i2c-bus number or spidev  bus number\n");
+    fprintf(stderr, "        devId         - i2c-bus device address or spi device number in hex\n");
+    fprintf(stderr, "        oled_driver   - Oled driver name:\n");
+    for (unsigned i = 0; i < sizeof(s_drivers) / sizeof(s_drivers[0]); i++)
+    {
+        fprintf(stderr, "                        %s\n", s_drivers[i].name);
+    }
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "        -d pin        D/C gpio pin for spi displays\n");
+    fprintf(stderr, "        -b            binary commands mode\n");
+    fprintf(stderr, "        -u path       read binary commands from unix socket instead of stdin\n");
+    fprintf(stderr, "        -p ms         binary mode: send changes once per period, 0 - on SYNC only (default)\n");
+    fprintf(stderr, "Example: oled_cli i2c 1 0x3c ssd1306_128x64\n");
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc < 5)
+    bool binary = false;
+    const char *socketPath = NULL;
+    int period = 0;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if ( !strcmp(argv[i], "-b") ) binary = true;
+        else if ( !strcmp(argv[i], "-d") && i + 1 < argc ) s_dcPin = atoi_(argv[++i]);
+        else if ( !strcmp(argv[i], "-u") && i + 1 < argc ) { socketPath = argv[++i]; binary = true; }
+        else if ( !strcmp(argv[i], "-p") && i + 1 < argc ) period = atoi_(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (argc - i < 4)
     {
-        fprintf(stderr, "Usage: oled_cli [interface] [bus] [devId] [oled_driver]\n");
-        fprintf(stderr, "        interface     - spi, i2c\n");
-        fprintf(stderr, "        bus           - i2c-bus number or spidev  bus number\n");
-        fprintf(stderr, "        devId         - i2c-bus device address or spi device number in hex\n");
-        fprintf(stderr, "        oled_driver   - Oled driver name\n");
-        fprintf(stderr, "Example: oled_cli i2c 1 0x3c ssd1306_128x64\n");
+        usage();
         return 1;
     }
-    if (init_interface(argv[1], argv[2], argv[3]) < 0)
+    if (init_interface(argv[i], argv[i + 1], argv[i + 2]) < 0)
     {
         fprintf(stderr, "Error\n");
         return 1;
     }
-    if (init_driver(argv[4]) < 0)
+    if (init_driver(argv[i + 3]) < 0)
     {
         fprintf(stderr, "Error2\n");
         return 1;
     }
+    if (binary)
+    {
+        int result;
+        if ( s_driver->bpp == 8 )
+        {
+            ssd1306_setMode( LCD_MODE_NORMAL );
+            result = run_binary<NanoCanvas8>( socketPath, period );
+        }
+        else
+        {
+            result = run_binary<NanoCanvas1>( socketPath, period );
+        }
+        ssd1306_intf.close();
+        return result;
+    }
     fprintf(stderr, "Enter command\n");
     char str[16384];
     while (fgets(str, sizeof str, stdin))
@@ -181,4 +616,3 @@ int main(int argc, char *argv[])
     ssd1306_intf.close();
     return 0;
 }
-
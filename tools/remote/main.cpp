@@ -0,0 +1,328 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Remote display tool.
+ *
+ * Sender draws animated scene on remote display and sends deltas to serial device.
+ * Receiver reads serial device and outputs received content to ssd1306 128x64 i2c
+ * display (or SDL emulator, when compiled with SDL_EMULATION). Self test runs sender
+ * and receiver, connected via Linux pseudo-terminal, and compares their content.
+ */
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+#include "lcd/remote_display.h"
+#include "intf/ssd1306_interface.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define REMOTE_WIDTH    128
+#define REMOTE_HEIGHT   64
+#define REMOTE_SIZE     (REMOTE_WIDTH * REMOTE_HEIGHT / 8)
+#define BALL_SIZE       8
+
+typedef struct
+{
+    uint32_t wireBytes;
+    remote_receiver_stats_t stats;
+    uint8_t content[REMOTE_SIZE];
+} receiver_result_t;
+
+static uint8_t s_buffer[REMOTE_SIZE * 2];
+static uint32_t s_frames = 200;
+static uint32_t s_baud = 115200;
+static int s_keyInterval = -1;
+static uint32_t s_errorRate = 0;
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          SENDER
+//////////////////////////////////////////////////////////////////////////////////
+
+static NanoEngine1 engine;
+static NanoRect s_ball;
+static NanoPoint s_speed;
+static uint32_t s_frame;
+
+static bool drawScene()
+{
+    char text[16];
+    engine.canvas.clear();
+    engine.canvas.drawRect(0, 0, REMOTE_WIDTH - 1, REMOTE_HEIGHT - 1);
+    engine.canvas.fillRect(s_ball);
+    snprintf(text, sizeof(text), "%05u", s_frame);
+    engine.canvas.printFixed(4, 4, text);
+    return true;
+}
+
+static void scene_begin(void)
+{
+    remote_display_init(REMOTE_WIDTH, REMOTE_HEIGHT, s_buffer);
+    if ( s_keyInterval >= 0 )
+    {
+        remote_display_setKeyInterval(s_keyInterval);
+    }
+    s_ball = (NanoRect){ {20, 20}, {20 + BALL_SIZE - 1, 20 + BALL_SIZE - 1} };
+    s_speed = (NanoPoint){ 3, 2 };
+    s_frame = 0;
+    engine.begin();
+    engine.drawCallback(drawScene);
+    engine.refresh();
+}
+
+/* Moves the ball, renders the frame and returns number of bytes sent */
+static uint32_t scene_frame(void)
+{
+    engine.refresh(s_ball);
+    s_ball += s_speed;
+    if ( s_ball.p1.x <= 1 || s_ball.p2.x >= REMOTE_WIDTH - 2 ) s_speed.x = -s_speed.x;
+    if ( s_ball.p1.y <= 1 || s_ball.p2.y >= REMOTE_HEIGHT - 2 ) s_speed.y = -s_speed.y;
+    engine.refresh(s_ball);
+    engine.refresh(4, 4, 4 + 6 * 5 - 1, 11);
+    engine.display();
+    s_frame++;
+    return remote_display_flush();
+}
+
+static int run_sender(const char *device)
+{
+    uint32_t bytes = 0;
+    if ( ssd1306_platform_uartInit(device, s_baud) < 0 )
+    {
+        return 1;
+    }
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    scene_begin();
+    for (uint32_t i = 0; i < s_frames; i++)
+    {
+        bytes += scene_frame();
+        delay(33);
+    }
+    fprintf(stderr, "%u frames, %u bytes, %.1f bytes per frame (raw frame is %u bytes)\n",
+            s_frames, bytes, (double)bytes / s_frames, REMOTE_SIZE);
+    ssd1306_intf.close();
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          RECEIVER
+//////////////////////////////////////////////////////////////////////////////////
+
+static void null_start(void) {}
+static void null_send(uint8_t data) {}
+static void null_send_buffer(const uint8_t *buffer, uint16_t size) {}
+
+/* Reads data from fd until end of file, returns number of bytes read */
+static uint32_t receive(int fd, uint8_t *content)
+{
+    uint8_t data[256];
+    uint32_t total = 0;
+    remote_receiver_init(REMOTE_WIDTH, REMOTE_HEIGHT, content);
+    for (;;)
+    {
+        int len = read(fd, data, sizeof(data));
+        if ( len < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( len <= 0 )
+        {
+            /* Pseudo-terminal returns EIO, when sender closes its side */
+            break;
+        }
+        for (int i = 0; i < len; i++)
+        {
+            if ( s_errorRate && (uint32_t)(rand() % 1000) < s_errorRate )
+            {
+                data[i] ^= 1 << (rand() & 7);
+            }
+            remote_receiver_process(data[i]);
+        }
+        total += len;
+    }
+    return total;
+}
+
+static int run_receiver(const char *device)
+{
+    static uint8_t content[REMOTE_SIZE];
+    int fd = ssd1306_platform_uartInit(device, s_baud);
+    if ( fd < 0 )
+    {
+        return 1;
+    }
+    ssd1306_128x64_i2c_init();
+    ssd1306_clearScreen();
+    uint32_t bytes = receive(fd, content);
+    const remote_receiver_stats_t *stats = remote_receiver_getStats();
+    fprintf(stderr, "%u bytes, %u packets, %u damaged, %u lost, %u skipped\n", bytes,
+            stats->packets, stats->crcErrors, stats->lostPackets, stats->skipped);
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          SELF TEST
+//////////////////////////////////////////////////////////////////////////////////
+
+static int run_selftest(void)
+{
+    int result[2];
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ( master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 || pipe(result) < 0 )
+    {
+        fprintf(stderr, "Failed to create pseudo-terminal: %s\n", strerror(errno));
+        return 1;
+    }
+    int slave = ssd1306_platform_uartInit(ptsname(master), s_baud);
+    if ( slave < 0 )
+    {
+        return 1;
+    }
+    pid_t pid = fork();
+    if ( pid == 0 )
+    {
+        static receiver_result_t rx;
+        close(slave);
+        close(result[0]);
+        /* Receiver outputs content to ssd1306 driver, connected to nowhere */
+        ssd1306_intf.start = null_start;
+        ssd1306_intf.stop = null_start;
+        ssd1306_intf.send = null_send;
+        ssd1306_intf.send_buffer = null_send_buffer;
+        ssd1306_intf.close = null_start;
+        ssd1306_128x64_init();
+        rx.wireBytes = receive(master, rx.content);
+        rx.stats = *remote_receiver_getStats();
+        if ( write(result[1], &rx, sizeof(rx)) != sizeof(rx) )
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(master);
+    close(result[1]);
+
+    uint32_t bytes = 0;
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    scene_begin();
+    for (uint32_t i = 0; i < s_frames; i++)
+    {
+        bytes += scene_frame();
+    }
+    /* Final key frame allows receiver to recover from damaged packets. *
+     * When errors are injected, key packets can be damaged too, so     *
+     * several key frames are sent to make recovery almost certain.     */
+    remote_display_setKeyInterval(1);
+    uint32_t keyFrames = s_errorRate ? 8 : 1;
+    for (uint32_t i = 0; i < keyFrames; i++)
+    {
+        bytes += remote_display_flush();
+    }
+    ssd1306_intf.close();
+
+    static receiver_result_t rx;
+    int status;
+    uint32_t len = 0;
+    while ( len < sizeof(rx) )
+    {
+        int n = read(result[0], (uint8_t *)&rx + len, sizeof(rx) - len);
+        if ( n <= 0 ) break;
+        len += n;
+    }
+    waitpid(pid, &status, 0);
+    if ( len != sizeof(rx) )
+    {
+        fprintf(stderr, "Receiver failed\n");
+        return 1;
+    }
+    uint32_t raw = (s_frames + keyFrames) * REMOTE_SIZE;
+    printf("frames:          %u\n", s_frames + keyFrames);
+    printf("protocol bytes:  %u (%.1f per frame)\n", bytes, (double)bytes / (s_frames + keyFrames));
+    printf("wire bytes:      %u (with escaping)\n", rx.wireBytes);
+    printf("raw frame bytes: %u, reduction %.1fx\n", raw, rx.wireBytes ? (double)raw / rx.wireBytes : 0.0);
+    printf("receiver:        %u packets, %u damaged, %u lost, %u skipped\n",
+           rx.stats.packets, rx.stats.crcErrors, rx.stats.lostPackets, rx.stats.skipped);
+    int match = !memcmp(rx.content, s_buffer, REMOTE_SIZE);
+    printf("content:         %s\n", match ? "match" : "MISMATCH");
+    return match ? 0 : 2;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          MAIN
+//////////////////////////////////////////////////////////////////////////////////
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options] [-s device | -r device]\n", name);
+    fprintf(stderr, "    Without -s and -r runs self test over pseudo-terminal\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "        -s device     send animated scene to serial device\n");
+    fprintf(stderr, "        -r device     receive content from serial device and show it on display\n");
+    fprintf(stderr, "        -b baud       serial baud rate (default: 115200)\n");
+    fprintf(stderr, "        -n frames     number of frames to send (default: 200)\n");
+    fprintf(stderr, "        -k frames     key frame interval, 0 - first frame only (default: 64)\n");
+    fprintf(stderr, "        -e permille   self test: damage received bytes with given rate\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *sendDevice = NULL;
+    const char *receiveDevice = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if ( !value )
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        if ( !strcmp(argv[i], "-s") ) sendDevice = value;
+        else if ( !strcmp(argv[i], "-r") ) receiveDevice = value;
+        else if ( !strcmp(argv[i], "-b") ) s_baud = strtoul(value, NULL, 0);
+        else if ( !strcmp(argv[i], "-n") ) s_frames = strtoul(value, NULL, 0);
+        else if ( !strcmp(argv[i], "-k") ) s_keyInterval = strtol(value, NULL, 0);
+        else if ( !strcmp(argv[i], "-e") ) s_errorRate = strtoul(value, NULL, 0);
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if ( sendDevice )
+    {
+        return run_sender(sendDevice);
+    }
+    if ( receiveDevice )
+    {
+        return run_receiver(receiveDevice);
+    }
+    return run_selftest();
+}
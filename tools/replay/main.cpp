@@ -0,0 +1,782 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Replay tool for interface traces, recorded by ssd1306_recorderStart().
+ *
+ * The tool splits trace to frames, decodes display controller commands and
+ * reports bytes, transactions and updated regions for each frame. Trace can be
+ * replayed to the real bus or SDL emulator (when compiled with SDL_EMULATION),
+ * either at original speed or as fast as possible. Two traces can be compared
+ * to detect performance regressions.
+ */
+
+#include "ssd1306.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/spi/ssd1306_spi.h"
+#include "intf/recorder/ssd1306_recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_DEFAULT_GAP_MS    5
+#define REPLAY_DEFAULT_I2C_ADDR  0x3C
+#define REPLAY_DEFAULT_DC_PIN    5
+#define REPLAY_MAX_ARGS          16
+
+enum
+{
+    FORMAT_TEXT,
+    FORMAT_CSV,
+};
+
+enum
+{
+    FAMILY_SSD1306,
+    FAMILY_SSD1331,
+    FAMILY_SSD1351,
+    FAMILY_ILI9341,
+    FAMILY_PCD8544,
+};
+
+typedef struct
+{
+    const char *name;
+    const char *controllers;
+    uint8_t argsInData;
+    uint8_t writeCommand;
+} replay_family_t;
+
+static const replay_family_t s_families[] =
+{
+    { "ssd1306", "ssd1306, sh1106",          0, 0x00 },
+    { "ssd1331", "ssd1325, ssd1327, ssd1331", 0, 0x00 },
+    { "ssd1351", "ssd1351",                  1, 0x5C },
+    { "ili9341", "ili9341, il9163, st7735",  1, 0x2C },
+    { "pcd8544", "pcd8544",                  0, 0x00 },
+};
+
+typedef struct
+{
+    uint8_t type;
+    uint8_t dc;
+    uint32_t time;
+    const uint8_t *data;
+    uint32_t len;
+} trace_event_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t *raw;
+    uint8_t flags;
+    trace_event_t *events;
+    uint32_t count;
+} trace_t;
+
+typedef struct
+{
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+    uint8_t pageMode;
+    uint32_t bytes;
+} region_t;
+
+typedef struct
+{
+    uint32_t startTime;
+    uint32_t endTime;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t cmdBytes;
+    uint32_t pixelBytes;
+    uint32_t firstRegion;
+    uint32_t regionsCount;
+} frame_t;
+
+typedef struct
+{
+    frame_t *frames;
+    uint32_t framesCount;
+    region_t *regions;
+    uint32_t regionsCount;
+} report_t;
+
+typedef struct
+{
+    const replay_family_t *family;
+    uint8_t cmd;
+    uint8_t argc;
+    uint8_t argn;
+    uint8_t args[REPLAY_MAX_ARGS];
+    uint8_t extended;
+    region_t window;
+    uint8_t windowChanged;
+} decoder_t;
+
+static uint8_t s_format = FORMAT_TEXT;
+static uint8_t s_verbose = 0;
+static uint8_t s_family = FAMILY_SSD1306;
+static uint32_t s_gapUs = REPLAY_DEFAULT_GAP_MS * 1000UL;
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          TRACE LOADING
+//////////////////////////////////////////////////////////////////////////////////
+
+static int trace_readVarint(const uint8_t **p, const uint8_t *end, uint32_t *value)
+{
+    uint32_t result = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if ( *p >= end )
+        {
+            return -1;
+        }
+        uint8_t b = *(*p)++;
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if ( !(b & 0x80) )
+        {
+            *value = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int trace_load(trace_t *trace, const char *name)
+{
+    memset(trace, 0, sizeof(trace_t));
+    trace->name = name;
+    FILE *f = fopen(name, "rb");
+    if ( !f )
+    {
+        fprintf(stderr, "Cannot open %s\n", name);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    trace->raw = (uint8_t *)malloc(size > 0 ? size : 1);
+    if ( size < 8 || fread(trace->raw, size, 1, f) != 1 ||
+         memcmp(trace->raw, SSD1306_TRACE_SIGNATURE, 4) || trace->raw[4] != SSD1306_TRACE_VERSION )
+    {
+        fprintf(stderr, "%s is not a trace file or has unsupported version\n", name);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    trace->flags = trace->raw[5];
+    const uint8_t *p = trace->raw + 8;
+    const uint8_t *end = trace->raw + size;
+    uint32_t capacity = 0;
+    uint32_t time = 0;
+    uint8_t dc = 0;
+    while ( p < end )
+    {
+        trace_event_t ev;
+        uint32_t delta;
+        ev.type = *p++;
+        ev.data = NULL;
+        ev.len = 0;
+        if ( trace_readVarint(&p, end, &delta) < 0 )
+        {
+            break;
+        }
+        time += delta;
+        switch ( ev.type )
+        {
+            case SSD1306_TRACE_START:
+            case SSD1306_TRACE_STOP:
+            case SSD1306_TRACE_FRAME:
+                break;
+            case SSD1306_TRACE_DC:
+                if ( p >= end ) goto truncated;
+                dc = *p++;
+                break;
+            case SSD1306_TRACE_SEND:
+            case SSD1306_TRACE_BUFFER:
+                if ( trace_readVarint(&p, end, &ev.len) < 0 || ev.len > (uint32_t)(end - p) ) goto truncated;
+                ev.data = p;
+                p += ev.len;
+                break;
+            default:
+                fprintf(stderr, "%s: unknown record 0x%02X at offset %ld\n",
+                        name, ev.type, (long)(p - trace->raw - 1));
+                return -1;
+        }
+        ev.time = time;
+        ev.dc = dc;
+        if ( trace->count == capacity )
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            trace->events = (trace_event_t *)realloc(trace->events, capacity * sizeof(trace_event_t));
+        }
+        trace->events[trace->count++] = ev;
+    }
+    return 0;
+truncated:
+    /* Keep records before truncated one: trace may be cut by killed application */
+    fprintf(stderr, "%s: trace is truncated\n", name);
+    return 0;
+}
+
+static void trace_free(trace_t *trace)
+{
+    free(trace->events);
+    free(trace->raw);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          COMMAND DECODER
+//////////////////////////////////////////////////////////////////////////////////
+
+/* Returns number of arguments for the commands, which pass arguments in command mode */
+static uint8_t decoder_argsCount(uint8_t cmd)
+{
+    switch ( s_family )
+    {
+        case FAMILY_SSD1306:
+            switch ( cmd )
+            {
+                case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+                case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+                    return 1;
+                case 0x21: case 0x22: case 0xA3:
+                    return 2;
+                case 0x29: case 0x2A:
+                    return 5;
+                case 0x26: case 0x27:
+                    return 6;
+                default:
+                    return 0;
+            }
+        case FAMILY_SSD1331:
+            switch ( cmd )
+            {
+                case 0x26: case 0x81: case 0x82: case 0x83: case 0x87: case 0x8A:
+                case 0x8B: case 0x8C: case 0xA0: case 0xA1: case 0xA2: case 0xA8:
+                case 0xAB: case 0xAD: case 0xB0: case 0xB1: case 0xB2: case 0xB3:
+                case 0xB6: case 0xBB: case 0xBC: case 0xBE: case 0xD5: case 0xFD:
+                    return 1;
+                case 0x15: case 0x75:
+                    return 2;
+                case 0x24: case 0x25:
+                    return 4;
+                case 0x27:
+                    return 5;
+                case 0x23:
+                    return 6;
+                case 0x21:
+                    return 7;
+                case 0x22:
+                    return 10;
+                default:
+                    return 0;
+            }
+        case FAMILY_SSD1351:
+            return (cmd == 0x15 || cmd == 0x75) ? 2 : 0;
+        case FAMILY_ILI9341:
+            return (cmd == 0x2A || cmd == 0x2B) ? 4 : 0;
+        default:
+            return 0;
+    }
+}
+
+static void decoder_setColumns(decoder_t *d, int x1, int x2)
+{
+    d->window.x1 = x1;
+    d->window.x2 = x2;
+    d->window.pageMode = 0;
+    d->windowChanged = 1;
+}
+
+static void decoder_setRows(decoder_t *d, int y1, int y2)
+{
+    d->window.y1 = y1;
+    d->window.y2 = y2;
+    d->windowChanged = 1;
+}
+
+static void decoder_setPage(decoder_t *d, int x, int page)
+{
+    d->window.x1 = x;
+    d->window.y1 = page * 8;
+    d->window.y2 = page * 8 + 7;
+    d->window.pageMode = 1;
+    d->windowChanged = 1;
+}
+
+static void decoder_apply(decoder_t *d)
+{
+    uint8_t cmd = d->cmd;
+    const uint8_t *a = d->args;
+    switch ( s_family )
+    {
+        case FAMILY_SSD1306:
+            if ( cmd == 0x21 ) decoder_setColumns(d, a[0], a[1]);
+            else if ( cmd == 0x22 ) decoder_setRows(d, a[0] * 8, a[1] * 8 + 7);
+            else if ( cmd >= 0xB0 && cmd <= 0xB7 ) decoder_setPage(d, d->window.x1, cmd & 0x07);
+            else if ( cmd <= 0x0F ) decoder_setPage(d, (d->window.x1 & 0xF0) | (cmd & 0x0F), d->window.y1 / 8);
+            else if ( cmd <= 0x1F ) decoder_setPage(d, (d->window.x1 & 0x0F) | ((cmd & 0x0F) << 4), d->window.y1 / 8);
+            break;
+        case FAMILY_SSD1331:
+        case FAMILY_SSD1351:
+            if ( cmd == 0x15 ) decoder_setColumns(d, a[0], a[1]);
+            else if ( cmd == 0x75 ) decoder_setRows(d, a[0], a[1]);
+            break;
+        case FAMILY_ILI9341:
+            if ( cmd == 0x2A ) decoder_setColumns(d, (a[0] << 8) | a[1], (a[2] << 8) | a[3]);
+            else if ( cmd == 0x2B ) decoder_setRows(d, (a[0] << 8) | a[1], (a[2] << 8) | a[3]);
+            break;
+        case FAMILY_PCD8544:
+            /* H bit of function set command selects extended instruction set */
+            if ( (cmd & 0xF8) == 0x20 ) d->extended = cmd & 0x01;
+            else if ( d->extended ) break;
+            else if ( cmd & 0x80 ) decoder_setPage(d, cmd & 0x7F, d->window.y1 / 8);
+            else if ( (cmd & 0xF8) == 0x40 ) decoder_setPage(d, d->window.x1, cmd & 0x07);
+            break;
+        default:
+            break;
+    }
+}
+
+static void decoder_init(decoder_t *d)
+{
+    memset(d, 0, sizeof(decoder_t));
+    d->family = &s_families[s_family];
+    d->window.x2 = -1;
+    d->window.y2 = -1;
+}
+
+/* Returns non-zero if the byte is pixel data */
+static uint8_t decoder_byte(decoder_t *d, uint8_t data, uint8_t command)
+{
+    if ( command )
+    {
+        if ( !d->family->argsInData && d->argn < d->argc )
+        {
+            d->args[d->argn++] = data;
+            if ( d->argn == d->argc ) decoder_apply(d);
+            return 0;
+        }
+        d->cmd = data;
+        d->argn = 0;
+        d->argc = decoder_argsCount(data);
+        if ( !d->argc ) decoder_apply(d);
+        return 0;
+    }
+    if ( !d->family->argsInData )
+    {
+        return 1;
+    }
+    if ( d->cmd == d->family->writeCommand )
+    {
+        return 1;
+    }
+    if ( d->argn < d->argc )
+    {
+        d->args[d->argn++] = data;
+        if ( d->argn == d->argc ) decoder_apply(d);
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          FRAMES AND REPORTS
+//////////////////////////////////////////////////////////////////////////////////
+
+static frame_t *report_newFrame(report_t *r, uint32_t time)
+{
+    r->frames = (frame_t *)realloc(r->frames, (r->framesCount + 1) * sizeof(frame_t));
+    frame_t *frame = &r->frames[r->framesCount++];
+    memset(frame, 0, sizeof(frame_t));
+    frame->startTime = time;
+    frame->endTime = time;
+    frame->firstRegion = r->regionsCount;
+    return frame;
+}
+
+static void report_build(report_t *r, const trace_t *trace)
+{
+    decoder_t d;
+    uint8_t hasMarkers = 0;
+    uint8_t spi = trace->flags & SSD1306_TRACE_FLAG_SPI;
+    uint8_t i2cCommand = 1;
+    uint8_t i2cControl = 0;
+    uint32_t lastStop = 0;
+    frame_t *frame = NULL;
+
+    memset(r, 0, sizeof(report_t));
+    decoder_init(&d);
+    for (uint32_t i = 0; i < trace->count; i++)
+    {
+        if ( trace->events[i].type == SSD1306_TRACE_FRAME ) hasMarkers = 1;
+    }
+    for (uint32_t i = 0; i < trace->count; i++)
+    {
+        const trace_event_t *ev = &trace->events[i];
+        if ( ev->type == SSD1306_TRACE_FRAME )
+        {
+            if ( frame && frame->bytes ) frame = NULL;
+            continue;
+        }
+        if ( ev->type == SSD1306_TRACE_START && !hasMarkers && frame && frame->bytes &&
+             ev->time - lastStop >= s_gapUs )
+        {
+            frame = NULL;
+        }
+        if ( !frame )
+        {
+            frame = report_newFrame(r, ev->time);
+        }
+        frame->endTime = ev->time;
+        switch ( ev->type )
+        {
+            case SSD1306_TRACE_START:
+                frame->transactions++;
+                i2cControl = 1;
+                break;
+            case SSD1306_TRACE_STOP:
+                lastStop = ev->time;
+                break;
+            case SSD1306_TRACE_SEND:
+            case SSD1306_TRACE_BUFFER:
+                frame->bytes += ev->len;
+                for (uint32_t n = 0; n < ev->len; n++)
+                {
+                    uint8_t data = ev->data[n];
+                    if ( !spi && i2cControl )
+                    {
+                        /* The first byte of i2c transaction is control byte: 0x00 for commands */
+                        i2cControl = 0;
+                        i2cCommand = data == 0x00;
+                        continue;
+                    }
+                    if ( !decoder_byte(&d, data, spi ? !ev->dc : i2cCommand) )
+                    {
+                        frame->cmdBytes++;
+                        continue;
+                    }
+                    frame->pixelBytes++;
+                    if ( d.windowChanged || frame->regionsCount == 0 )
+                    {
+                        r->regions = (region_t *)realloc(r->regions, (r->regionsCount + 1) * sizeof(region_t));
+                        r->regions[r->regionsCount] = d.window;
+                        r->regions[r->regionsCount].bytes = 0;
+                        r->regionsCount++;
+                        frame->regionsCount++;
+                        d.windowChanged = 0;
+                    }
+                    r->regions[r->regionsCount - 1].bytes++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void report_free(report_t *r)
+{
+    free(r->frames);
+    free(r->regions);
+}
+
+static void region_bounds(const region_t *region, int *x2, int *y2)
+{
+    /* In page mode controller advances column with each byte */
+    *x2 = region->pageMode ? region->x1 + (int)region->bytes - 1 : region->x2;
+    *y2 = region->y2;
+}
+
+static void report_printFrames(const report_t *r, const trace_t *trace)
+{
+    if ( s_format == FORMAT_CSV )
+    {
+        printf("frame,start_us,duration_us,transactions,bytes,cmd_bytes,pixel_bytes,regions\n");
+    }
+    else
+    {
+        printf("%s: %s interface, %s commands\n", trace->name,
+               (trace->flags & SSD1306_TRACE_FLAG_SPI) ? "spi" : "i2c", s_families[s_family].name);
+        printf("%6s %12s %12s %6s %8s %8s %8s  %s\n", "frame", "start_us", "duration_us",
+               "trans", "bytes", "cmd", "pixels", "regions");
+    }
+    uint32_t base = r->framesCount ? r->frames[0].startTime : 0;
+    for (uint32_t i = 0; i < r->framesCount; i++)
+    {
+        const frame_t *f = &r->frames[i];
+        printf(s_format == FORMAT_CSV ? "%u,%u,%u,%u,%u,%u,%u," : "%6u %12u %12u %6u %8u %8u %8u  ",
+               i, f->startTime - base, f->endTime - f->startTime, f->transactions,
+               f->bytes, f->cmdBytes, f->pixelBytes);
+        printf(s_format == FORMAT_CSV ? "\"" : "%u", f->regionsCount);
+        for (uint32_t n = 0; n < f->regionsCount; n++)
+        {
+            const region_t *region = &r->regions[f->firstRegion + n];
+            int x2, y2;
+            if ( !s_verbose && s_format != FORMAT_CSV )
+            {
+                break;
+            }
+            region_bounds(region, &x2, &y2);
+            printf("%s%d,%d-%d,%d:%u", (n || s_format != FORMAT_CSV) ? " " : "",
+                   region->x1, region->y1, x2, y2, region->bytes);
+        }
+        printf(s_format == FORMAT_CSV ? "\"\n" : "\n");
+    }
+}
+
+typedef struct
+{
+    uint32_t frames;
+    double bytes;
+    double transactions;
+    double pixelBytes;
+    double regions;
+    uint32_t maxBytes;
+    uint32_t durationUs;
+} summary_t;
+
+static void report_summary(const report_t *r, const trace_t *trace, summary_t *s)
+{
+    memset(s, 0, sizeof(summary_t));
+    s->frames = r->framesCount;
+    for (uint32_t i = 0; i < r->framesCount; i++)
+    {
+        const frame_t *f = &r->frames[i];
+        s->bytes += f->bytes;
+        s->transactions += f->transactions;
+        s->pixelBytes += f->pixelBytes;
+        s->regions += f->regionsCount;
+        if ( f->bytes > s->maxBytes ) s->maxBytes = f->bytes;
+    }
+    if ( s->frames )
+    {
+        s->bytes /= s->frames;
+        s->transactions /= s->frames;
+        s->pixelBytes /= s->frames;
+        s->regions /= s->frames;
+    }
+    if ( trace->count )
+    {
+        s->durationUs = trace->events[trace->count - 1].time - trace->events[0].time;
+    }
+}
+
+static void report_printSummary(const char *name, const summary_t *s)
+{
+    printf("%s: %u frames in %.3f ms, per frame: %.1f bytes (max %u), %.1f transactions, "
+           "%.1f pixel bytes, %.1f regions\n",
+           name, s->frames, s->durationUs / 1000.0, s->bytes, s->maxBytes,
+           s->transactions, s->pixelBytes, s->regions);
+}
+
+static double report_delta(double a, double b)
+{
+    return a ? (b - a) * 100.0 / a : (b ? 100.0 : 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          PLAYBACK
+//////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t replay_play(const trace_t *trace, uint8_t realtime)
+{
+    uint32_t begin = micros();
+    uint32_t base = trace->count ? trace->events[0].time : 0;
+    for (uint32_t i = 0; i < trace->count; i++)
+    {
+        const trace_event_t *ev = &trace->events[i];
+        if ( realtime )
+        {
+            while ( (uint32_t)(micros() - begin) < ev->time - base )
+            {
+            }
+        }
+        switch ( ev->type )
+        {
+            case SSD1306_TRACE_START:
+                ssd1306_intf.start();
+                break;
+            case SSD1306_TRACE_STOP:
+                ssd1306_intf.stop();
+                break;
+            case SSD1306_TRACE_DC:
+                ssd1306_spiDataMode(ev->dc);
+                break;
+            case SSD1306_TRACE_SEND:
+                for (uint32_t n = 0; n < ev->len; n++)
+                {
+                    ssd1306_intf.send(ev->data[n]);
+                }
+                break;
+            case SSD1306_TRACE_BUFFER:
+                ssd1306_intf.send_buffer(ev->data, ev->len);
+                break;
+            default:
+                break;
+        }
+    }
+    return micros() - begin;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                          MAIN
+//////////////////////////////////////////////////////////////////////////////////
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options] trace [trace2]\n", name);
+    fprintf(stderr, "    Prints per-frame report for the trace, or compares trace2 against trace\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "        -c family     controller command set to decode (default: ssd1306):\n");
+    for (uint8_t i = 0; i < sizeof(s_families) / sizeof(s_families[0]); i++)
+    {
+        fprintf(stderr, "                      %s - %s\n", s_families[i].name, s_families[i].controllers);
+    }
+    fprintf(stderr, "        -f text|csv   report format (default: text)\n");
+    fprintf(stderr, "        -g ms         idle time, separating frames, if trace has no frame markers\n");
+    fprintf(stderr, "        -v            print decoded regions in text report\n");
+    fprintf(stderr, "        -x percent    exit with code 2 if trace2 sends more bytes per frame by given percent\n");
+    fprintf(stderr, "        -p            play the trace to the bus (or SDL emulator)\n");
+    fprintf(stderr, "        -r            play at original speed (default: as fast as possible)\n");
+    fprintf(stderr, "        -b bus        bus number for playback (default: platform default)\n");
+    fprintf(stderr, "        -a addr       i2c address or spi chip select for playback (default: 0x3C / -1)\n");
+    fprintf(stderr, "        -d pin        spi D/C pin for playback (default: %d)\n", REPLAY_DEFAULT_DC_PIN);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *files[2] = { NULL, NULL };
+    uint8_t filesCount = 0;
+    uint8_t play = 0;
+    uint8_t realtime = 0;
+    int bus = -1;
+    int addr = -1;
+    int dc = REPLAY_DEFAULT_DC_PIN;
+    double threshold = -1;
+    int result = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+        if ( !strcmp(argv[i], "-c") )
+        {
+            uint8_t n;
+            for (n = 0; n < sizeof(s_families) / sizeof(s_families[0]); n++)
+            {
+                if ( !strcmp(value, s_families[n].name) ) break;
+            }
+            if ( n == sizeof(s_families) / sizeof(s_families[0]) )
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            s_family = n;
+            i++;
+        }
+        else if ( !strcmp(argv[i], "-f") ) { s_format = !strcmp(value, "csv") ? FORMAT_CSV : FORMAT_TEXT; i++; }
+        else if ( !strcmp(argv[i], "-g") ) { s_gapUs = strtoul(value, NULL, 0) * 1000UL; i++; }
+        else if ( !strcmp(argv[i], "-x") ) { threshold = strtod(value, NULL); i++; }
+        else if ( !strcmp(argv[i], "-b") ) { bus = strtol(value, NULL, 0); i++; }
+        else if ( !strcmp(argv[i], "-a") ) { addr = strtol(value, NULL, 0); i++; }
+        else if ( !strcmp(argv[i], "-d") ) { dc = strtol(value, NULL, 0); i++; }
+        else if ( !strcmp(argv[i], "-v") ) s_verbose = 1;
+        else if ( !strcmp(argv[i], "-p") ) play = 1;
+        else if ( !strcmp(argv[i], "-r") ) realtime = 1;
+        else if ( argv[i][0] != '-' && filesCount < 2 ) files[filesCount++] = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ( !filesCount )
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    trace_t traces[2];
+    report_t reports[2];
+    summary_t summaries[2];
+    for (uint8_t i = 0; i < filesCount; i++)
+    {
+        if ( trace_load(&traces[i], files[i]) < 0 )
+        {
+            return 1;
+        }
+        report_build(&reports[i], &traces[i]);
+        report_summary(&reports[i], &traces[i], &summaries[i]);
+    }
+    if ( filesCount == 1 )
+    {
+        report_printFrames(&reports[0], &traces[0]);
+        if ( s_format == FORMAT_TEXT )
+        {
+            report_printSummary(files[0], &summaries[0]);
+        }
+    }
+    else
+    {
+        report_printSummary(files[0], &summaries[0]);
+        report_printSummary(files[1], &summaries[1]);
+        double delta = report_delta(summaries[0].bytes, summaries[1].bytes);
+        printf("delta per frame: bytes %+.1f%%, transactions %+.1f%%, pixel bytes %+.1f%%, regions %+.1f%%\n",
+               delta,
+               report_delta(summaries[0].transactions, summaries[1].transactions),
+               report_delta(summaries[0].pixelBytes, summaries[1].pixelBytes),
+               report_delta(summaries[0].regions, summaries[1].regions));
+        if ( threshold >= 0 && delta > threshold )
+        {
+            fprintf(stderr, "bytes per frame increased by %.1f%% (threshold %.1f%%)\n", delta, threshold);
+            result = 2;
+        }
+    }
+
+    if ( play )
+    {
+        if ( traces[0].flags & SSD1306_TRACE_FLAG_SPI )
+        {
+            ssd1306_platform_spiInit(bus, addr, dc);
+        }
+        else
+        {
+            ssd1306_platform_i2cInit(bus, addr < 0 ? REPLAY_DEFAULT_I2C_ADDR : addr, NULL);
+        }
+        uint32_t us = replay_play(&traces[0], realtime);
+        fprintf(stderr, "played %s in %.3f ms\n", files[0], us / 1000.0);
+        if ( ssd1306_intf.close ) ssd1306_intf.close();
+    }
+
+    for (uint8_t i = 0; i < filesCount; i++)
+    {
+        report_free(&reports[i]);
+        trace_free(&traces[i]);
+    }
+    return result;
+}
@@ -24,6 +24,7 @@
 
 #include "sdl_core.h"
 #include "sdl_graphics.h"
+#include "sdl_timing.h"
 #include "sdl_oled_basic.h"
 #include "sdl_ssd1306.h"
 #include "sdl_ssd1325.h"
@@ -97,6 +98,7 @@ void sdl_core_init(void)
     register_oled( &sdl_ili9341 );
     register_oled( &sdl_pcd8544 );
     sdl_graphics_init();
+    sdl_timing_init();
 }
 
 static void sdl_poll_event(void)
@@ -149,6 +151,10 @@ int sdl_read_analog(int pin)
 
 void sdl_write_digital(int pin, int value)
 {
+    if ( pin == s_dcPin && s_digitalPins[pin] != value )
+    {
+        sdl_timing_dc();
+    }
     s_digitalPins[pin] = value;
 }
 
@@ -159,6 +165,7 @@ int sdl_read_digital(int pin)
 
 void sdl_core_close(void)
 {
+    sdl_timing_close();
     sdl_graphics_close();
     SDL_Quit();
     unregister_oleds();
@@ -172,6 +179,7 @@ void sdl_send_init()
     s_active_data_mode = SDM_COMMAND_ARG;
     s_ssdMode = SSD_MODE_NONE;
 //    s_commandId = SSD_COMMAND_NONE;
+    sdl_timing_start(s_dcPin >= 0);
 }
 
 
@@ -211,8 +219,10 @@ void sdl_send_byte(uint8_t data)
     {
         // for i2c
         s_ssdMode = data == 0x00 ? SSD_MODE_COMMAND : SSD_MODE_DATA;
+        sdl_timing_control_byte();
         return;
     }
+    sdl_timing_byte();
     if (s_ssdMode == SSD_MODE_COMMAND)
     {
         if (s_oled == SDL_AUTODETECT)
@@ -265,6 +275,7 @@ void sdl_send_byte(uint8_t data)
 
 void sdl_send_stop()
 {
+    sdl_timing_stop();
     sdl_poll_event();
     sdl_graphics_refresh();
     s_ssdMode = -1;
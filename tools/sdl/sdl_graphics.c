@@ -264,6 +264,14 @@ uint32_t sdl_get_pixel(int x, int y)
     return pixel;
 }
 
+void sdl_graphics_set_title(const char *title)
+{
+    if ( g_window )
+    {
+        SDL_SetWindowTitle(g_window, title);
+    }
+}
+
 void sdl_graphics_close(void)
 {
     if ( s_unittest_mode )
@@ -34,6 +34,7 @@ extern "C" {
 extern void sdl_graphics_init(void);
 extern void sdl_graphics_refresh(void);
 extern void sdl_graphics_close(void);
+extern void sdl_graphics_set_title(const char *title);
 
 extern void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfmt);
 extern void sdl_put_pixel(int x, int y, uint32_t color);
@@ -0,0 +1,235 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sdl_timing.h"
+#include "sdl_graphics.h"
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Idle time on the bus, which separates frames */
+#define FRAME_GAP_NS       2000000.0
+/* How often predicted values are updated in window title */
+#define REPORT_PERIOD_NS   500000000.0
+
+static char s_bus[32];
+static sdl_bus_costs s_costs;
+static int s_selected = 0;
+static int s_throttle = 0;
+static const char *s_costsOverride = NULL;
+
+static double s_busyUntil;      // wall time, when predicted bus becomes free
+static double s_lastStop;
+static double s_frameNs;        // predicted bus time of current frame
+static double s_reportStart;
+static double s_reportBusNs;
+static double s_reportFramesNs;
+static uint32_t s_reportFrames;
+static double s_totalStart;
+static double s_totalBusNs;
+static double s_totalFramesNs;
+static double s_maxFrameNs;
+static uint32_t s_totalFrames;
+
+static double now_ns(void)
+{
+    return (double)SDL_GetPerformanceCounter() * 1000000000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+void sdl_timing_set_bus(const char *bus)
+{
+    char *end;
+    int spi = !strncmp(bus, "spi", 3);
+    double freq;
+    if ( !spi && strncmp(bus, "i2c", 3) )
+    {
+        fprintf(stderr, "Unknown bus %s, use i2c<freq> or spi<freq>\n", bus);
+        return;
+    }
+    freq = strtod(bus + 3, &end);
+    if ( *end == 'k' || *end == 'K' ) freq *= 1000.0;
+    if ( *end == 'm' || *end == 'M' ) freq *= 1000000.0;
+    if ( freq <= 0 )
+    {
+        freq = spi ? 8000000.0 : 400000.0;
+    }
+    double bit_ns = 1000000000.0 / freq;
+    if ( spi )
+    {
+        s_costs.byte_ns = 8 * bit_ns;
+        s_costs.transaction_ns = 2 * bit_ns;
+        s_costs.dc_ns = 0;
+        s_costs.control_ns = 0;
+    }
+    else
+    {
+        /* Each i2c byte is followed by ACK bit. Transaction includes start, address and stop */
+        s_costs.byte_ns = 9 * bit_ns;
+        s_costs.transaction_ns = 11 * bit_ns;
+        s_costs.dc_ns = 0;
+        s_costs.control_ns = 9 * bit_ns;
+    }
+    strncpy(s_bus, bus, sizeof(s_bus) - 1);
+    s_selected = 1;
+    if ( s_costsOverride )
+    {
+        sdl_bus_costs costs = s_costs;
+        sscanf(s_costsOverride, "%u,%u,%u,%u", &costs.byte_ns, &costs.transaction_ns,
+               &costs.dc_ns, &costs.control_ns);
+        s_costs = costs;
+    }
+}
+
+void sdl_timing_set_costs(const sdl_bus_costs *costs)
+{
+    s_costs = *costs;
+    s_selected = 1;
+}
+
+void sdl_timing_set_throttle(int enable)
+{
+    s_throttle = enable;
+}
+
+void sdl_timing_init(void)
+{
+    const char *env;
+    s_selected = 0;
+    s_bus[0] = '\0';
+    s_costsOverride = getenv("SSD1306_SDL_BUS_COSTS");
+    env = getenv("SSD1306_SDL_THROTTLE");
+    s_throttle = env && atoi(env);
+    s_totalStart = s_reportStart = s_busyUntil = s_lastStop = now_ns();
+    s_frameNs = s_maxFrameNs = 0;
+    s_reportBusNs = s_reportFramesNs = s_totalBusNs = s_totalFramesNs = 0;
+    s_reportFrames = s_totalFrames = 0;
+    env = getenv("SSD1306_SDL_BUS");
+    if ( env )
+    {
+        sdl_timing_set_bus(env);
+    }
+}
+
+static void charge(double ns)
+{
+    s_busyUntil += ns;
+    s_frameNs += ns;
+    s_reportBusNs += ns;
+    s_totalBusNs += ns;
+}
+
+static void end_frame(void)
+{
+    if ( s_frameNs > 0 )
+    {
+        s_reportFrames++;
+        s_reportFramesNs += s_frameNs;
+        s_totalFrames++;
+        s_totalFramesNs += s_frameNs;
+        if ( s_frameNs > s_maxFrameNs ) s_maxFrameNs = s_frameNs;
+        s_frameNs = 0;
+    }
+}
+
+static void report(double now)
+{
+    char title[128];
+    double frameMs = s_reportFrames ? s_reportFramesNs / s_reportFrames / 1000000.0 : s_frameNs / 1000000.0;
+    snprintf(title, sizeof(title), "%s: frame %.1f ms (%.0f fps max), bus %.0f%%%s",
+             s_bus, frameMs, frameMs > 0 ? 1000.0 / frameMs : 0.0,
+             s_reportBusNs * 100.0 / (now - s_reportStart), s_throttle ? ", throttled" : "");
+    sdl_graphics_set_title(title);
+    s_reportStart = now;
+    s_reportBusNs = 0;
+    s_reportFramesNs = 0;
+    s_reportFrames = 0;
+}
+
+void sdl_timing_start(int spi)
+{
+    double now = now_ns();
+    if ( !s_selected )
+    {
+        sdl_timing_set_bus(spi ? "spi8m" : "i2c400k");
+    }
+    if ( now - s_lastStop > FRAME_GAP_NS )
+    {
+        end_frame();
+    }
+    if ( s_busyUntil < now )
+    {
+        s_busyUntil = now;
+    }
+    charge(s_costs.transaction_ns);
+}
+
+void sdl_timing_byte(void)
+{
+    charge(s_costs.byte_ns);
+}
+
+void sdl_timing_control_byte(void)
+{
+    charge(s_costs.control_ns);
+}
+
+void sdl_timing_dc(void)
+{
+    charge(s_costs.dc_ns);
+}
+
+void sdl_timing_stop(void)
+{
+    double now = now_ns();
+    if ( s_throttle && s_busyUntil > now )
+    {
+        double wait = s_busyUntil - now;
+        if ( wait > 1000000.0 )
+        {
+            SDL_Delay((Uint32)(wait / 1000000.0));
+        }
+        while ( now_ns() < s_busyUntil )
+        {
+        }
+        now = now_ns();
+    }
+    s_lastStop = now;
+    if ( now - s_reportStart >= REPORT_PERIOD_NS )
+    {
+        report(now);
+    }
+}
+
+void sdl_timing_close(void)
+{
+    double now = now_ns();
+    end_frame();
+    if ( s_totalFrames )
+    {
+        fprintf(stderr, "%s: %u frames, predicted frame time %.2f ms (max %.2f ms), bus utilization %.0f%%\n",
+                s_bus, s_totalFrames, s_totalFramesNs / s_totalFrames / 1000000.0, s_maxFrameNs / 1000000.0,
+                s_totalBusNs * 100.0 / (now - s_totalStart));
+    }
+}
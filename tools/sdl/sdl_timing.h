@@ -0,0 +1,65 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef _SDL_TIMING_H_
+#define _SDL_TIMING_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Bus costs in nanoseconds, charged by emulator timing model.
+ * Bus is selected via SSD1306_SDL_BUS environment variable: i2c100k, i2c400k,
+ * i2c1m or any i2c<freq>/spi<freq> (for example, spi8m, spi500k).
+ * Default is i2c400k for i2c interface and spi8m for spi interface.
+ * Costs can be overridden via SSD1306_SDL_BUS_COSTS="byte,transaction,dc,control".
+ * If SSD1306_SDL_THROTTLE=1, emulator slows down application to predicted bus speed.
+ */
+typedef struct
+{
+    uint32_t byte_ns;        // cost of single byte on the bus
+    uint32_t transaction_ns; // start/stop conditions, i2c address byte, spi chip select
+    uint32_t dc_ns;          // cost of D/C pin toggle
+    uint32_t control_ns;     // cost of i2c control byte (0x00 or 0x40)
+} sdl_bus_costs;
+
+extern void sdl_timing_init(void);
+extern void sdl_timing_set_bus(const char *bus);
+extern void sdl_timing_set_costs(const sdl_bus_costs *costs);
+extern void sdl_timing_set_throttle(int enable);
+extern void sdl_timing_start(int spi);
+extern void sdl_timing_byte(void);
+extern void sdl_timing_control_byte(void);
+extern void sdl_timing_dc(void);
+extern void sdl_timing_stop(void);
+extern void sdl_timing_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif